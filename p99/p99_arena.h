@@ -0,0 +1,353 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_ARENA_H
+#define P99_ARENA_H 1
+
+#include "p99_try.h"
+
+/**
+ ** @addtogroup arena Arena allocation
+ **
+ ** A ::p99_arena serves many short lived allocations from a few
+ ** large chunks of memory, by just bumping a pointer. There is no
+ ** function to free an individual object, instead all objects that
+ ** have been allocated since some point are released at once.
+ **
+ ** The usual way to do this is ::P99_ARENA_SCOPE:
+ **
+ ** @code
+ ** p99_arena arena = P99_ARENA_INITIALIZER;
+ ** .
+ ** for (;;) {
+ **   request* req = get_request();
+ **   P99_ARENA_SCOPE(&arena) {
+ **     // allocations in this block and in all functions that are
+ **     // called from here
+ **     node* n = P99_ARENA_NEW(node, req);
+ **     char* buf = P99_ARENA_CALLOC(char, req->len);
+ **     handle(req, n, buf);
+ **   }
+ **   // all of it is gone, the chunks are kept for the next request
+ ** }
+ ** p99_arena_destroy(&arena);
+ ** @endcode
+ **
+ ** Leaving the scope just rewinds the arena to the position that it
+ ** had at the start of the scope, which is independent of the number
+ ** of objects that have been allocated. The chunks that were added
+ ** inside the scope are kept for reuse until the arena is destroyed.
+ ** @{
+ **/
+
+/**
+ ** @brief The default size of the chunks of a ::p99_arena.
+ **/
+#ifndef P99_ARENA_CHUNK
+# define P99_ARENA_CHUNK (64u*1024u)
+#endif
+
+P99_DECLARE_STRUCT(p00_arena_chunk);
+
+struct p00_arena_chunk {
+  p00_arena_chunk* p00_next;
+  unsigned char* p00_end;
+  max_align_t p00_data[];
+};
+
+P99_DECLARE_STRUCT(p99_arena);
+
+/**
+ ** @brief A bump pointer allocator with chunk chaining.
+ **
+ ** The chunks form a list in the order in which they were first
+ ** used. Allocation takes from the current chunk and then moves to
+ ** the next one in the list, or adds a new chunk after the current
+ ** one if the next is too small. So after a rewind the chunks are
+ ** reused in the same order.
+ **
+ ** @see P99_ARENA_SCOPE
+ ** @see p99_arena_alloc
+ **/
+struct p99_arena {
+  p00_arena_chunk* p00_first;
+  p00_arena_chunk* p00_chunk;
+  unsigned char* p00_cur;
+  unsigned char* p00_end;
+  size_t p00_size;
+};
+
+/**
+ ** @brief Initialize a ::p99_arena with the default chunk size.
+ **/
+#define P99_ARENA_INITIALIZER { .p00_size = P99_ARENA_CHUNK, }
+
+/**
+ ** @brief Initialize a ::p99_arena with chunks of at least @a
+ ** p00_size bytes.
+ **
+ ** @remark @a p00_size defaults to ::P99_ARENA_CHUNK.
+ ** @related p99_arena
+ **/
+P99_DEFARG_DOCU(p99_arena_init)
+p99_inline
+p99_arena* p99_arena_init(p99_arena* p00_a, size_t p00_size) {
+  if (p00_a) *p00_a = (p99_arena) { .p00_size = p00_size ? p00_size : P99_ARENA_CHUNK, };
+  return p00_a;
+}
+
+#ifndef DOXYGEN
+#define p99_arena_init(...) P99_CALL_DEFARG(p99_arena_init, 2, __VA_ARGS__)
+#define p99_arena_init_defarg_1() P99_ARENA_CHUNK
+#endif
+
+/**
+ ** @brief Release all objects of @a p00_a and give its chunks back to
+ ** the system.
+ ** @related p99_arena
+ **/
+p99_inline
+void p99_arena_destroy(p99_arena* p00_a) {
+  if (p00_a) {
+    for (p00_arena_chunk* p00_c = p00_a->p00_first; p00_c;) {
+      p00_arena_chunk* p00_n = p00_c->p00_next;
+      free(p00_c);
+      p00_c = p00_n;
+    }
+    p99_arena_init(p00_a, p00_a->p00_size);
+  }
+}
+
+/**
+ ** @brief Release all objects of @a p00_a but keep its chunks for
+ ** reuse.
+ ** @related p99_arena
+ **/
+p99_inline
+void p99_arena_reset(p99_arena* p00_a) {
+  p00_a->p00_chunk = 0;
+  p00_a->p00_cur = 0;
+  p00_a->p00_end = 0;
+}
+
+p99_inline
+unsigned char* p00_arena_align(unsigned char* p00_p, size_t p00_align) {
+  return p00_p + (-(uintptr_t)p00_p & (p00_align - 1));
+}
+
+/* The current chunk is exhausted. Move to the next chunk or add a
+   new one. */
+p99_inline
+void* p00_arena_grow(p99_arena* p00_a, size_t p00_size, size_t p00_align) {
+  p00_arena_chunk* p00_prev = p00_a->p00_chunk;
+  p00_arena_chunk* p00_c = p00_prev ? p00_prev->p00_next : p00_a->p00_first;
+  unsigned char* p00_p = p00_c ? p00_arena_align((unsigned char*)p00_c->p00_data, p00_align) : 0;
+  if (!p00_c || p00_size > (size_t)(p00_c->p00_end - p00_p)) {
+    size_t p00_len = p00_size + p00_align;
+    if (p00_len < p00_size || p00_len > SIZE_MAX - sizeof *p00_c) return 0;
+    if (p00_len < p00_a->p00_size) p00_len = p00_a->p00_size;
+    p00_c = malloc(sizeof *p00_c + p00_len);
+    if (!p00_c) return 0;
+    p00_c->p00_end = (unsigned char*)p00_c->p00_data + p00_len;
+    if (p00_prev) {
+      p00_c->p00_next = p00_prev->p00_next;
+      p00_prev->p00_next = p00_c;
+    } else {
+      p00_c->p00_next = p00_a->p00_first;
+      p00_a->p00_first = p00_c;
+    }
+    p00_p = p00_arena_align((unsigned char*)p00_c->p00_data, p00_align);
+  }
+  p00_a->p00_chunk = p00_c;
+  p00_a->p00_cur = p00_p + p00_size;
+  p00_a->p00_end = p00_c->p00_end;
+  return p00_p;
+}
+
+/**
+ ** @brief Allocate @a p00_size bytes with alignment @a p00_align from
+ ** arena @a p00_a.
+ **
+ ** @a p00_align must be a power of two and defaults to the alignment
+ ** of @c max_align_t.
+ **
+ ** @return a pointer to the new object, or a null pointer if @a p00_a
+ ** is null or if no memory could be obtained.
+ ** @related p99_arena
+ **/
+P99_DEFARG_DOCU(p99_arena_alloc)
+p99_inline
+void* p99_arena_alloc(p99_arena* p00_a, size_t p00_size, size_t p00_align) {
+  if (P99_UNLIKELY(!p00_a)) return 0;
+  if (P99_LIKELY(p00_a->p00_cur)) {
+    unsigned char* p00_p = p00_arena_align(p00_a->p00_cur, p00_align);
+    if (P99_LIKELY(p00_p <= p00_a->p00_end && p00_size <= (size_t)(p00_a->p00_end - p00_p))) {
+      p00_a->p00_cur = p00_p + p00_size;
+      return p00_p;
+    }
+  }
+  return p00_arena_grow(p00_a, p00_size, p00_align);
+}
+
+#ifndef DOXYGEN
+#define p99_arena_alloc(...) P99_CALL_DEFARG(p99_arena_alloc, 3, __VA_ARGS__)
+#define p99_arena_alloc_defarg_2() alignof(max_align_t)
+#endif
+
+P99_DECLARE_THREAD_LOCAL(p99_arena*, p00_arena_current);
+
+/**
+ ** @brief The arena of the innermost ::P99_ARENA_SCOPE of the calling
+ ** thread, or a null pointer if there is none.
+ ** @related p99_arena
+ **/
+p99_inline
+p99_arena* p99_arena_current(void) {
+  return P99_THREAD_LOCAL(p00_arena_current);
+}
+
+/**
+ ** @brief Allocate an object of type @a T from the current arena.
+ **
+ ** As for ::P99_MALLOC, the object is not initialized and the result
+ ** is a @c void*, so @a T may also be an array type.
+ ** @see P99_ARENA_SCOPE
+ **/
+#define P99_ARENA_MALLOC(T) p99_arena_alloc(p99_arena_current(), sizeof(T), alignof(T))
+
+/**
+ ** @brief Allocate a zero-initialized array of @a N objects of type @a
+ ** T from the current arena.
+ ** @see P99_ARENA_SCOPE
+ **/
+#define P99_ARENA_CALLOC(T, N) p00_arena_calloc(p99_arena_current(), sizeof(T), (N), alignof(T))
+
+p99_inline
+void* p00_arena_calloc(p99_arena* p00_a, size_t p00_size, size_t p00_nb, size_t p00_align) {
+  if (p00_size && p00_nb > SIZE_MAX/p00_size) return 0;
+  void* p00_ret = p99_arena_alloc(p00_a, p00_size*p00_nb, p00_align);
+  if (p00_ret) memset(p00_ret, 0, p00_size*p00_nb);
+  return p00_ret;
+}
+
+/**
+ ** @brief Allocate an object of type @a T from the current arena and
+ ** initialize it with @c T_init, analogous to ::P99_NEW.
+ **
+ ** Objects that are allocated this way must not be deleted or freed.
+ ** @see P99_ARENA_SCOPE
+ **/
+#define P99_ARENA_NEW(...) P99_IF_LT(P99_NARG(__VA_ARGS__), 2)(P00_ARENA_NEW(__VA_ARGS__))(P00_ARENA_NEW_ARGS(__VA_ARGS__))
+
+#define P00_ARENA_NEW(T) P99_PASTE2(T, _init)(P99_ARENA_MALLOC(T))
+
+#define P00_ARENA_NEW_ARGS(T, ...) P99_PASTE2(T, _init)(P99_ARENA_MALLOC(T), __VA_ARGS__)
+
+P99_DECLARE_STRUCT(p00_arena_frame);
+
+/* The state that a scope restores when it is left. */
+struct p00_arena_frame {
+  p99_arena* p00_arena;
+  p99_arena* p00_prev;
+  p00_arena_chunk* p00_chunk;
+  unsigned char* p00_cur;
+  unsigned char* p00_end;
+};
+
+p99_inline
+p00_arena_frame* p00_arena_enter(p00_arena_frame* p00_f, p99_arena* p00_a) {
+  p99_arena** p00_top = &P99_THREAD_LOCAL(p00_arena_current);
+  *p00_f = (p00_arena_frame) {
+    .p00_arena = p00_a,
+    .p00_prev = *p00_top,
+    .p00_chunk = p00_a->p00_chunk,
+    .p00_cur = p00_a->p00_cur,
+    .p00_end = p00_a->p00_end,
+  };
+  *p00_top = p00_a;
+  return p00_f;
+}
+
+p99_inline
+void p00_arena_leave(p00_arena_frame const* p00_f) {
+  p99_arena* p00_a = p00_f->p00_arena;
+  p00_a->p00_chunk = p00_f->p00_chunk;
+  p00_a->p00_cur = p00_f->p00_cur;
+  p00_a->p00_end = p00_f->p00_end;
+  P99_THREAD_LOCAL(p00_arena_current) = p00_f->p00_prev;
+}
+
+#ifdef P00_DOXYGEN
+/**
+ ** @brief Make @a ARENA the current arena of the calling thread for
+ ** the dependent block or statement and release all objects that are
+ ** allocated from it within when the block is left.
+ **
+ ** Scopes may be nested, also with the same arena. Allocations with
+ ** ::P99_ARENA_MALLOC, ::P99_ARENA_CALLOC and ::P99_ARENA_NEW, also
+ ** in functions that are called from the block, take memory from the
+ ** arena of the innermost scope.
+ **
+ ** The arena is also released if the block is left by ::P99_UNWIND,
+ ** ::P99_UNWIND_RETURN or by an exception, that is by ::P99_THROW here or in any function
+ ** that is called. For the latter the scope acts like a ::P99_TRY
+ ** with a ::P99_FINALLY clause that releases the arena and then
+ ** rethrows the exception.
+ **
+ ** @warning As for ::P99_GUARDED_BLOCK, don't leave the block with @c
+ ** return. Use ::P99_UNWIND_RETURN instead.
+ **
+ ** @see P99_GUARDED_BLOCK
+ ** @see p99_arena
+ **/
+P00_UNWIND_DOCUMENT
+#define P99_ARENA_SCOPE(ARENA)
+#else
+#define P99_ARENA_SCOPE(ARENA) P00_ARENA_SCOPE((ARENA), P99_UNIQ(arena))
+# if !P99_SIMPLE_BLOCKS
+/* Register with the exceptions such that a throw in a called function
+   comes here, and rethrow if we got here by an exception. If we got
+   here by P99_UNWIND or P99_UNWIND_RETURN the enclosing
+   P99_UNWIND_PROTECT of P99_GUARDED_BLOCK continues the unwind. */
+#  define P00_ARENA_SCOPE(ARENA, UNIQ)                                  \
+P99_GUARDED_BLOCK(p00_arena_frame*const,                                \
+                  UNIQ,                                                 \
+                  p00_arena_enter(&(p00_arena_frame){ 0 }, ARENA),      \
+                  p00_jmp_push(p00_unwind_top),                         \
+                  (p00_jmp_skip(p00_unwind_top),                        \
+                   p00_arena_leave(UNIQ),                               \
+                   ((p00_unw && p00_unwind_top[0].p00_thrown)           \
+                    ? p00_jmp_throw(p00_code, p00_unwind_prev, 0, 0, 0) \
+                    : P99_NOP)))
+# else
+#  define P00_ARENA_SCOPE(ARENA, UNIQ)                             \
+P99_GUARDED_BLOCK(p00_arena_frame*const,                           \
+                  UNIQ,                                            \
+                  p00_arena_enter(&(p00_arena_frame){ 0 }, ARENA), \
+                  P99_NOP,                                         \
+                  p00_arena_leave(UNIQ))
+# endif
+#endif
+
+/**
+ ** @}
+ **/
+
+#endif
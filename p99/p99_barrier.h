@@ -0,0 +1,289 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_BARRIER_H
+#define P99_BARRIER_H
+
+#include "p99_futex.h"
+
+/**
+ ** @addtogroup futex
+ ** @{
+ **/
+
+/**
+ ** @brief The value that ::p99_barrier_wait returns to exactly one
+ ** of the threads of each phase.
+ **
+ ** This is analogous to @c PTHREAD_BARRIER_SERIAL_THREAD. All other
+ ** threads of the same phase receive @c 0.
+ **/
+#define P99_BARRIER_SERIAL_THREAD (-1)
+
+/**
+ ** @brief The number of participants up to which ::p99_barrier_init
+ ** chooses a flat barrier when no fan-in is given explicitly.
+ **/
+#ifndef P99_BARRIER_FLAT_MAX
+# define P99_BARRIER_FLAT_MAX 8u
+#endif
+
+/**
+ ** @brief The fan-in of the combining tree that ::p99_barrier_init
+ ** chooses when no fan-in is given explicitly.
+ **/
+#ifndef P99_BARRIER_RADIX
+# define P99_BARRIER_RADIX 4u
+#endif
+
+P99_DECLARE_STRUCT(p00_barrier_node);
+
+struct p00_barrier_node {
+  _Atomic(unsigned) p00_count;
+  unsigned p00_n;
+  unsigned p00_parent;
+};
+
+P99_DECLARE_STRUCT(p99_barrier);
+
+/**
+ ** @brief A reusable barrier for a fixed number of threads.
+ **
+ ** A ::p99_barrier is used for phase parallel code, where a group of
+ ** @c n threads repeatedly has to wait until all of them have
+ ** finished the current phase:
+ **
+ ** @code
+ ** p99_barrier bar;
+ ** p99_barrier_init(&bar, n);
+ ** .
+ ** .
+ ** int my_thread_function(void* arg) {
+ **   unsigned id = ...; // a distinct number in [0, n)
+ **   for (size_t step = 0; step < steps; ++step) {
+ **     compute_my_part(step, id);
+ **     if (p99_barrier_wait(&bar, id) == P99_BARRIER_SERIAL_THREAD)
+ **       collect_results(step);
+ **     // the collected results are only visible after a second wait
+ **     p99_barrier_wait(&bar, id);
+ **   }
+ **   ...
+ ** }
+ ** @endcode
+ **
+ ** The implementation uses sense reversal: the release of the waiting
+ ** threads is signaled by flipping the sense that is held in a
+ ** ::p99_futex. Each thread captures that sense before it arrives at
+ ** the barrier and blocks until the sense has changed. Since the
+ ** sense can not change before all threads have arrived, the barrier
+ ** can be reused immediately for the next phase.
+ **
+ ** For a large number of threads the arrivals can be organized in a
+ ** combining tree, such that not all threads have to update the same
+ ** counter. Only the last thread that arrives at a node of the tree
+ ** continues to the parent node, and the last thread that arrives at
+ ** the root flips the sense. This mode is chosen by
+ ** ::p99_barrier_init if the number of threads is large or if a
+ ** fan-in is given explicitly.
+ **
+ ** @see p99_barrier_init
+ ** @see p99_barrier_wait
+ ** @see p99_notifier for a one-shot start of a herd of threads
+ **/
+struct p99_barrier {
+  p99_futex p00_sense;
+  _Atomic(unsigned) p00_count;
+  _Atomic(size_t) p00_ticket;
+  unsigned p00_n;
+  unsigned p00_radix;
+  p00_barrier_node* p00_tree;
+};
+
+/* Arrive at a counter that expects p00_n arrivals. Returns true for
+   the last arrival, which also resets the counter for the next
+   phase. This is safe, since nobody else can arrive at this counter
+   before the sense of the barrier has been flipped. */
+p99_inline
+bool p00_barrier_arrive(_Atomic(unsigned) volatile* p00_c, unsigned p00_n) {
+  if (atomic_fetch_add_explicit(p00_c, 1u, memory_order_acq_rel) + 1u < p00_n)
+    return false;
+  atomic_store_explicit(p00_c, 0u, memory_order_relaxed);
+  return true;
+}
+
+/**
+ ** @brief Initialize a barrier for @a p00_n threads.
+ **
+ ** @param p00_radix is the fan-in of the combining tree. If it is
+ ** @c 0 (the default) a flat barrier is used for up to
+ ** ::P99_BARRIER_FLAT_MAX threads and a tree with fan-in
+ ** ::P99_BARRIER_RADIX otherwise. If @a p00_radix is at least @a
+ ** p00_n, the barrier is flat.
+ **
+ ** @return @a p00_bar if the initialization was successful, @c 0 if
+ ** @a p00_n is @c 0 or the tree could not be allocated.
+ ** @related p99_barrier
+ **/
+P99_DEFARG_DOCU(p99_barrier_init)
+p99_inline
+p99_barrier* p99_barrier_init(p99_barrier* p00_bar, unsigned p00_n, unsigned p00_radix) {
+  if (!p00_bar || !p00_n) return 0;
+  if (!p00_radix)
+    p00_radix = (p00_n <= P99_BARRIER_FLAT_MAX) ? p00_n : P99_BARRIER_RADIX;
+  if (p00_radix < 2u) p00_radix = 2u;
+  *p00_bar = (p99_barrier) {
+    .p00_n = p00_n,
+    .p00_radix = p00_radix,
+  };
+  p99_futex_init(&p00_bar->p00_sense, 0u);
+  atomic_init(&p00_bar->p00_count, 0u);
+  atomic_init(&p00_bar->p00_ticket, 0u);
+  if (p00_radix < p00_n) {
+    /* Count the nodes of all levels, the leaves first. */
+    size_t p00_nodes = 0;
+    for (size_t p00_w = p00_n; p00_w > 1; p00_w = (p00_w + p00_radix - 1)/p00_radix)
+      p00_nodes += (p00_w + p00_radix - 1)/p00_radix;
+    p00_barrier_node* p00_t = malloc(sizeof(p00_barrier_node[p00_nodes]));
+    if (!p00_t) {
+      p99_futex_destroy(&p00_bar->p00_sense);
+      return 0;
+    }
+    /* Each level is stored contiguously after the previous one. */
+    size_t p00_base = 0;
+    for (size_t p00_w = p00_n; p00_w > 1;) {
+      size_t p00_up = (p00_w + p00_radix - 1)/p00_radix;
+      for (size_t p00_i = 0; p00_i < p00_up; ++p00_i) {
+        size_t p00_rest = p00_w - p00_i*p00_radix;
+        p00_t[p00_base + p00_i] = (p00_barrier_node) {
+          .p00_n = (p00_rest < p00_radix) ? p00_rest : p00_radix,
+          .p00_parent = (p00_up > 1) ? p00_base + p00_up + p00_i/p00_radix : UINT_MAX,
+        };
+        atomic_init(&p00_t[p00_base + p00_i].p00_count, 0u);
+      }
+      p00_base += p00_up;
+      p00_w = p00_up;
+    }
+    p00_bar->p00_tree = p00_t;
+  }
+  return p00_bar;
+}
+
+#ifndef DOXYGEN
+#define p99_barrier_init(...) P99_CALL_DEFARG(p99_barrier_init, 3, __VA_ARGS__)
+#define p99_barrier_init_defarg_2() 0U
+#endif
+
+/**
+ ** @brief destroy a barrier
+ **
+ ** @warning No thread may be waiting on @a p00_bar.
+ ** @related p99_barrier
+ **/
+p99_inline
+void p99_barrier_destroy(p99_barrier* p00_bar) {
+  if (p00_bar) {
+    free(p00_bar->p00_tree);
+    p00_bar->p00_tree = 0;
+    p99_futex_destroy(&p00_bar->p00_sense);
+  }
+}
+
+/**
+ ** @brief A value for the @c p00_id argument of ::p99_barrier_wait
+ ** that tells that the calling thread has no fixed position in the
+ ** combining tree.
+ **/
+#define P99_BARRIER_NOID UINT_MAX
+
+/**
+ ** @brief Block until all threads of the current phase have arrived
+ ** at @a p00_bar.
+ **
+ ** @param p00_id should be a number in the range <code>[0, n)</code>
+ ** that is distinct for all threads that use the barrier. It
+ ** determines the leaf of the combining tree where the thread
+ ** arrives. It is ignored for a flat barrier.
+ **
+ ** If @a p00_id is omitted or is ::P99_BARRIER_NOID, a distinct
+ ** position is obtained from a ticket counter that is shared by all
+ ** threads. This is correct, but it reintroduces one contended atomic
+ ** operation per arrival.
+ **
+ ** @warning All threads that use @a p00_bar must use the same style,
+ ** either all with distinct explicit ids or all with
+ ** ::P99_BARRIER_NOID. A ticket is only distinct from the other
+ ** tickets of the phase, not from the explicit ids, so if the styles
+ ** are mixed two threads may arrive at the same leaf and the barrier
+ ** may open too early or never.
+ **
+ ** @return ::P99_BARRIER_SERIAL_THREAD for exactly one thread per
+ ** phase, namely the last thread that arrived, and @c 0 for all
+ ** others.
+ ** @related p99_barrier
+ **/
+P99_DEFARG_DOCU(p99_barrier_wait)
+P00_FUTEX_INLINE(p99_barrier_wait)
+int p99_barrier_wait(p99_barrier volatile* p00_bar, unsigned p00_id) {
+  /* The sense can not change before we have arrived. */
+  register unsigned const p00_sense = p99_futex_load(&p00_bar->p00_sense);
+  bool p00_last = false;
+  p00_barrier_node* p00_t = p00_bar->p00_tree;
+  if (!p00_t) {
+    p00_last = p00_barrier_arrive(&p00_bar->p00_count, p00_bar->p00_n);
+  } else {
+    /* The tickets of one phase form a range of n consecutive values,
+       so they are distinct modulo n. */
+    if (p00_id >= p00_bar->p00_n)
+      p00_id = atomic_fetch_add_explicit(&p00_bar->p00_ticket, 1u, memory_order_relaxed) % p00_bar->p00_n;
+    for (unsigned p00_pos = p00_id / p00_bar->p00_radix;
+         p00_barrier_arrive(&p00_t[p00_pos].p00_count, p00_t[p00_pos].p00_n);
+         p00_pos = p00_t[p00_pos].p00_parent) {
+      if (p00_t[p00_pos].p00_parent == UINT_MAX) {
+        p00_last = true;
+        break;
+      }
+    }
+  }
+  if (p00_last) {
+    register unsigned const p00_new = !p00_sense;
+    p99_futex_exchange(&p00_bar->p00_sense, p00_new, p00_new, 1u, 0u, P99_FUTEX_MAX_WAITERS);
+    return P99_BARRIER_SERIAL_THREAD;
+  }
+  P99_FUTEX_COMPARE_EXCHANGE(&p00_bar->p00_sense, p00_act,
+                             /* wait until the sense has flipped */
+                             (p00_act != p00_sense),
+                             /* never update */
+                             p00_act,
+                             /* never wakeup others */
+                             0u, 0u);
+  return 0;
+}
+
+#ifndef DOXYGEN
+#define p99_barrier_wait(...) P99_CALL_DEFARG(p99_barrier_wait, 2, __VA_ARGS__)
+#define p99_barrier_wait_defarg_1() P99_BARRIER_NOID
+#endif
+
+/**
+ ** @}
+ **/
+
+
+#endif
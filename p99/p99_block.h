@@ -511,6 +511,8 @@ P99_DECLARE_STRUCT(p00_jmp_buf0);
 struct p00_jmp_buf0 {
   p00_jmp_buf0 * p99_lifo;
   bool volatile p00_returning;
+  /* set if we land here through p00_jmp_throw, not P99_UNWIND */
+  bool volatile p00_thrown;
   int volatile p00_code;
   jmp_buf p00_buf;
 };
@@ -23,6 +23,7 @@
 #define P99_CALLBACK_H 1
 
 # include "p99_lifo.h"
+# include "p99_new.h"
 
 /**
  ** @addtogroup callbacks simple callbacks with or without void* argument
@@ -56,6 +57,8 @@ typedef void p99_callback_void_func(void);
  **/
 typedef void p99_callback_voidptr_func(void*);
 
+P99_DECLARE_STRUCT(p99_callback_pool);
+
 struct p99_callback_el {
   p99_callback_el_ptr p99_lifo;
   p99_callback_voidptr_func * p00_voidptr_func;
@@ -63,8 +66,149 @@ struct p99_callback_el {
     p99_callback_void_func * p00_void_func;
     void* p00_arg;
   } p00_void;
+  /* 0 if the element is allocated with malloc, the pool of the
+     element, or p00_callback_owned if it is owned by the caller. */
+  p99_callback_pool* p00_home;
+};
+
+P99_DECLARE_STRUCT(p00_callback_chunk);
+P99_POINTER_TYPE(p00_callback_chunk);
+#ifndef P00_DOXYGEN
+P99_LIFO_DECLARE(p00_callback_chunk_ptr);
+#endif
+
+/**
+ ** @brief The number of elements that a ::p99_callback_pool
+ ** allocates at once.
+ **/
+#ifndef P99_CALLBACK_CHUNK
+# define P99_CALLBACK_CHUNK 32
+#endif
+
+struct p00_callback_chunk {
+  p00_callback_chunk_ptr p99_lifo;
+  p99_callback_el p00_el[P99_CALLBACK_CHUNK];
+};
+
+/**
+ ** @brief A pool of elements for callbacks, from which
+ ** ::P99_CALLBACK_PUSH_POOL takes its elements.
+ **
+ ** Elements are allocated in chunks of ::P99_CALLBACK_CHUNK and never
+ ** given back to the system before ::p99_callback_pool_destroy. After
+ ** a callback has been run by ::p99_callback, its element returns to
+ ** the pool. So if the number of callbacks that are registered at the
+ ** same time is bounded, registration eventually doesn't allocate at
+ ** all.
+ **
+ ** Typically there is one pool per ::p99_callback_stack, but a pool
+ ** may serve several stacks and be used by several threads.
+ **
+ ** @see P99_CALLBACK_PUSH_EL for elements that are provided by the
+ ** caller
+ **/
+struct p99_callback_pool {
+#ifndef P00_DOXYGEN
+  P99_LIFO(p99_callback_el_ptr) p00_free;
+  P99_LIFO(p00_callback_chunk_ptr) p00_chunks;
+#endif
 };
 
+/**
+ ** @brief Initialize a ::p99_callback_pool.
+ **
+ ** A pool that has all bytes @c 0 is also properly initialized.
+ ** @related p99_callback_pool
+ **/
+#define P99_CALLBACK_POOL_INITIALIZER                          \
+{                                                              \
+  .p00_free = P99_LIFO_INITIALIZER(0),                         \
+  .p00_chunks = P99_LIFO_INITIALIZER(0),                       \
+}
+
+/**
+ ** @related p99_callback_pool
+ **/
+p99_inline
+p99_callback_pool* p99_callback_pool_init(p99_callback_pool* p00_p) {
+  if (p00_p) {
+    p99_lifo_init(&p00_p->p00_free, 0);
+    p99_lifo_init(&p00_p->p00_chunks, 0);
+  }
+  return p00_p;
+}
+
+/**
+ ** @brief Free all memory of @a p00_p.
+ **
+ ** @warning No element of the pool may still be registered with a
+ ** ::p99_callback_stack.
+ ** @related p99_callback_pool
+ **/
+p99_inline
+void p99_callback_pool_destroy(p99_callback_pool* p00_p) {
+  if (p00_p) {
+    for (p00_callback_chunk* p00_c = P99_LIFO_CLEAR(&p00_p->p00_chunks); p00_c;) {
+      p00_callback_chunk* p00_n = p00_c->p99_lifo;
+      free(p00_c);
+      p00_c = p00_n;
+    }
+    (void)P99_LIFO_CLEAR(&p00_p->p00_free);
+  }
+}
+
+/* Push a list of elements from p00_h to p00_t onto p00_l. The order
+   of the elements is only kept if there are atomic operations. */
+p99_inline
+void p00_callback_push_list(p99_callback_stack* p00_l, p99_callback_el* p00_h, p99_callback_el* p00_t) {
+#if defined(P99_DECLARE_ATOMIC)
+  /* one atomic operation for the whole list */
+  P99_TP_TYPE_STATE(p00_l) p00_state = P99_TP_STATE_INITIALIZER(p00_l, p00_h);
+  do {
+    p00_t->p99_lifo = P99_TP_STATE_GET(&p00_state);
+  } while (!P99_TP_STATE_COMMIT(&p00_state));
+#else
+  for (p99_callback_el* p00_n = p00_h; p00_h != p00_t; p00_h = p00_n) {
+    p00_n = p00_h->p99_lifo;
+    P99_LIFO_PUSH(p00_l, p00_h);
+  }
+  P99_LIFO_PUSH(p00_l, p00_t);
+#endif
+}
+
+/* Give a list of elements from p00_h to p00_t back to the pool. */
+p99_inline
+void p00_callback_pool_give(p99_callback_pool* p00_p, p99_callback_el* p00_h, p99_callback_el* p00_t) {
+  p00_callback_push_list(&p00_p->p00_free, p00_h, p00_t);
+}
+
+/**
+ ** @brief Take an element from @a p00_p, or return @c 0 if the pool
+ ** is empty and a new chunk could not be allocated.
+ ** @related p99_callback_pool
+ **/
+p99_inline
+p99_callback_el* p99_callback_pool_get(p99_callback_pool* p00_p) {
+  p99_callback_el* p00_ret = P99_LIFO_POP(&p00_p->p00_free);
+  if (P99_UNLIKELY(!p00_ret)) {
+    p00_callback_chunk* p00_c = malloc(sizeof *p00_c);
+    if (!p00_c) return 0;
+    P99_LIFO_PUSH(&p00_p->p00_chunks, p00_c);
+    /* Keep the first element, chain the others and give them to the
+       pool at once. */
+    for (size_t p00_i = 1; p00_i < P99_CALLBACK_CHUNK - 1; ++p00_i)
+      p00_c->p00_el[p00_i].p99_lifo = &p00_c->p00_el[p00_i + 1];
+    if (P99_CALLBACK_CHUNK > 1)
+      p00_callback_pool_give(p00_p, &p00_c->p00_el[1], &p00_c->p00_el[P99_CALLBACK_CHUNK - 1]);
+    p00_ret = &p00_c->p00_el[0];
+  }
+  return p00_ret;
+}
+
+/* The home of elements that are owned by the caller. */
+P99_WEAK(p00_callback_owned)
+p99_callback_pool p00_callback_owned;
+
 
 p99_inline
 p99_callback_el* p99_callback_el_init(p99_callback_el * p00_obj,
@@ -148,6 +292,70 @@ p99_callback_el* p00_callback_push(p99_callback_stack* p00_l, p99_callback_el* p
  **/
 #define P99_CALLBACK_PUSH(STCK, ...) p00_callback_push((STCK), P99_NEW(p99_callback_el, __VA_ARGS__))
 
+p99_inline
+p99_callback_el* p00_callback_push_el(p99_callback_stack* p00_l, p99_callback_el* p00_el) {
+  if (p00_el) {
+    p00_el->p00_home = &p00_callback_owned;
+    P99_LIFO_PUSH(p00_l, p00_el);
+  }
+  return p00_el;
+}
+
+/**
+ ** @brief Register a function as a callback on @a STCK, using the
+ ** element @a EL that is provided by the caller.
+ **
+ ** @param STCK should be of type ::p99_callback_stack*
+ ** @param EL should be of type ::p99_callback_el*
+ **
+ ** The remaining arguments are the same as for ::P99_CALLBACK_PUSH.
+ ** This doesn't allocate: the registration is one atomic operation
+ ** on @a STCK. ::p99_callback doesn't access @a EL after it has
+ ** started the callback, so the callback itself may dispose of the
+ ** storage of @a EL. Before that, @a EL must remain valid and may
+ ** not be registered again.
+ **
+ ** @code
+ ** struct request {
+ **   p99_callback_el cleanup;
+ **   ...
+ ** };
+ **
+ ** P99_CALLBACK_PUSH_EL(&cleanups, &req->cleanup, request_delete, req);
+ ** @endcode
+ **
+ ** @related p99_callback_stack
+ ** @see P99_CALLBACK_PUSH_POOL
+ **/
+#define P99_CALLBACK_PUSH_EL(STCK, EL, ...) p00_callback_push_el((STCK), p99_callback_el_init((EL), __VA_ARGS__))
+
+p99_inline
+p99_callback_el* p00_callback_push_pool(p99_callback_stack* p00_l, p99_callback_pool* p00_p, p99_callback_el const* p00_cb) {
+  p99_callback_el* p00_el = p99_callback_pool_get(p00_p);
+  if (p00_el) {
+    *p00_el = *p00_cb;
+    p00_el->p00_home = p00_p;
+    P99_LIFO_PUSH(p00_l, p00_el);
+  }
+  return p00_el;
+}
+
+/**
+ ** @brief Register a function as a callback on @a STCK, taking the
+ ** element from @a POOL.
+ **
+ ** @param STCK should be of type ::p99_callback_stack*
+ ** @param POOL should be of type ::p99_callback_pool*
+ **
+ ** The remaining arguments are the same as for ::P99_CALLBACK_PUSH.
+ ** Once @a POOL has enough elements, this is two atomic operations
+ ** and doesn't allocate.
+ **
+ ** @related p99_callback_stack
+ ** @see P99_CALLBACK_PUSH_EL
+ **/
+#define P99_CALLBACK_PUSH_POOL(STCK, POOL, ...) p00_callback_push_pool((STCK), (POOL), p99_callback_el_init(&P99_LVAL(p99_callback_el), __VA_ARGS__))
+
 
 /**
  ** @brief Call all functions that have been registered with @a
@@ -164,17 +372,41 @@ p99_callback_el* p00_callback_push(p99_callback_stack* p00_l, p99_callback_el* p
  ** be registered with @a p00_stck by one of the callbacks would not
  ** be executed in the same batch.
  **
+ ** Only the elements that have been allocated by ::P99_CALLBACK_PUSH
+ ** are freed one by one. Elements from a ::p99_callback_pool are
+ ** given back to their pool in bulk, and elements that are owned by
+ ** the caller are left alone.
+ **
  ** @related p99_callback_stack
  ** @see P99_CALLBACK_PUSH to register a callback function
+ ** @see P99_CALLBACK_PUSH_EL
+ ** @see P99_CALLBACK_PUSH_POOL
  **/
 p99_inline
 void p99_callback(p99_callback_stack* p00_stck) {
+  /* The elements of the same pool that follow each other are
+     collected in a list from p00_first to p00_last. */
+  p99_callback_pool* p00_pool = 0;
+  p99_callback_el* p00_first = 0;
+  p99_callback_el* p00_last = 0;
   for (p99_callback_el *head = P99_LIFO_CLEAR(p00_stck), *p00_el = head; p00_el; p00_el = head) {
     head = p00_el->p99_lifo;
     p99_callback_el const p00_cb = *p00_el;
-    free(p00_el);
+    if (!p00_cb.p00_home) {
+      P99_FREE(p00_el);
+    } else if (p00_cb.p00_home != &p00_callback_owned) {
+      if (p00_cb.p00_home != p00_pool) {
+        if (p00_first) p00_callback_pool_give(p00_pool, p00_first, p00_last);
+        p00_pool = p00_cb.p00_home;
+        p00_first = 0;
+      }
+      if (!p00_first) p00_last = p00_el;
+      p00_el->p99_lifo = p00_first;
+      p00_first = p00_el;
+    }
     p99_callback_el_call(p00_cb);
   }
+  if (p00_first) p00_callback_pool_give(p00_pool, p00_first, p00_last);
 }
 
 
@@ -78,6 +78,9 @@ void *aligned_alloc(size_t p00_alignment, size_t p00_size) {
 P99_WEAK(p00_cb)
 p99_callback_stack p00_at_quick_exit = P99_LIFO_INITIALIZER(0);
 
+P99_WEAK(p00_at_quick_exit_pool)
+p99_callback_pool p00_at_quick_exit_pool = P99_CALLBACK_POOL_INITIALIZER;
+
 # ifdef __USE_GNU
 #  if __GLIBC_PREREQ(2,13)
 /* they seem to have implemented quick_exit */
@@ -88,7 +91,7 @@ p99_callback_stack p00_at_quick_exit = P99_LIFO_INITIALIZER(0);
  **/
 p99_inline
 int at_quick_exit(void (*p00_void_func)(void)) {
-  return !P99_CALLBACK_PUSH(&p00_at_quick_exit, p00_void_func);
+  return !P99_CALLBACK_PUSH_POOL(&p00_at_quick_exit, &p00_at_quick_exit_pool, p00_void_func);
 }
 
 /**
@@ -110,12 +113,23 @@ _Noreturn void quick_exit(int status) {
 
 #endif /* C < C11 */
 
+/* The callbacks of a thread take their elements from a pool of the
+   same thread, such that registration only allocates for the first
+   callback of a chunk. */
+struct p00_thrd_exit {
+  p99_callback_stack p00_stck;
+  p99_callback_pool p00_pool;
+};
+
 P99_SETJMP_INLINE(p00_run_at_thrd_exit)
 void p00_run_at_thrd_exit(void * li) {
-  p99_callback(li);
+  struct p00_thrd_exit* p00_te = li;
+  p99_callback(&p00_te->p00_stck);
+  p99_callback_pool_destroy(&p00_te->p00_pool);
+  free(p00_te);
 }
 
-P99_TSS_DECLARE_LOCAL(p99_callback_stack, p00_at_thrd_exit, p00_run_at_thrd_exit);
+P99_TSS_DECLARE_LOCAL(struct p00_thrd_exit, p00_at_thrd_exit, p00_run_at_thrd_exit);
 # define P00_AT_THRD_EXIT P99_TSS_LOCAL(p00_at_thrd_exit)
 
 /**
@@ -127,7 +141,8 @@ P99_TSS_DECLARE_LOCAL(p99_callback_stack, p00_at_thrd_exit, p00_run_at_thrd_exit
  **/
 p99_inline
 int at_thrd_exit(void (*p00_void_func)(void)) {
-  return !P99_CALLBACK_PUSH(&P00_AT_THRD_EXIT, p00_void_func);
+  struct p00_thrd_exit* p00_te = &P00_AT_THRD_EXIT;
+  return !P99_CALLBACK_PUSH_POOL(&p00_te->p00_stck, &p00_te->p00_pool, p00_void_func);
 }
 
 /* Add rudimentary support for the timespec data structure */
@@ -316,6 +316,7 @@ signed p00_trailing_comma_in_initializer__(void) {
 # define P99_TYPEOF(X) __typeof__(X)
 # if P99_GCC_VERSION >= 30000UL
 #  define p00_has_builtin___builtin_expect 1
+#  define p00_has_builtin___builtin_prefetch 1
 # endif
 //# if P99_GCC_VERSION >= UNKNOWN
 //#  define p00_has_feature_c_alignas 1
@@ -756,6 +757,47 @@ typedef __int128_t p99x_int128;
 # endif
 #endif
 
+/**
+ ** @brief The size of a cache line that is assumed at compile time.
+ **
+ ** This is used to separate data that is written by different
+ ** threads, such that they don't compete for the same cache line
+ ** ("false sharing"). It can be overwritten by defining this macro
+ ** before any P99 header is included. The value that is found on the
+ ** running platform is returned by ::p99_cache_line.
+ **
+ ** @see P99_CACHE_ALIGNED
+ **/
+#ifndef P99_CACHE_LINE
+# if defined(__powerpc64__) || defined(__s390x__) || (defined(__aarch64__) && defined(__APPLE__))
+#  define P99_CACHE_LINE 128
+# else
+#  define P99_CACHE_LINE 64
+# endif
+#endif
+
+/**
+ ** @brief Declare an object or a member of type @a T that starts on
+ ** a cache line of its own.
+ **
+ ** @code
+ ** struct counters {
+ **   P99_CACHE_ALIGNED(_Atomic(size_t)) produced;
+ **   P99_CACHE_ALIGNED(_Atomic(size_t)) consumed;
+ ** };
+ ** @endcode
+ **
+ ** Since the alignment of the structure is then ::P99_CACHE_LINE, its
+ ** size is rounded up, too, and elements of an array of such
+ ** structures don't share cache lines.
+ **/
+#define P99_CACHE_ALIGNED(T) _Alignas(P99_CACHE_LINE) T
+
+/**
+ ** @brief Round the size @a S up to a multiple of ::P99_CACHE_LINE.
+ **/
+#define P99_CACHE_ROUND(S) ((((S) + P99_CACHE_LINE - 1)/P99_CACHE_LINE)*P99_CACHE_LINE)
+
 /**
  ** @brief A type with the maximum alignment among the standard types.
  **
@@ -976,6 +1018,21 @@ extern void P99_PASTE(p00_harmless_declaration_, __VA_ARGS__)(void)
 # define P99_EXPECT(EXP, VAL) (EXP)
 #endif
 
+/**
+ ** @def P99_PREFETCH
+ ** @brief Provide a compiler hint that the memory at address @a ADDR
+ ** will be read soon.
+ **
+ ** This has no effect on the semantics of the program, @a ADDR may
+ ** even be an invalid address. Currently this is only implemented
+ ** for gcc and related.
+ **/
+#if p99_has_builtin(__builtin_prefetch)
+# define P99_PREFETCH(ADDR) __builtin_prefetch(ADDR)
+#else
+# define P99_PREFETCH(ADDR) ((void)0)
+#endif
+
 /**
  ** @brief Mark the conditional expression as being unlikely
  **
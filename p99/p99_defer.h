@@ -0,0 +1,266 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_DEFER_H
+#define P99_DEFER_H 1
+
+#include "p99_callback.h"
+#include "p99_futex.h"
+#include "p99_threads.h"
+
+/**
+ ** @addtogroup defer Deferred destruction
+ **
+ ** Destroying an object and calling @c free can take a long time,
+ ** in particular if the object owns other objects. ::p99_defer_delete
+ ** moves that work off a latency critical thread: the object is only
+ ** queued, and the destructors are run later in batches, either by a
+ ** background thread that is started with ::p99_defer_start or by any
+ ** thread that calls ::p99_defer_drain at a quiescent point.
+ **
+ ** Each thread collects its deferred objects in a list of its own,
+ ** without atomic operations. Once that list has ::P99_DEFER_BATCH
+ ** elements, or when the thread calls ::p99_defer_flush or exits, the
+ ** list is handed over to a global queue with one atomic operation.
+ ** The elements of the lists are ::p99_callback_el from a shared
+ ** ::p99_callback_pool, so after a warm up phase this doesn't
+ ** allocate.
+ **
+ ** For reference counted types, ::P99_DECLARE_DEFER_DELETE provides
+ ** a function that can be passed to ::P99_TP_REF_FUNCTIONS, such that
+ ** releasing the last reference defers the destruction.
+ ** @{
+ **/
+
+/**
+ ** @brief The number of objects that a thread collects before it
+ ** hands them over to the global queue.
+ **/
+#ifndef P99_DEFER_BATCH
+# define P99_DEFER_BATCH 64u
+#endif
+
+P99_WEAK(p00_defer_pool)
+p99_callback_pool p00_defer_pool = P99_CALLBACK_POOL_INITIALIZER;
+
+P99_WEAK(p00_defer_queue)
+p99_callback_stack p00_defer_queue = P99_LIFO_INITIALIZER(0);
+
+/* The number of batches that have been handed over since the
+   reclaimer looked the last time. */
+P99_WEAK(p00_defer_pending)
+p99_futex p00_defer_pending = P99_FUTEX_INITIALIZER(0u);
+
+P99_WEAK(p00_defer_stop)
+_Atomic(bool) p00_defer_stop;
+
+P99_WEAK(p00_defer_running)
+atomic_flag p00_defer_running;
+
+P99_WEAK(p00_defer_thrd)
+thrd_t p00_defer_thrd;
+
+struct p00_defer_local {
+  p99_callback_el* p00_head;
+  p99_callback_el* p00_tail;
+  size_t p00_n;
+};
+
+p99_inline
+void p00_defer_handover(struct p00_defer_local* p00_l) {
+  if (p00_l->p00_head) {
+    p00_callback_push_list(&p00_defer_queue, p00_l->p00_head, p00_l->p00_tail);
+    *p00_l = (struct p00_defer_local) { 0 };
+    /* Only wake up the reclaimer if it might sleep. */
+    p99_futex_add(&p00_defer_pending, 1u, 1u, 1u, 0u, 1u);
+  }
+}
+
+P99_WEAK(p00_defer_exit)
+void p00_defer_exit(void* p00_l) {
+  p00_defer_handover(p00_l);
+  free(p00_l);
+}
+
+P99_TSS_DECLARE_LOCAL(struct p00_defer_local, p00_defer_local, p00_defer_exit);
+
+/**
+ ** @brief Queue the destruction of @a p00_obj by @a p00_dtor.
+ **
+ ** @a p00_dtor is called with @a p00_obj as argument, later and
+ ** possibly by another thread. So the destruction must not rely on
+ ** thread local state of the calling thread. The order in which the
+ ** destructors of different objects are called is unspecified.
+ **
+ ** If there is no memory to queue @a p00_obj, it is destroyed
+ ** immediately.
+ **
+ ** @see p99_defer_flush
+ ** @see p99_defer_drain
+ ** @see p99_defer_start
+ **/
+p99_inline
+void p99_defer_delete(void* p00_obj, p99_callback_voidptr_func* p00_dtor) {
+  if (!p00_obj) return;
+  struct p00_defer_local* p00_l = &P99_TSS_LOCAL(p00_defer_local);
+  p99_callback_el* p00_el = p00_l ? p99_callback_pool_get(&p00_defer_pool) : 0;
+  if (P99_UNLIKELY(!p00_el)) {
+    p00_dtor(p00_obj);
+    return;
+  }
+  *p00_el = (p99_callback_el) {
+    .p99_lifo = p00_l->p00_head,
+    .p00_voidptr_func = p00_dtor,
+    .p00_void = { .p00_arg = p00_obj, },
+    .p00_home = &p00_defer_pool,
+  };
+  if (!p00_l->p00_head) p00_l->p00_tail = p00_el;
+  p00_l->p00_head = p00_el;
+  if (++p00_l->p00_n >= P99_DEFER_BATCH) p00_defer_handover(p00_l);
+}
+
+/**
+ ** @brief Hand the objects that the calling thread has queued with
+ ** ::p99_defer_delete over to the global queue.
+ **
+ ** This is done automatically when a thread exits. Call this at a
+ ** point where a thread would otherwise keep objects pending for a
+ ** long time, e.g before it blocks for new work.
+ **/
+p99_inline
+void p99_defer_flush(void) {
+  p00_defer_handover(&P99_TSS_LOCAL(p00_defer_local));
+}
+
+/**
+ ** @brief Destroy all objects that have been handed over to the
+ ** global queue, and those of the calling thread.
+ **
+ ** This can be called at a quiescent point of an application that
+ ** doesn't run a background reclaimer. It is safe to call this
+ ** concurrently with the reclaimer or with other threads that drain.
+ **/
+p99_inline
+void p99_defer_drain(void) {
+  p99_defer_flush();
+  p99_callback(&p00_defer_queue);
+}
+
+P00_FUTEX_INLINE(p00_defer_wait)
+void p00_defer_wait(void) {
+  P99_FUTEX_COMPARE_EXCHANGE(&p00_defer_pending, p00_act,
+                             /* wait until there is something to do */
+                             p00_act,
+                             /* and take it all */
+                             0u,
+                             /* never wake up anybody */
+                             0u, 0u);
+}
+
+P99_WEAK(p00_defer_reclaim)
+int p00_defer_reclaim(void* p00_arg) {
+  (void)p00_arg;
+  for (;;) {
+    p00_defer_wait();
+    p99_callback(&p00_defer_queue);
+    if (atomic_load(&p00_defer_stop)) break;
+  }
+  return 0;
+}
+
+/**
+ ** @brief Start a background thread that runs the destructors of
+ ** the objects that are handed over to the global queue.
+ **
+ ** @return ::thrd_success if the thread has been started or was
+ ** already running, an error code of ::thrd_create otherwise.
+ **
+ ** @see p99_defer_stop
+ **/
+p99_inline
+int p99_defer_start(void) {
+  if (atomic_flag_test_and_set(&p00_defer_running)) return thrd_success;
+  atomic_store(&p00_defer_stop, false);
+  int p00_ret = thrd_create(&p00_defer_thrd, p00_defer_reclaim, 0);
+  if (p00_ret != thrd_success) atomic_flag_clear(&p00_defer_running);
+  return p00_ret;
+}
+
+/**
+ ** @brief Stop the thread that has been started with
+ ** ::p99_defer_start, if any, and drain the global queue.
+ **
+ ** This should be called by the same thread that started the
+ ** reclaimer.
+ **/
+p99_inline
+void p99_defer_stop(void) {
+  if (atomic_flag_test_and_set(&p00_defer_running)) {
+    atomic_store(&p00_defer_stop, true);
+    p99_futex_add(&p00_defer_pending, 1u, 0u, UINT_MAX, 0u, 1u);
+    thrd_join(p00_defer_thrd, 0);
+  }
+  atomic_flag_clear(&p00_defer_running);
+  p99_defer_drain();
+}
+
+/**
+ ** @brief Declare a function <code>T ## _defer_delete</code> that
+ ** queues the destruction of an object of type @a T with
+ ** ::p99_defer_delete.
+ **
+ ** The function <code>T ## _delete</code> must exist, see
+ ** ::P99_DECLARE_DELETE. It will eventually be called for the
+ ** object. The resulting function has the same prototype as
+ ** <code>T ## _delete</code>, so it can be used to choose deferred
+ ** destruction for a reference counted type:
+ **
+ ** @code
+ ** P99_DECLARE_STRUCT(session);
+ ** P99_DECLARE_DELETE(session);
+ ** P99_DECLARE_DEFER_DELETE(session);
+ ** P99_TP_REF_DECLARE(session);
+ ** P99_TP_REF_FUNCTIONS(session, session_defer_delete);
+ ** @endcode
+ **
+ ** @see P99_DEFINE_DEFER_DELETE to instantiate the functions
+ **/
+P00_DOCUMENT_TYPE_ARGUMENT(P99_DECLARE_DEFER_DELETE, 0)
+#define P99_DECLARE_DEFER_DELETE(T)                            \
+p99_inline                                                     \
+void P99_PASTE3(p00_, T, _defer_cb)(void* p00_el) {            \
+  P99_PASTE2(T, _delete)(p00_el);                              \
+}                                                              \
+p99_inline                                                     \
+void P99_PASTE2(T, _defer_delete)(T const* p00_el) {           \
+  p99_defer_delete((void*)p00_el, P99_PASTE3(p00_, T, _defer_cb)); \
+}                                                              \
+P99_MACRO_END(P99_DECLARE_DEFER_DELETE)
+
+P00_DOCUMENT_TYPE_ARGUMENT(P99_DEFINE_DEFER_DELETE, 0)
+#define P99_DEFINE_DEFER_DELETE(T)                             \
+P99_INSTANTIATE(void, P99_PASTE3(p00_, T, _defer_cb), void*);  \
+P99_INSTANTIATE(void, P99_PASTE2(T, _defer_delete), T const*)
+
+/**
+ ** @}
+ **/
+
+#endif
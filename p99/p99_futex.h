@@ -69,12 +69,10 @@ typedef p99_futex_c11 p99_futex;
  ** other usual control structures (mutexes, conditional variables,
  ** read-write locks, barriers, semaphores ...)
  **
- ** There is only one feature that is yet missing, here, which is wait
- ** calls that would time out, such as ::mtx_timedlock or
- ** ::cnd_timedwait provide it, e.g. There is no principal hurdle to
- ** overcome for the addition of such a feature, I just don't use
- ** these often, and so I am not yet sure about what interface I would
- ** provide for this.
+ ** Waits that time out, such as ::mtx_timedlock or ::cnd_timedwait
+ ** provide them, are only available through the low level function
+ ** ::p99_futex_timedwait. ::P99_FUTEX_COMPARE_EXCHANGE has no timed
+ ** variant.
  **
  ** @{
  **/
@@ -297,6 +295,27 @@ void p99_futex_wakeup(p99_futex volatile* p00_fut,
 P00_FUTEX_INLINE(p99_futex_wait)
 void p99_futex_wait(p99_futex volatile* p00_fut);
 
+/**
+ ** @brief Wait for futex @a p00_fut as long as it has value @a
+ ** p00_val, but not beyond the time @a p00_abs
+ ** @related p99_futex
+ **
+ ** @a p00_abs is an absolute time with respect to ::TIME_UTC, as
+ ** for ::cnd_timedwait.
+ **
+ ** @return ::thrd_timedout if the time has elapsed without the
+ ** thread being woken up, ::thrd_success otherwise. In particular
+ ** this returns immediately with ::thrd_success if the value of the
+ ** futex is not @a p00_val when entering.
+ **
+ ** @remark Other than ::p99_futex_wait a successful return does not
+ ** guarantee that the value of the futex has changed, so the caller
+ ** should check the value again.
+ **/
+P00_FUTEX_INLINE(p99_futex_timedwait)
+int p99_futex_timedwait(p99_futex volatile* p00_fut, unsigned p00_val,
+                        struct timespec const* p00_abs);
+
 
 
 #ifdef DOXYGEN
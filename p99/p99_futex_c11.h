@@ -133,6 +133,34 @@ void p99_futex_wait(p99_futex volatile* p00_fut) {
   p00_futex_wait(p00_fut);
 }
 
+P99_WEAK(p99_futex_timedwait)
+int p99_futex_timedwait(p99_futex volatile* p00_fut, unsigned p00_val,
+                        struct timespec const* p00_abs) {
+  int volatile p00_ret = thrd_success;
+  P99_MUTUAL_EXCLUDE(*(mtx_t*)&p00_fut->p99_mut) {
+    if (p00_fut->p99_cnt == p00_val) {
+      ++p00_fut->p99_waiting;
+      while (!p00_fut->p99_awaking) {
+        if (cnd_timedwait((cnd_t*)&p00_fut->p99_cnd, (mtx_t*)&p00_fut->p99_mut, p00_abs)
+            == thrd_timedout) {
+          p00_ret = thrd_timedout;
+          break;
+        }
+      }
+      /* If we timed out, we withdraw from the waiters. If there are
+         none left, somebody has already accounted for us as being
+         woken up, so we consume that wakeup. */
+      if (p00_ret == thrd_timedout && p00_fut->p99_waiting) {
+        --p00_fut->p99_waiting;
+      } else {
+        --p00_fut->p99_awaking;
+        p00_ret = thrd_success;
+      }
+    }
+  }
+  return p00_ret;
+}
+
 P99_WEAK(p99_futex_add)
 unsigned p99_futex_add(p99_futex volatile* p00_fut, unsigned p00_hmuch,
                        unsigned p00_cstart, unsigned p00_clen,
@@ -49,6 +49,15 @@
 #  define FUTEX_REQUEUE   3
 #  define FUTEX_CMP_REQUEUE 4
 # endif
+# ifndef FUTEX_WAIT_BITSET
+#  define FUTEX_WAIT_BITSET 9
+# endif
+# ifndef FUTEX_CLOCK_REALTIME
+#  define FUTEX_CLOCK_REALTIME 256
+# endif
+# ifndef FUTEX_BITSET_MATCH_ANY
+#  define FUTEX_BITSET_MATCH_ANY 0xffffffff
+# endif
 # include <unistd.h>
 # include <sys/syscall.h>
 
@@ -282,6 +291,29 @@ void p99_futex_wait(p99_futex volatile* p00_cntp) {
   }
 }
 
+p99_inline
+int p99_futex_timedwait(p99_futex volatile* p00_cntp, unsigned p00_val,
+                        struct timespec const* p00_abs) {
+  unsigned volatile*const p00_cnt = (unsigned*)p00_cntp;
+  static_assert(sizeof *p00_cntp == sizeof *p00_cnt,
+                "linux futex supposes that there is no hidden lock field");
+  for (;;) {
+    /* The bitset variant takes an absolute time and wakes up for
+       every plain FUTEX_WAKE. */
+    register int p00_ret = p00_futex((int*)p00_cnt,
+                                     FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME,
+                                     p00_val, p00_abs, 0, FUTEX_BITSET_MATCH_ANY);
+    if (P99_LIKELY(!p00_ret)) return thrd_success;
+    p00_ret = errno;
+    errno = 0;
+    switch (p00_ret) {
+    case ETIMEDOUT: return thrd_timedout;
+    case EINTR: continue;
+    /* A different value, or anything else that we can't handle. */
+    default: return thrd_success;
+    }
+  }
+}
 
 p99_inline
 unsigned p99_futex_add(p99_futex volatile* futex, unsigned p00_hmuch,
@@ -9628,6 +9628,412 @@ automatically generated, do not change manually.
 #define P00_MASK_61 0x1FFFFFFFFFFFFFFF
 #define P00_MASK_62 0x3FFFFFFFFFFFFFFF
 #define P00_MASK_63 0x7FFFFFFFFFFFFFFF
+#define P00_SORTNET_MAX 32
+#define P00_SORTNET_SIZES 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32
+/* 2 elements, 1 comparators */
+#define P00_SORTNET_2(CE, X) \
+ CE(X, 0, 1)
+/* 3 elements, 3 comparators */
+#define P00_SORTNET_3(CE, X) \
+ CE(X, 0, 1) CE(X, 0, 2) CE(X, 1, 2)
+/* 4 elements, 5 comparators */
+#define P00_SORTNET_4(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 0, 2) CE(X, 1, 3) CE(X, 1, 2)
+/* 5 elements, 9 comparators */
+#define P00_SORTNET_5(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 0, 2) CE(X, 1, 3) CE(X, 1, 2) CE(X, 0, 4) CE(X, 2, 4) CE(X, 1, 2) \
+ CE(X, 3, 4)
+/* 6 elements, 12 comparators */
+#define P00_SORTNET_6(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 0, 2) CE(X, 1, 3) CE(X, 1, 2) CE(X, 0, 4) CE(X, 1, 5) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 1, 2) CE(X, 3, 4)
+/* 7 elements, 16 comparators */
+#define P00_SORTNET_7(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 1, 2) CE(X, 5, 6) \
+ CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 2, 4) CE(X, 3, 5) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6)
+/* 8 elements, 19 comparators */
+#define P00_SORTNET_8(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6)
+/* 9 elements, 28 comparators */
+#define P00_SORTNET_9(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 0, 8) CE(X, 4, 8) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8)
+/* 10 elements, 32 comparators */
+#define P00_SORTNET_10(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) \
+ CE(X, 5, 7) CE(X, 1, 2) CE(X, 5, 6) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 0, 8) CE(X, 1, 9) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8)
+/* 11 elements, 38 comparators */
+#define P00_SORTNET_11(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) \
+ CE(X, 5, 7) CE(X, 8, 10) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) \
+ CE(X, 3, 7) CE(X, 2, 4) CE(X, 3, 5) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 0, 8) \
+ CE(X, 1, 9) CE(X, 2, 10) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10)
+/* 12 elements, 42 comparators */
+#define P00_SORTNET_12(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 0, 2) CE(X, 1, 3) \
+ CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 0, 4) \
+ CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 2, 4) CE(X, 3, 5) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) \
+ CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10)
+/* 13 elements, 48 comparators */
+#define P00_SORTNET_13(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 0, 2) CE(X, 1, 3) \
+ CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 0, 4) \
+ CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) \
+ CE(X, 4, 12) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 10, 12) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12)
+/* 14 elements, 53 comparators */
+#define P00_SORTNET_14(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 0, 2) \
+ CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) \
+ CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 0, 8) \
+ CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) \
+ CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12)
+/* 15 elements, 59 comparators */
+#define P00_SORTNET_15(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 0, 2) \
+ CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 1, 2) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 13, 14) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) \
+ CE(X, 10, 14) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) \
+ CE(X, 5, 13) CE(X, 6, 14) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14)
+/* 16 elements, 63 comparators */
+#define P00_SORTNET_16(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) \
+ CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 0, 8) CE(X, 1, 9) \
+ CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14)
+/* 17 elements, 85 comparators */
+#define P00_SORTNET_17(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) \
+ CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 0, 8) CE(X, 1, 9) \
+ CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 0, 16) \
+ CE(X, 8, 16) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16)
+/* 18 elements, 90 comparators */
+#define P00_SORTNET_18(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) \
+ CE(X, 13, 15) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) \
+ CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 0, 8) \
+ CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) \
+ CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 0, 16) CE(X, 1, 17) CE(X, 8, 16) CE(X, 9, 17) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 12, 16) CE(X, 13, 17) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 14, 16) CE(X, 15, 17) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 15, 16)
+/* 19 elements, 98 comparators */
+#define P00_SORTNET_19(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) \
+ CE(X, 13, 15) CE(X, 16, 18) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 4) \
+ CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) \
+ CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 8, 16) \
+ CE(X, 9, 17) CE(X, 10, 18) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) \
+ CE(X, 14, 18) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) \
+ CE(X, 15, 17) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 15, 16) CE(X, 17, 18)
+/* 20 elements, 103 comparators */
+#define P00_SORTNET_20(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) \
+ CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) \
+ CE(X, 11, 15) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) \
+ CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 1, 2) CE(X, 3, 4) \
+ CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 16) CE(X, 1, 17) \
+ CE(X, 2, 18) CE(X, 3, 19) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 1, 2) CE(X, 3, 4) \
+ CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18)
+/* 21 elements, 112 comparators */
+#define P00_SORTNET_21(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) \
+ CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) \
+ CE(X, 11, 15) CE(X, 16, 20) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 0, 8) \
+ CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) \
+ CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 18, 20) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) \
+ CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) \
+ CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 1, 2) CE(X, 3, 4) \
+ CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20)
+/* 22 elements, 119 comparators */
+#define P00_SORTNET_22(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) \
+ CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) \
+ CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 19, 20) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) \
+ CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) \
+ CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 0, 16) \
+ CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) \
+ CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) \
+ CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20)
+/* 23 elements, 127 comparators */
+#define P00_SORTNET_23(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) \
+ CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) CE(X, 1, 2) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) \
+ CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 0, 8) CE(X, 1, 9) \
+ CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) \
+ CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) \
+ CE(X, 13, 21) CE(X, 14, 22) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) \
+ CE(X, 14, 18) CE(X, 15, 19) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22)
+/* 24 elements, 132 comparators */
+#define P00_SORTNET_24(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) \
+ CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) CE(X, 21, 23) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 0, 4) CE(X, 1, 5) \
+ CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) \
+ CE(X, 18, 22) CE(X, 19, 23) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) \
+ CE(X, 21, 22) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) \
+ CE(X, 7, 15) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 0, 16) \
+ CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 16) \
+ CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) \
+ CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) \
+ CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22)
+/* 25 elements, 140 comparators */
+#define P00_SORTNET_25(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) \
+ CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) CE(X, 21, 23) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 0, 4) CE(X, 1, 5) \
+ CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) \
+ CE(X, 18, 22) CE(X, 19, 23) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) \
+ CE(X, 21, 22) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) \
+ CE(X, 7, 15) CE(X, 16, 24) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) \
+ CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) \
+ CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) \
+ CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 20, 24) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) \
+ CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24)
+/* 26 elements, 147 comparators */
+#define P00_SORTNET_26(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) \
+ CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) \
+ CE(X, 21, 23) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 0, 4) \
+ CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) \
+ CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) \
+ CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) \
+ CE(X, 19, 20) CE(X, 21, 22) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) \
+ CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 20, 24) CE(X, 21, 25) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 0, 16) \
+ CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) \
+ CE(X, 9, 25) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) \
+ CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) \
+ CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) \
+ CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24)
+/* 27 elements, 156 comparators */
+#define P00_SORTNET_27(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) \
+ CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) \
+ CE(X, 21, 23) CE(X, 24, 26) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) \
+ CE(X, 25, 26) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) \
+ CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 25, 26) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) \
+ CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 18, 26) \
+ CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) \
+ CE(X, 23, 25) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) \
+ CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) CE(X, 9, 25) CE(X, 10, 26) \
+ CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) \
+ CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) \
+ CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) \
+ CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26)
+/* 28 elements, 162 comparators */
+#define P00_SORTNET_28(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 26, 27) CE(X, 0, 2) CE(X, 1, 3) \
+ CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) \
+ CE(X, 20, 22) CE(X, 21, 23) CE(X, 24, 26) CE(X, 25, 27) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 21, 22) CE(X, 25, 26) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) \
+ CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 25, 26) CE(X, 0, 8) \
+ CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) \
+ CE(X, 17, 25) CE(X, 18, 26) CE(X, 19, 27) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) \
+ CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) \
+ CE(X, 25, 26) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) \
+ CE(X, 7, 23) CE(X, 8, 24) CE(X, 9, 25) CE(X, 10, 26) CE(X, 11, 27) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) \
+ CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) \
+ CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) \
+ CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) \
+ CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) \
+ CE(X, 23, 24) CE(X, 25, 26)
+/* 29 elements, 171 comparators */
+#define P00_SORTNET_29(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 26, 27) CE(X, 0, 2) CE(X, 1, 3) \
+ CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) CE(X, 17, 19) \
+ CE(X, 20, 22) CE(X, 21, 23) CE(X, 24, 26) CE(X, 25, 27) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 21, 22) CE(X, 25, 26) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) \
+ CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) CE(X, 24, 28) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 26, 28) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) \
+ CE(X, 25, 26) CE(X, 27, 28) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) \
+ CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 18, 26) CE(X, 19, 27) CE(X, 20, 28) CE(X, 4, 8) \
+ CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) \
+ CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) \
+ CE(X, 23, 25) CE(X, 26, 28) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) CE(X, 27, 28) CE(X, 0, 16) \
+ CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) \
+ CE(X, 9, 25) CE(X, 10, 26) CE(X, 11, 27) CE(X, 12, 28) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) \
+ CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) \
+ CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) \
+ CE(X, 23, 24) CE(X, 25, 26) CE(X, 27, 28)
+/* 30 elements, 178 comparators */
+#define P00_SORTNET_30(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 26, 27) CE(X, 28, 29) CE(X, 0, 2) \
+ CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) \
+ CE(X, 17, 19) CE(X, 20, 22) CE(X, 21, 23) CE(X, 24, 26) CE(X, 25, 27) CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) \
+ CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 25, 26) CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) \
+ CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) \
+ CE(X, 24, 28) CE(X, 25, 29) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) \
+ CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) \
+ CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 25, 26) CE(X, 27, 28) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) \
+ CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 18, 26) \
+ CE(X, 19, 27) CE(X, 20, 28) CE(X, 21, 29) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) \
+ CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) \
+ CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) \
+ CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) CE(X, 27, 28) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) \
+ CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) CE(X, 9, 25) CE(X, 10, 26) CE(X, 11, 27) \
+ CE(X, 12, 28) CE(X, 13, 29) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) \
+ CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) \
+ CE(X, 14, 18) CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) \
+ CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) \
+ CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) \
+ CE(X, 25, 26) CE(X, 27, 28)
+/* 31 elements, 186 comparators */
+#define P00_SORTNET_31(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 26, 27) CE(X, 28, 29) CE(X, 0, 2) \
+ CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) CE(X, 16, 18) \
+ CE(X, 17, 19) CE(X, 20, 22) CE(X, 21, 23) CE(X, 24, 26) CE(X, 25, 27) CE(X, 28, 30) CE(X, 1, 2) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 25, 26) CE(X, 29, 30) CE(X, 0, 4) CE(X, 1, 5) \
+ CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) CE(X, 16, 20) CE(X, 17, 21) \
+ CE(X, 18, 22) CE(X, 19, 23) CE(X, 24, 28) CE(X, 25, 29) CE(X, 26, 30) CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) \
+ CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 25, 26) CE(X, 27, 28) \
+ CE(X, 29, 30) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) \
+ CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 18, 26) CE(X, 19, 27) CE(X, 20, 28) CE(X, 21, 29) CE(X, 22, 30) \
+ CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) \
+ CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) \
+ CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) \
+ CE(X, 27, 28) CE(X, 29, 30) CE(X, 0, 16) CE(X, 1, 17) CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) \
+ CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) CE(X, 9, 25) CE(X, 10, 26) CE(X, 11, 27) CE(X, 12, 28) CE(X, 13, 29) \
+ CE(X, 14, 30) CE(X, 8, 16) CE(X, 9, 17) CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) \
+ CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) \
+ CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) \
+ CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) \
+ CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) \
+ CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) \
+ CE(X, 27, 28) CE(X, 29, 30)
+/* 32 elements, 191 comparators */
+#define P00_SORTNET_32(CE, X) \
+ CE(X, 0, 1) CE(X, 2, 3) CE(X, 4, 5) CE(X, 6, 7) CE(X, 8, 9) CE(X, 10, 11) CE(X, 12, 13) CE(X, 14, 15) \
+ CE(X, 16, 17) CE(X, 18, 19) CE(X, 20, 21) CE(X, 22, 23) CE(X, 24, 25) CE(X, 26, 27) CE(X, 28, 29) CE(X, 30, 31) \
+ CE(X, 0, 2) CE(X, 1, 3) CE(X, 4, 6) CE(X, 5, 7) CE(X, 8, 10) CE(X, 9, 11) CE(X, 12, 14) CE(X, 13, 15) \
+ CE(X, 16, 18) CE(X, 17, 19) CE(X, 20, 22) CE(X, 21, 23) CE(X, 24, 26) CE(X, 25, 27) CE(X, 28, 30) CE(X, 29, 31) \
+ CE(X, 1, 2) CE(X, 5, 6) CE(X, 9, 10) CE(X, 13, 14) CE(X, 17, 18) CE(X, 21, 22) CE(X, 25, 26) CE(X, 29, 30) \
+ CE(X, 0, 4) CE(X, 1, 5) CE(X, 2, 6) CE(X, 3, 7) CE(X, 8, 12) CE(X, 9, 13) CE(X, 10, 14) CE(X, 11, 15) \
+ CE(X, 16, 20) CE(X, 17, 21) CE(X, 18, 22) CE(X, 19, 23) CE(X, 24, 28) CE(X, 25, 29) CE(X, 26, 30) CE(X, 27, 31) \
+ CE(X, 2, 4) CE(X, 3, 5) CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 26, 28) CE(X, 27, 29) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) CE(X, 19, 20) \
+ CE(X, 21, 22) CE(X, 25, 26) CE(X, 27, 28) CE(X, 29, 30) CE(X, 0, 8) CE(X, 1, 9) CE(X, 2, 10) CE(X, 3, 11) \
+ CE(X, 4, 12) CE(X, 5, 13) CE(X, 6, 14) CE(X, 7, 15) CE(X, 16, 24) CE(X, 17, 25) CE(X, 18, 26) CE(X, 19, 27) \
+ CE(X, 20, 28) CE(X, 21, 29) CE(X, 22, 30) CE(X, 23, 31) CE(X, 4, 8) CE(X, 5, 9) CE(X, 6, 10) CE(X, 7, 11) \
+ CE(X, 20, 24) CE(X, 21, 25) CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) \
+ CE(X, 10, 12) CE(X, 11, 13) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 17, 18) \
+ CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) CE(X, 27, 28) CE(X, 29, 30) CE(X, 0, 16) CE(X, 1, 17) \
+ CE(X, 2, 18) CE(X, 3, 19) CE(X, 4, 20) CE(X, 5, 21) CE(X, 6, 22) CE(X, 7, 23) CE(X, 8, 24) CE(X, 9, 25) \
+ CE(X, 10, 26) CE(X, 11, 27) CE(X, 12, 28) CE(X, 13, 29) CE(X, 14, 30) CE(X, 15, 31) CE(X, 8, 16) CE(X, 9, 17) \
+ CE(X, 10, 18) CE(X, 11, 19) CE(X, 12, 20) CE(X, 13, 21) CE(X, 14, 22) CE(X, 15, 23) CE(X, 4, 8) CE(X, 5, 9) \
+ CE(X, 6, 10) CE(X, 7, 11) CE(X, 12, 16) CE(X, 13, 17) CE(X, 14, 18) CE(X, 15, 19) CE(X, 20, 24) CE(X, 21, 25) \
+ CE(X, 22, 26) CE(X, 23, 27) CE(X, 2, 4) CE(X, 3, 5) CE(X, 6, 8) CE(X, 7, 9) CE(X, 10, 12) CE(X, 11, 13) \
+ CE(X, 14, 16) CE(X, 15, 17) CE(X, 18, 20) CE(X, 19, 21) CE(X, 22, 24) CE(X, 23, 25) CE(X, 26, 28) CE(X, 27, 29) \
+ CE(X, 1, 2) CE(X, 3, 4) CE(X, 5, 6) CE(X, 7, 8) CE(X, 9, 10) CE(X, 11, 12) CE(X, 13, 14) CE(X, 15, 16) \
+ CE(X, 17, 18) CE(X, 19, 20) CE(X, 21, 22) CE(X, 23, 24) CE(X, 25, 26) CE(X, 27, 28) CE(X, 29, 30)
 
 //! @addtogroup P99
 //! @{
@@ -650,7 +650,9 @@ inline int* p00_generic_test(int * p00_a) {
  **
  ** As you can see above, the default value can be omitted. If omitted, it
  ** is replaced with some appropriate expression that should usually
- ** give you a syntax error.
+ ** give you a syntax error. So type generic interfaces that only
+ ** support some base types should leave the default empty, such that
+ ** the use with another type fails at compile time.
  **
  ** If there is a default expression, it is used when none of
  ** the types matches:
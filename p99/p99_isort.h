@@ -0,0 +1,179 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_ISORT_H
+#define P99_ISORT_H 1
+
+#include "p99_qsort.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+P99_DECLARE_STRUCT(p00_isort);
+
+/* An element of the array that is sorted instead of the records: the
+   cached key prefix and the original position of the record. */
+struct p00_isort {
+  uint64_t p00_key;
+  size_t p00_pos;
+};
+
+P99_DECLARE_STRUCT(p00_isort_ctx);
+
+struct p00_isort_ctx {
+  unsigned char const* p00_R;
+  rsize_t p00_s;
+  int (*p00_comp)(const void *, const void *, void *);
+  void *p00_ctx;
+};
+
+/* Compare the key prefixes, then the records and then the original
+   positions, such that the order is total and the sort stable. Its
+   address is taken, so it must have an external definition. */
+P99_WEAK(p00_isort_comp)
+int p00_isort_comp(void const* p00_a, void const* p00_b, void* p00_c) {
+  p00_isort const* p00_A = p00_a;
+  p00_isort const* p00_B = p00_b;
+  if (p00_A->p00_key != p00_B->p00_key)
+    return p00_A->p00_key < p00_B->p00_key ? -1 : 1;
+  p00_isort_ctx const* p00_C = p00_c;
+  int p00_r = p00_C->p00_comp(p00_C->p00_R + p00_A->p00_pos*p00_C->p00_s,
+                              p00_C->p00_R + p00_B->p00_pos*p00_C->p00_s,
+                              p00_C->p00_ctx);
+  if (p00_r) return p00_r;
+  return (p00_A->p00_pos > p00_B->p00_pos) - (p00_A->p00_pos < p00_B->p00_pos);
+}
+
+/* Sort the index array with the algorithm of qsort_s. The elements
+   have a fixed size, so they are swapped by assignment. */
+p99_inline
+errno_t p00_isort_sort(p00_isort* p00_base, rsize_t p00_n, p00_isort_ctx* p00_ctx) {
+  int (*const p00_comp)(const void *, const void *, void *) = p00_isort_comp;
+  rsize_t const p00_s = sizeof(p00_isort);
+  register p00_isort *const p00_B = p00_base;
+  p00_isort p00_tmp;
+  P00_QSORT_BODY(P00_QSWAP_ASSIGN);
+}
+
+/* Move the records to their final positions. Position p00_i receives
+   the record from p00_I[p00_i].p00_pos, so each cycle of the
+   permutation is followed from its start, and the record that is
+   found there is kept in p00_tmp until the cycle closes. Positions
+   that are done are marked as fixed points. */
+p99_inline
+void p00_isort_permute(unsigned char* p00_R, rsize_t p00_n, rsize_t p00_s,
+                       p00_isort* p00_I, unsigned char* p00_tmp) {
+  for (size_t p00_i = 0; p00_i < p00_n; ++p00_i) {
+    size_t p00_j = p00_i;
+    size_t p00_k = p00_I[p00_j].p00_pos;
+    if (p00_k == p00_i) continue;
+    memcpy(p00_tmp, p00_R + p00_i*p00_s, p00_s);
+    do {
+      memcpy(p00_R + p00_j*p00_s, p00_R + p00_k*p00_s, p00_s);
+      p00_I[p00_j].p00_pos = p00_j;
+      p00_j = p00_k;
+      p00_k = p00_I[p00_j].p00_pos;
+    } while (p00_k != p00_i);
+    memcpy(p00_R + p00_j*p00_s, p00_tmp, p00_s);
+    p00_I[p00_j].p00_pos = p00_j;
+  }
+}
+
+/**
+ ** @brief Sort an array of large records indirectly.
+ **
+ ** The interface is the same as for @c qsort_s. Instead of the records
+ ** themselves, an array of their positions is sorted, and only then
+ ** the records are moved to their final place by following the cycles
+ ** of the permutation. So each record is moved at most once, plus one
+ ** move for each cycle, instead of the O(n log n) swaps of three
+ ** @c memcpy each that @c qsort_s uses for element sizes that are not
+ ** handled by one of its vector types. This pays off for records of a
+ ** few words and more.
+ **
+ ** @param p00_key if this optional argument is not a null pointer, it
+ ** is a function that computes a prefix of the key of a record, and
+ ** that is called once for each record. The prefix must be consistent
+ ** with @a p00_comp, that is if the prefix of @c a is less than the
+ ** one of @c b, @c a must compare less than @c b. Then only records
+ ** with equal prefixes are compared with @a p00_comp, and all other
+ ** comparisons don't touch the records. Without prefixes each
+ ** comparison accesses two records at random places, so for large
+ ** arrays of records of moderate size this may well be slower than
+ ** @c qsort_s.
+ **
+ ** Other than @c qsort_s the sort is stable: records that compare
+ ** equal keep their relative order.
+ **
+ ** The function needs an auxiliary array of two words per element
+ ** and one record. It returns @c ENOMEM if these can't be allocated.
+ **
+ ** As for @c qsort_s, violations of the runtime constraints return
+ ** @c EDOM or @c EINVAL and trigger the constraint handler.
+ **/
+P99_DEFARG_DOCU(p99_isort_s)
+p99_inline
+errno_t p99_isort_s(void *p00_base,
+                    rsize_t p00_n,
+                    rsize_t p00_s,
+                    int (*p00_comp)(const void *, const void *, void *),
+                    void *p00_ctx,
+                    uint64_t (*p00_key)(const void *, void *)) {
+  if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;
+  if (p00_n && (!p00_base || !p00_s || !p00_comp)) return EINVAL;
+  if (p00_n < 2) return 0;
+  if (p00_n > (SIZE_MAX - p00_s)/sizeof(p00_isort)) return ENOMEM;
+  unsigned char* p00_R = p00_base;
+  p00_isort* p00_I = malloc(p00_n*sizeof *p00_I + p00_s);
+  if (!p00_I) return ENOMEM;
+  for (size_t p00_i = 0; p00_i < p00_n; ++p00_i) {
+    p00_I[p00_i] = (p00_isort) {
+      .p00_key = p00_key ? p00_key(p00_R + p00_i*p00_s, p00_ctx) : 0,
+      .p00_pos = p00_i,
+    };
+  }
+  p00_isort_ctx p00_c = {
+    .p00_R = p00_R,
+    .p00_s = p00_s,
+    .p00_comp = p00_comp,
+    .p00_ctx = p00_ctx,
+  };
+  errno_t p00_ret = p00_isort_sort(p00_I, p00_n, &p00_c);
+  if (!p00_ret)
+    p00_isort_permute(p00_R, p00_n, p00_s, p00_I, (unsigned char*)(p00_I + p00_n));
+  free(p00_I);
+  return p00_ret;
+}
+
+#ifndef DOXYGEN
+#define p99_isort_s(...)                                        \
+  P99_CONSTRAINT_TRIGGER(                                       \
+  P99_CALL_DEFARG(p99_isort_s, 6, __VA_ARGS__),                 \
+  "p99_isort_s runtime constraint violation")
+#define p99_isort_s_defarg_5() 0
+#endif
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -22,6 +22,7 @@
 #define P99_ITERATOR_H
 
 #include "p99_futex.h"
+#include "p99_lifo.h"
 
 /**
  ** @addtogroup futex
@@ -118,75 +119,298 @@ unsigned p99_iterator_signal(p99_iterator volatile* p00_i) {
 }
 
 
+/**
+ ** @brief The number of events that are held in one segment of a
+ ** ::p99_event.
+ **/
+#ifndef P99_EVENT_SEGMENT
+# define P99_EVENT_SEGMENT 64u
+#endif
+
+P99_DECLARE_STRUCT(p00_event_slot);
+
+/* The ready state of a slot is 0 while it is empty, 1 if a consumer
+   waits for it and 2 once the producer has stored its pointer. */
+enum { p00_event_empty, p00_event_waiting, p00_event_ready, };
+
+struct p00_event_slot {
+  void* p00_ptr;
+  p99_futex p00_ready;
+};
+
+P99_DECLARE_STRUCT(p00_event_seg);
+P99_POINTER_TYPE(p00_event_seg);
+P99_LIFO_DECLARE(p00_event_seg_ptr);
+P99_DECLARE_ATOMIC(p00_event_seg_ptr);
+
+struct p00_event_seg {
+  /* link in the lists of retired or free segments */
+  p00_event_seg_ptr p99_lifo;
+  /* link in the list of all segments, for destruction */
+  p00_event_seg_ptr p00_all;
+  _Atomic(p00_event_seg_ptr) p00_next;
+  /* the slots that have been claimed by producers and consumers, and
+     the slots that have been consumed */
+  _Atomic(unsigned) p00_put;
+  _Atomic(unsigned) p00_get;
+  _Atomic(unsigned) p00_done;
+  p00_event_slot p00_slot[P99_EVENT_SEGMENT];
+};
+
 P99_DECLARE_STRUCT(p99_event);
 
+/**
+ ** @brief An unbounded log of events that are signaled by some
+ ** threads and consumed by others.
+ **
+ ** Each call to ::p99_event_signal appends a pointer to the log, and
+ ** each call to ::p99_event_next returns one of these pointers, in
+ ** the order in which the producers have claimed their slots.
+ ** There may be several producers and several consumers.
+ **
+ ** The log is organized as a linked list of segments of
+ ** ::P99_EVENT_SEGMENT slots each. Producers and consumers claim
+ ** slots in the current segment with one atomic increment, and the
+ ** list grows as needed. Each slot has its own ready state in a
+ ** ::p99_futex, so a consumer that arrives before the producer has
+ ** stored the pointer blocks on that slot instead of spinning. A
+ ** producer only enters the OS to wake up the consumer if that
+ ** consumer is already waiting.
+ **
+ ** Segments that have been fully consumed are recycled for later use
+ ** instead of being freed. They are only reused once no other thread
+ ** is still in the middle of a claim, since such a thread could
+ ** otherwise still hold a stale reference to it. So under permanent
+ ** contention recycling may be delayed.
+ **
+ ** @see p99_event_init
+ ** @see p99_event_next
+ ** @see p99_event_signal
+ **/
 struct p99_event {
-  p99_iterator p00_it;
-  unsigned p00_n;
-  void ** p00_event;
+  _Atomic(p00_event_seg_ptr) p00_tail;
+  _Atomic(p00_event_seg_ptr) p00_head;
+  _Atomic(p00_event_seg_ptr) p00_all;
+  _Atomic(unsigned) p00_busy;
+  P99_LIFO(p00_event_seg_ptr) p00_retired;
+  P99_LIFO(p00_event_seg_ptr) p00_free;
 };
 
+p99_inline
+p00_event_seg* p00_event_seg_new(p99_event volatile* p00_e) {
+  p00_event_seg* p00_s = P99_LIFO_POP(&p00_e->p00_free);
+  if (p00_s) {
+    /* A recycled segment, its futexes are already initialized. */
+    for (unsigned p00_i = 0; p00_i < P99_EVENT_SEGMENT; ++p00_i) {
+      p00_s->p00_slot[p00_i].p00_ptr = 0;
+      p99_futex_exchange(&p00_s->p00_slot[p00_i].p00_ready, p00_event_empty, 0u, 0u, 0u, 0u);
+    }
+  } else {
+    p00_s = malloc(sizeof *p00_s);
+    if (!p00_s) return 0;
+    for (unsigned p00_i = 0; p00_i < P99_EVENT_SEGMENT; ++p00_i) {
+      p00_s->p00_slot[p00_i].p00_ptr = 0;
+      p99_futex_init(&p00_s->p00_slot[p00_i].p00_ready, p00_event_empty);
+    }
+    p00_s->p00_all = atomic_load(&p00_e->p00_all);
+    while (!atomic_compare_exchange_weak(&p00_e->p00_all, &p00_s->p00_all, p00_s)) {
+      /* empty */
+    }
+  }
+  p00_s->p99_lifo = 0;
+  atomic_init(&p00_s->p00_next, (p00_event_seg*)0);
+  atomic_init(&p00_s->p00_put, 0u);
+  atomic_init(&p00_s->p00_get, 0u);
+  atomic_init(&p00_s->p00_done, 0u);
+  atomic_thread_fence(memory_order_seq_cst);
+  return p00_s;
+}
+
+/* Return the successor of segment p00_s, creating it if necessary,
+   and try to advance the end pointer p00_end from p00_s to that
+   successor. */
+p99_inline
+p00_event_seg* p00_event_advance(p99_event volatile* p00_e,
+                                 _Atomic(p00_event_seg_ptr) volatile* p00_end,
+                                 p00_event_seg* p00_s) {
+  p00_event_seg* p00_n = atomic_load(&p00_s->p00_next);
+  if (!p00_n) {
+    p00_event_seg* p00_f = p00_event_seg_new(p00_e);
+    if (!p00_f) return 0;
+    if (atomic_compare_exchange_strong(&p00_s->p00_next, &p00_n, p00_f)) p00_n = p00_f;
+    else P99_LIFO_PUSH(&p00_e->p00_free, p00_f);
+  }
+  atomic_compare_exchange_strong(p00_end, &p00_s, p00_n);
+  return p00_n;
+}
+
+/* Claim the next slot for a producer or a consumer. The segments that
+   we see are protected from being recycled by the busy count. */
+p99_inline
+p00_event_slot* p00_event_claim(p99_event volatile* p00_e, bool p00_put, p00_event_seg** p00_segp) {
+  _Atomic(p00_event_seg_ptr) volatile* p00_end = p00_put ? &p00_e->p00_tail : &p00_e->p00_head;
+  p00_event_slot* p00_ret = 0;
+  atomic_fetch_add(&p00_e->p00_busy, 1u);
+  for (p00_event_seg* p00_s = atomic_load(p00_end); p00_s;) {
+    register unsigned const p00_i = atomic_fetch_add(p00_put ? &p00_s->p00_put : &p00_s->p00_get, 1u);
+    if (p00_i < P99_EVENT_SEGMENT) {
+      p00_ret = &p00_s->p00_slot[p00_i];
+      *p00_segp = p00_s;
+      break;
+    }
+    p00_s = p00_event_advance(p00_e, p00_end, p00_s);
+  }
+  atomic_fetch_sub(&p00_e->p00_busy, 1u);
+  return p00_ret;
+}
+
+/* Called by the consumer that finished the last slot of p00_s. */
+p99_inline
+void p00_event_retire(p99_event volatile* p00_e, p00_event_seg* p00_s) {
+  /* Ensure that no new claim will see this segment. If the
+     successor can't be allocated, the segment just stays where it
+     is. */
+  if (!p00_event_advance(p00_e, &p00_e->p00_tail, p00_s)
+      || !p00_event_advance(p00_e, &p00_e->p00_head, p00_s)) return;
+  P99_LIFO_PUSH(&p00_e->p00_retired, p00_s);
+  /* Take all retired segments. If nobody is in the middle of a claim,
+     nobody can hold a reference to them, so they may be reused. */
+  p00_event_seg* p00_r = P99_LIFO_CLEAR(&p00_e->p00_retired);
+  bool const p00_idle = !atomic_load(&p00_e->p00_busy);
+  while (p00_r) {
+    p00_event_seg* p00_n = p00_r->p99_lifo;
+    if (p00_idle) P99_LIFO_PUSH(&p00_e->p00_free, p00_r);
+    else P99_LIFO_PUSH(&p00_e->p00_retired, p00_r);
+    p00_r = p00_n;
+  }
+}
+
 /**
- ** @brief Initialize an event
+ ** @brief Initialize an event log
+ **
+ ** @param p00_n is the number of events for which space is allocated
+ ** in advance, rounded up to whole segments of ::P99_EVENT_SEGMENT
+ ** events. It defaults to one segment. Other than for earlier
+ ** versions this is only a hint, more segments will be allocated on
+ ** demand.
+ **
+ ** @return @a p00_e, or @c 0 if the first segment could not be
+ ** allocated.
  ** @related p99_event
  **/
 P99_DEFARG_DOCU(p99_event_init)
 p99_inline
 p99_event* p99_event_init(p99_event* p00_e, unsigned p00_n) {
   if (p00_e) {
-    (*p00_e) = (p99_event) {
-      .p00_n = p00_n,
-      .p00_event = P99_MEMZERO(void_ptr, P99_MALLOC(void_ptr[p00_n]), p00_n),
-    };
-    p99_iterator_init(&p00_e->p00_it);
+    atomic_init(&p00_e->p00_tail, (p00_event_seg*)0);
+    atomic_init(&p00_e->p00_head, (p00_event_seg*)0);
+    atomic_init(&p00_e->p00_all, (p00_event_seg*)0);
+    atomic_init(&p00_e->p00_busy, 0u);
+    p99_lifo_init(&p00_e->p00_retired, 0);
+    p99_lifo_init(&p00_e->p00_free, 0);
+    p00_event_seg* p00_s = p00_event_seg_new(p00_e);
+    if (!p00_s) return 0;
+    unsigned const p00_m = p00_n/P99_EVENT_SEGMENT + !!(p00_n % P99_EVENT_SEGMENT);
+    for (unsigned p00_i = 1; p00_i < p00_m; ++p00_i) {
+      p00_event_seg* p00_f = p00_event_seg_new(p00_e);
+      if (!p00_f) break;
+      P99_LIFO_PUSH(&p00_e->p00_free, p00_f);
+    }
+    atomic_store(&p00_e->p00_tail, p00_s);
+    atomic_store(&p00_e->p00_head, p00_s);
   }
   return p00_e;
 }
 
+#ifndef DOXYGEN
+#define p99_event_init(...) P99_CALL_DEFARG(p99_event_init, 2, __VA_ARGS__)
+#define p99_event_init_defarg_1() P99_EVENT_SEGMENT
+#endif
+
 /**
- ** @brief destroy an event
+ ** @brief destroy an event log
+ **
+ ** @warning No thread may still be using @a p00_e.
  ** @related p99_event
  **/
 p99_inline
 void p99_event_destroy(p99_event* p00_e) {
   if (p00_e) {
-    free(p00_e->p00_event);
-    p99_iterator_destroy(&p00_e->p00_it);
+    for (p00_event_seg* p00_s = atomic_load(&p00_e->p00_all); p00_s;) {
+      p00_event_seg* p00_n = p00_s->p00_all;
+      for (unsigned p00_i = 0; p00_i < P99_EVENT_SEGMENT; ++p00_i)
+        p99_futex_destroy(&p00_s->p00_slot[p00_i].p00_ready);
+      free(p00_s);
+      p00_s = p00_n;
+    }
+    atomic_store(&p00_e->p00_all, (p00_event_seg*)0);
+    atomic_store(&p00_e->p00_tail, (p00_event_seg*)0);
+    atomic_store(&p00_e->p00_head, (p00_event_seg*)0);
   }
 }
 
 /**
  ** @brief Block until an event has been signaled that has not yet
- ** been accounted for
+ ** been accounted for, and return the corresponding pointer
  **
  ** Non blocking if enough events already have been signaled.
  **
+ ** @return the pointer that was passed to ::p99_event_signal, or @c
+ ** 0 if a new segment of the log could not be allocated.
  ** @related p99_event
  **/
 P99_DEFARG_DOCU(p99_event_next)
 P00_FUTEX_INLINE(p99_event_next)
 void* p99_event_next(p99_event volatile* p00_e) {
-  P99_FPRINTF(stderr, "next event on %s\n", (void*)p00_e);
-  unsigned p00_pos = p99_iterator_next(&p00_e->p00_it);
-  void* p00_ret = 0;
-  if (p00_pos < p00_e->p00_n)
-    while (!(p00_ret = p00_e->p00_event[p00_pos]));
-  P99_FPRINTF(stderr, "next event on %s, returns %s pos %s\n", (void*)p00_e, p00_ret, p00_pos);
+  p00_event_seg* p00_s = 0;
+  p00_event_slot* p00_sl = p00_event_claim(p00_e, false, &p00_s);
+  if (!p00_sl) return 0;
+  if (p99_futex_load(&p00_sl->p00_ready) != p00_event_ready) {
+    /* Announce that we will wait, unless the producer came in between. */
+    P99_FUTEX_COMPARE_EXCHANGE(&p00_sl->p00_ready, p00_act,
+                               /* never wait */
+                               true,
+                               (p00_act == p00_event_empty) ? p00_event_waiting : p00_act,
+                               /* never wakeup others */
+                               0u, 0u);
+    P99_FUTEX_COMPARE_EXCHANGE(&p00_sl->p00_ready, p00_act,
+                               /* wait for the producer */
+                               (p00_act == p00_event_ready),
+                               /* never update */
+                               p00_act,
+                               /* never wakeup others */
+                               0u, 0u);
+  }
+  void* p00_ret = p00_sl->p00_ptr;
+  if (atomic_fetch_add(&p00_s->p00_done, 1u) + 1u == P99_EVENT_SEGMENT)
+    p00_event_retire(p00_e, p00_s);
   return p00_ret;
 }
 
 /**
- ** @brief Signal the event. @a p00_w
+ ** @brief Signal the event @a p00_w.
  **
+ ** @return ::thrd_success, or ::thrd_nomem if a new segment of the
+ ** log could not be allocated.
  ** @related p99_event
  **/
 P99_DEFARG_DOCU(p99_event_signal)
-p99_inline
-void p99_event_signal(p99_event volatile* p00_e, void * p00_w) {
+P00_FUTEX_INLINE(p99_event_signal)
+int p99_event_signal(p99_event volatile* p00_e, void * p00_w) {
   if (p00_e) {
-    unsigned p00_ret = p99_iterator_signal(&p00_e->p00_it);
-    p00_e->p00_event[p00_ret] = p00_w;
+    p00_event_seg* p00_s = 0;
+    p00_event_slot* p00_sl = p00_event_claim(p00_e, true, &p00_s);
+    if (!p00_sl) return thrd_nomem;
+    p00_sl->p00_ptr = p00_w;
+    P99_FUTEX_COMPARE_EXCHANGE(&p00_sl->p00_ready, p00_act,
+                               /* never wait */
+                               true,
+                               p00_event_ready,
+                               /* only wake up the consumer if it
+                                  is already waiting */
+                               0u, (p00_act == p00_event_waiting));
   }
+  return thrd_success;
 }
 
 
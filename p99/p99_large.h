@@ -0,0 +1,246 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_LARGE_H
+#define P99_LARGE_H 1
+
+#include "p99_for.h"
+#include "p99_topology.h"
+#include <sys/mman.h>
+
+/**
+ ** @addtogroup large Large allocations
+ **
+ ** Arrays of several GiB that are allocated with @c malloc use the
+ ** normal page size of the system, so a sweep over them misses the
+ ** TLB about once every few KiB. Also, all pages are first touched by
+ ** the thread that initializes the array, which serializes the page
+ ** faults and places all of the memory on the NUMA node of that
+ ** thread.
+ **
+ ** ::p99_large_alloc maps such an array directly and aligns it to
+ ** ::P99_LARGE_ALIGN, such that the system may back it with
+ ** transparent huge pages. It may also touch the pages in parallel
+ ** with one thread per slice. A later parallel computation that uses
+ ** the same slices then finds its data on its local node.
+ **
+ ** @code
+ ** double (*grid)[n][m] = p99_large_alloc(sizeof(double[n][m]));
+ ** // a second grid of the same shape
+ ** double (*next)[n][m] = P99_AALLOC_LARGE(double, grid, 2);
+ ** .
+ ** p99_large_free(next);
+ ** p99_large_free(grid);
+ ** @endcode
+ ** @{
+ **/
+
+/**
+ ** @brief The alignment of the allocations of ::p99_large_alloc.
+ **
+ ** This is the size of a huge page on the common platforms.
+ **/
+#ifndef P99_LARGE_ALIGN
+# define P99_LARGE_ALIGN (2u*1024u*1024u)
+#endif
+
+/**
+ ** @brief The minimal size of the slice that is touched by one thread.
+ **/
+#ifndef P99_LARGE_SLICE
+# define P99_LARGE_SLICE (64u*1024u*1024u)
+#endif
+
+/**
+ ** @brief Flag for ::p99_large_alloc to advise the system to use huge
+ ** pages.
+ **/
+#define P99_LARGE_HUGE 1u
+
+/**
+ ** @brief Flag for ::p99_large_alloc to touch all pages before
+ ** returning, in parallel if the allocation is large enough.
+ **/
+#define P99_LARGE_TOUCH 2u
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+# define MAP_ANONYMOUS MAP_ANON
+#endif
+
+P99_DECLARE_STRUCT(p00_large_head);
+
+/* Placed just before the user data. */
+struct p00_large_head {
+  void* p00_base;
+  size_t p00_len;
+};
+
+P99_DECLARE_STRUCT(p00_large_slice);
+
+struct p00_large_slice {
+  unsigned char* p00_p;
+  size_t p00_len;
+  size_t p00_step;
+};
+
+P99_WEAK(p00_large_touch_slice)
+int p00_large_touch_slice(void* p00_arg) {
+  p00_large_slice const* p00_s = p00_arg;
+  unsigned char volatile* p00_p = p00_s->p00_p;
+  for (size_t p00_i = 0; p00_i < p00_s->p00_len; p00_i += p00_s->p00_step)
+    p00_p[p00_i] = 0;
+  return 0;
+}
+
+/* Cut the range into slices that are multiples of P99_LARGE_ALIGN,
+   such that each huge page is touched by exactly one thread. */
+p99_inline
+void p00_large_touch(unsigned char* p00_p, size_t p00_len, size_t p00_step) {
+  size_t p00_n = p99_topology_get()->p99_cpus;
+  if (p00_n > p00_len/P99_LARGE_SLICE) p00_n = p00_len/P99_LARGE_SLICE;
+  if (p00_n < 2) {
+    p00_large_touch_slice(&(p00_large_slice){ .p00_p = p00_p, .p00_len = p00_len, .p00_step = p00_step, });
+    return;
+  }
+  size_t p00_sl = p00_len/p00_n;
+  p00_sl = (p00_sl + P99_LARGE_ALIGN - 1) & ~(size_t)(P99_LARGE_ALIGN - 1);
+  p00_large_slice p00_s[p00_n];
+  thrd_t p00_id[p00_n];
+  bool p00_run[p00_n];
+  for (size_t p00_i = 0; p00_i < p00_n; ++p00_i) {
+    size_t p00_off = p00_i*p00_sl;
+    if (p00_off > p00_len) p00_off = p00_len;
+    p00_s[p00_i] = (p00_large_slice) {
+      .p00_p = p00_p + p00_off,
+      .p00_len = (p00_len - p00_off < p00_sl) ? p00_len - p00_off : p00_sl,
+      .p00_step = p00_step,
+    };
+    /* The first slice is done by the calling thread, and so is any
+       slice for which no thread could be created. */
+    p00_run[p00_i] = p00_i && thrd_create(&p00_id[p00_i], p00_large_touch_slice, &p00_s[p00_i]) == thrd_success;
+  }
+  for (size_t p00_i = 0; p00_i < p00_n; ++p00_i)
+    if (!p00_run[p00_i]) p00_large_touch_slice(&p00_s[p00_i]);
+  for (size_t p00_i = 1; p00_i < p00_n; ++p00_i)
+    if (p00_run[p00_i]) thrd_join(p00_id[p00_i], 0);
+}
+
+/**
+ ** @brief Allocate @a p00_size bytes that are aligned to
+ ** ::P99_LARGE_ALIGN and initialized to zero.
+ **
+ ** @param p00_flags is a combination of ::P99_LARGE_HUGE and
+ ** ::P99_LARGE_TOUCH, and defaults to both.
+ **
+ ** The memory is mapped directly from the system. With
+ ** ::P99_LARGE_HUGE the size of the mapping is rounded up to a
+ ** multiple of ::P99_LARGE_ALIGN and the system is advised to use
+ ** transparent huge pages. With ::P99_LARGE_TOUCH all pages are
+ ** touched before the function returns, by several threads if @a
+ ** p00_size is at least twice ::P99_LARGE_SLICE.
+ **
+ ** @return a pointer to the new memory or a null pointer if it could
+ ** not be allocated. It must be freed with ::p99_large_free.
+ **/
+P99_DEFARG_DOCU(p99_large_alloc)
+p99_inline
+void* p99_large_alloc(size_t p00_size, unsigned p00_flags) {
+  size_t const p00_page = sysconf(_SC_PAGESIZE);
+  size_t const p00_gran = (p00_flags & P99_LARGE_HUGE) ? P99_LARGE_ALIGN : p00_page;
+  if (p00_size > SIZE_MAX - 2*P99_LARGE_ALIGN - p00_page) return 0;
+  size_t const p00_len = (p00_size + p00_gran - 1) & ~(p00_gran - 1);
+  unsigned char* p00_base;
+  unsigned char* p00_ret;
+#ifdef MAP_ANONYMOUS
+  /* One page in front for the head, and the slack for the alignment. */
+  size_t const p00_total = p00_page + p00_len + P99_LARGE_ALIGN;
+  p00_base = mmap(0, p00_total, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if (p00_base == MAP_FAILED) return 0;
+  p00_ret = (unsigned char*)(((uintptr_t)p00_base + p00_page + P99_LARGE_ALIGN - 1) & ~(uintptr_t)(P99_LARGE_ALIGN - 1));
+  /* Give back the slack on both sides. */
+  unsigned char* p00_start = p00_ret - p00_page;
+  unsigned char* p00_end = p00_ret + p00_len;
+  if (p00_start > p00_base) munmap(p00_base, p00_start - p00_base);
+  if (p00_end < p00_base + p00_total) munmap(p00_end, p00_base + p00_total - p00_end);
+  p00_base = p00_start;
+# ifdef MADV_HUGEPAGE
+  if (p00_flags & P99_LARGE_HUGE) madvise(p00_ret, p00_len, MADV_HUGEPAGE);
+# endif
+#else
+  /* Without anonymous mappings fall back to the C library. The size
+     for aligned_alloc must be a multiple of the alignment. */
+  size_t const p00_asize
+    = ((p00_len + P99_LARGE_ALIGN - 1) & ~(size_t)(P99_LARGE_ALIGN - 1)) + P99_LARGE_ALIGN;
+# if __STDC_VERSION__ >= 201112L
+  p00_base = aligned_alloc(P99_LARGE_ALIGN, p00_asize);
+# else
+  void* p00_mem = 0;
+  p00_base = posix_memalign(&p00_mem, P99_LARGE_ALIGN, p00_asize) ? 0 : p00_mem;
+# endif
+  if (!p00_base) return 0;
+  p00_ret = p00_base + P99_LARGE_ALIGN;
+  memset(p00_ret, 0, p00_size);
+#endif
+  ((p00_large_head*)p00_ret)[-1] = (p00_large_head) {
+    .p00_base = p00_base,
+    .p00_len = p00_page + p00_len,
+  };
+  if (p00_flags & P99_LARGE_TOUCH) p00_large_touch(p00_ret, p00_size, p00_page);
+  return p00_ret;
+}
+
+#ifndef DOXYGEN
+#define p99_large_alloc(...) P99_CALL_DEFARG(p99_large_alloc, 2, __VA_ARGS__)
+#define p99_large_alloc_defarg_1() (P99_LARGE_HUGE|P99_LARGE_TOUCH)
+#endif
+
+/**
+ ** @brief Free memory that has been allocated with ::p99_large_alloc.
+ **/
+p99_inline
+void p99_large_free(void* p00_p) {
+  if (!p00_p) return;
+  p00_large_head const p00_h = ((p00_large_head*)p00_p)[-1];
+#ifdef MAP_ANONYMOUS
+  munmap(p00_h.p00_base, p00_h.p00_len);
+#else
+  free(p00_h.p00_base);
+#endif
+}
+
+#define P00_AALLOC_LARGE(...) ((__VA_ARGS__)p99_large_alloc(sizeof *(__VA_ARGS__){ 0 }))
+
+/**
+ ** @brief Allocate a new matrix of base type @a T and with @a N
+ ** dimensions as given by @a VB with ::p99_large_alloc.
+ **
+ ** This is the analogue of ::P99_AALLOC. The matrix is aligned to
+ ** ::P99_LARGE_ALIGN and initialized to zero, and must be freed with
+ ** ::p99_large_free.
+ **/
+P00_DOCUMENT_TYPE_ARGUMENT(P99_AALLOC_LARGE, 0)
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_AALLOC_LARGE, 1)
+#define P99_AALLOC_LARGE(T, VB, N) P00_AALLOC_LARGE(P99_ATYPE(T, , VB, N))
+
+/**
+ ** @}
+ **/
+
+#endif
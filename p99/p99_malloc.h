@@ -0,0 +1,340 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_MALLOC_H
+#define P99_MALLOC_H 1
+
+#include "p99_arith.h"
+#include "p99_lifo.h"
+#include "p99_tss.h"
+
+/**
+ ** @addtogroup malloc A scalable allocator for small objects
+ **
+ ** ::p99_malloc, ::p99_calloc, ::p99_realloc and ::p99_free are a
+ ** replacement of the C library functions that behaves predictably
+ ** when many threads allocate at the same time.
+ **
+ ** Requests up to ::P99_MALLOC_MAX bytes are rounded up to one of 40
+ ** size classes, four per power of two. Each thread keeps a cache of
+ ** free blocks per size class, so most allocations and deallocations
+ ** don't use any atomic operation. Blocks move between the caches of
+ ** the threads and a central depot in batches, with one operation on
+ ** an atomic LIFO per batch. So a thread that frees blocks that
+ ** another thread has allocated, e.g in a producer-consumer setting,
+ ** hands them back in bulk.
+ **
+ ** The memory for the blocks is taken from the C library in chunks of
+ ** ::P99_MALLOC_CHUNK bytes. Chunks are never given back, so the
+ ** memory that is used by the allocator is bounded by the peak of
+ ** the memory that has been in use. Larger requests are forwarded to
+ ** the C library.
+ **
+ ** All blocks carry a header, so only pointers that have been
+ ** returned by these functions may be passed to ::p99_free and
+ ** ::p99_realloc, and these may not be passed to @c free.
+ **
+ ** If ::P99_SCALABLE_MALLOC is defined before any P99 header is
+ ** included, the allocation macros such as ::P99_NEW, ::P99_MALLOC
+ ** or ::P99_CALLOC use this allocator.
+ ** @{
+ **/
+
+/**
+ ** @brief The maximal number of blocks that are moved between a
+ ** thread and the depot at once.
+ **/
+#ifndef P99_MALLOC_BATCH
+# define P99_MALLOC_BATCH 64u
+#endif
+
+/**
+ ** @brief The size of the chunks that are taken from the C library.
+ **/
+#ifndef P99_MALLOC_CHUNK
+# define P99_MALLOC_CHUNK (256u*1024u)
+#endif
+
+/**
+ ** @brief The largest request that is served from a size class.
+ **/
+#define P99_MALLOC_MAX 32768u
+
+enum {
+  /* classes 0 to 7 are the multiples of 16 up to 128, the others
+     divide each power of two from 128 up to P99_MALLOC_MAX into four */
+  p00_malloc_small = 8,
+  p00_malloc_classes = p00_malloc_small + 4*8,
+};
+
+/* The header of each block. It keeps the alignment of max_align_t
+   for the user data that follows. */
+typedef union p00_mhead p00_mhead;
+
+union p00_mhead {
+  max_align_t p00_align;
+  struct {
+    size_t p00_class;
+    /* only used for blocks from the C library */
+    size_t p00_size;
+  } p00_h;
+};
+
+/* A free block. The first block of a batch also holds the size of
+   the batch and the link to the next batch in the depot. */
+P99_DECLARE_STRUCT(p00_mblock);
+P99_POINTER_TYPE(p00_mblock);
+P99_LIFO_DECLARE(p00_mblock_ptr);
+
+struct p00_mblock {
+  p00_mblock_ptr p99_lifo;
+  p00_mblock* p00_next;
+  size_t p00_n;
+};
+
+P99_WEAK(p00_malloc_depot)
+P99_LIFO(p00_mblock_ptr) p00_malloc_depot[p00_malloc_classes];
+
+struct p00_malloc_cache {
+  p00_mblock* p00_head[p00_malloc_classes];
+  size_t p00_n[p00_malloc_classes];
+};
+
+P99_CONST_FUNCTION
+p99_inline
+size_t p00_malloc_class(size_t p00_s) {
+  if (p00_s <= 128) return p00_s ? (p00_s - 1)/16 : 0;
+  /* 2^k < s <= 2^(k+1) */
+  register size_t const p00_k = p99_arith_log2(p00_s - 1);
+  register size_t const p00_step = (size_t)1 << (p00_k - 2);
+  return p00_malloc_small + (p00_k - 7)*4
+    + (p00_s - ((size_t)1 << p00_k) + p00_step - 1)/p00_step - 1;
+}
+
+P99_CONST_FUNCTION
+p99_inline
+size_t p00_malloc_size(size_t p00_c) {
+  if (p00_c < p00_malloc_small) return (p00_c + 1)*16;
+  register size_t const p00_j = p00_c - p00_malloc_small;
+  register size_t const p00_k = 7 + p00_j/4;
+  return ((size_t)1 << p00_k) + (p00_j%4 + 1)*((size_t)1 << (p00_k - 2));
+}
+
+/* The number of blocks in a batch, such that a thread doesn't hold
+   more than about a quarter of a chunk per class. */
+P99_CONST_FUNCTION
+p99_inline
+size_t p00_malloc_batch(size_t p00_c) {
+  register size_t const p00_n = P99_MALLOC_CHUNK/(4*(sizeof(p00_mhead) + p00_malloc_size(p00_c)));
+  return (p00_n < 1) ? 1 : ((p00_n > P99_MALLOC_BATCH) ? P99_MALLOC_BATCH : p00_n);
+}
+
+/* Detach the first p00_n blocks of the cache for class p00_c and
+   push them to the depot. */
+p99_inline
+void p00_malloc_release(struct p00_malloc_cache* p00_cache, size_t p00_c, size_t p00_n) {
+  p00_mblock* p00_h = p00_cache->p00_head[p00_c];
+  p00_mblock* p00_t = p00_h;
+  for (size_t p00_i = 1; p00_i < p00_n; ++p00_i) p00_t = p00_t->p00_next;
+  p00_cache->p00_head[p00_c] = p00_t->p00_next;
+  p00_cache->p00_n[p00_c] -= p00_n;
+  p00_t->p00_next = 0;
+  p00_h->p00_n = p00_n;
+  P99_LIFO_PUSH(&p00_malloc_depot[p00_c], p00_h);
+}
+
+p99_inline
+void p00_malloc_flush(struct p00_malloc_cache* p00_cache) {
+  for (size_t p00_c = 0; p00_c < p00_malloc_classes; ++p00_c) {
+    register size_t const p00_b = p00_malloc_batch(p00_c);
+    while (p00_cache->p00_n[p00_c])
+      p00_malloc_release(p00_cache, p00_c,
+                         (p00_cache->p00_n[p00_c] < p00_b) ? p00_cache->p00_n[p00_c] : p00_b);
+  }
+}
+
+P99_WEAK(p00_malloc_exit)
+void p00_malloc_exit(void* p00_cache) {
+  p00_malloc_flush(p00_cache);
+  free(p00_cache);
+}
+
+P99_TSS_DECLARE_LOCAL(struct p00_malloc_cache, p00_malloc_cache, p00_malloc_exit);
+
+/* Cut a new chunk into batches for class p00_c. All but the first
+   batch go to the depot. */
+p99_inline
+p00_mblock* p00_malloc_carve(size_t p00_c) {
+  register size_t const p00_bs = sizeof(p00_mhead) + p00_malloc_size(p00_c);
+  register size_t const p00_b = p00_malloc_batch(p00_c);
+  size_t p00_nb = P99_MALLOC_CHUNK/p00_bs;
+  if (p00_nb < p00_b) p00_nb = p00_b;
+  unsigned char* p00_chunk = malloc(p00_nb*p00_bs);
+  if (!p00_chunk) return 0;
+  p00_mblock* p00_ret = 0;
+  for (size_t p00_i = 0; p00_i < p00_nb; p00_i += p00_b) {
+    register size_t const p00_n = (p00_nb - p00_i < p00_b) ? p00_nb - p00_i : p00_b;
+    p00_mblock* p00_h = (p00_mblock*)(p00_chunk + p00_i*p00_bs);
+    for (size_t p00_j = 0; p00_j < p00_n; ++p00_j) {
+      p00_mblock* p00_e = (p00_mblock*)(p00_chunk + (p00_i + p00_j)*p00_bs);
+      p00_e->p00_next = (p00_j + 1 < p00_n) ? (p00_mblock*)((unsigned char*)p00_e + p00_bs) : 0;
+    }
+    p00_h->p00_n = p00_n;
+    if (!p00_ret) p00_ret = p00_h;
+    else P99_LIFO_PUSH(&p00_malloc_depot[p00_c], p00_h);
+  }
+  return p00_ret;
+}
+
+/* Blocks that don't fit into a class come from the C library. */
+p99_inline
+void* p00_malloc_large(size_t p00_size) {
+  if (p00_size > SIZE_MAX - sizeof(p00_mhead)) return 0;
+  p00_mhead* p00_h = malloc(sizeof *p00_h + p00_size);
+  if (!p00_h) return 0;
+  p00_h->p00_h.p00_class = p00_malloc_classes;
+  p00_h->p00_h.p00_size = p00_size;
+  return p00_h + 1;
+}
+
+/**
+ ** @brief Allocate @a p00_size bytes, analogous to @c malloc.
+ **
+ ** The returned pointer must be freed with ::p99_free.
+ **/
+p99_inline
+void* p99_malloc(size_t p00_size) {
+  if (P99_UNLIKELY(p00_size > P99_MALLOC_MAX)) return p00_malloc_large(p00_size);
+  register size_t const p00_c = p00_malloc_class(p00_size);
+  struct p00_malloc_cache* p00_cache = &P99_TSS_LOCAL(p00_malloc_cache);
+  if (P99_UNLIKELY(!p00_cache)) return p00_malloc_large(p00_size);
+  p00_mblock* p00_b = p00_cache->p00_head[p00_c];
+  if (P99_UNLIKELY(!p00_b)) {
+    /* Take a whole batch from the depot or from a new chunk. */
+    p00_b = P99_LIFO_POP(&p00_malloc_depot[p00_c]);
+    if (!p00_b) p00_b = p00_malloc_carve(p00_c);
+    if (!p00_b) return 0;
+    p00_cache->p00_n[p00_c] = p00_b->p00_n;
+  }
+  p00_cache->p00_head[p00_c] = p00_b->p00_next;
+  --p00_cache->p00_n[p00_c];
+  p00_mhead* p00_h = (p00_mhead*)p00_b;
+  p00_h->p00_h.p00_class = p00_c;
+  return p00_h + 1;
+}
+
+/**
+ ** @brief Free a block that has been allocated with ::p99_malloc,
+ ** ::p99_calloc or ::p99_realloc, analogous to @c free.
+ **
+ ** The block goes to the cache of the calling thread, which need not
+ ** be the thread that allocated it.
+ **/
+p99_inline
+void p99_free(void* p00_p) {
+  if (!p00_p) return;
+  p00_mhead* p00_h = (p00_mhead*)p00_p - 1;
+  register size_t const p00_c = p00_h->p00_h.p00_class;
+  if (p00_c >= p00_malloc_classes) {
+    free(p00_h);
+    return;
+  }
+  p00_mblock* p00_b = (p00_mblock*)p00_h;
+  struct p00_malloc_cache* p00_cache = &P99_TSS_LOCAL(p00_malloc_cache);
+  if (P99_UNLIKELY(!p00_cache)) {
+    /* a batch of one */
+    p00_b->p00_next = 0;
+    p00_b->p00_n = 1;
+    P99_LIFO_PUSH(&p00_malloc_depot[p00_c], p00_b);
+    return;
+  }
+  p00_b->p00_next = p00_cache->p00_head[p00_c];
+  p00_cache->p00_head[p00_c] = p00_b;
+  /* Keep one batch for future allocations and give one back. */
+  register size_t const p00_n = p00_malloc_batch(p00_c);
+  if (P99_UNLIKELY(++p00_cache->p00_n[p00_c] >= 2*p00_n))
+    p00_malloc_release(p00_cache, p00_c, p00_n);
+}
+
+/**
+ ** @brief Allocate and zero an array of @a p00_nb elements of @a
+ ** p00_size bytes each, analogous to @c calloc.
+ **/
+p99_inline
+void* p99_calloc(size_t p00_nb, size_t p00_size) {
+  if (p00_size && p00_nb > SIZE_MAX/p00_size) return 0;
+  void* p00_ret = p99_malloc(p00_nb*p00_size);
+  if (p00_ret) memset(p00_ret, 0, p00_nb*p00_size);
+  return p00_ret;
+}
+
+/**
+ ** @brief Change the size of the block @a p00_p to @a p00_size bytes,
+ ** analogous to @c realloc.
+ **
+ ** If the new size falls into the same size class, the block is not
+ ** moved.
+ **/
+p99_inline
+void* p99_realloc(void* p00_p, size_t p00_size) {
+  if (!p00_p) return p99_malloc(p00_size);
+  p00_mhead* p00_h = (p00_mhead*)p00_p - 1;
+  register size_t const p00_c = p00_h->p00_h.p00_class;
+  size_t p00_old;
+  if (p00_c >= p00_malloc_classes) {
+    if (p00_size > P99_MALLOC_MAX) {
+      if (p00_size > SIZE_MAX - sizeof(p00_mhead)) return 0;
+      p00_h = realloc(p00_h, sizeof *p00_h + p00_size);
+      if (!p00_h) return 0;
+      p00_h->p00_h.p00_size = p00_size;
+      return p00_h + 1;
+    }
+    p00_old = p00_h->p00_h.p00_size;
+  } else {
+    if (p00_size <= P99_MALLOC_MAX && p00_malloc_class(p00_size) == p00_c) return p00_p;
+    p00_old = p00_malloc_size(p00_c);
+  }
+  void* p00_ret = p99_malloc(p00_size);
+  if (p00_ret) {
+    memcpy(p00_ret, p00_p, (p00_old < p00_size) ? p00_old : p00_size);
+    p99_free(p00_p);
+  }
+  return p00_ret;
+}
+
+/**
+ ** @brief Give all blocks in the cache of the calling thread back to
+ ** the depot.
+ **
+ ** This is done automatically when a thread exits. A thread that
+ ** has freed many blocks and will not allocate for a while may call
+ ** this, such that other threads can use the blocks.
+ **/
+p99_inline
+void p99_malloc_flush(void) {
+  struct p00_malloc_cache* p00_cache = &P99_TSS_LOCAL(p00_malloc_cache);
+  if (p00_cache) p00_malloc_flush(p00_cache);
+}
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -0,0 +1,551 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_MSORT_H
+#define P99_MSORT_H 1
+
+#include "p99_qsort.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+P99_DECLARE_STRUCT(p00_msort);
+
+/* A run that is waiting to be merged. */
+struct p00_msort {
+  size_t bot;
+  size_t len;
+};
+
+/* Runs that are shorter than a value between this and its double are
+   extended by insertion. */
+#define P00_MSORT_MINRUN 32u
+
+/* The initial number of consecutive wins of one run that switches a
+   merge into galloping mode. */
+#define P00_MSORT_GALLOP 7u
+
+/* Copy element S to element D, both lvalues of the element type. */
+#define P00_MCOPY_ASSIGN(D, S) ((D) = (S))
+
+#define P00_MCOPY_VCPY(D, S) do { P00_QSWAP_VCPY_(D, S); } while (false)
+
+#define P00_MCOPY_MEMCPY(D, S) memcpy(&(D), &(S), p00_s)
+
+#define P00_MCOMP(X, Y) p00_comp(&(X), &(Y), p00_ctx)
+
+/* X comes before or is equal to Y */
+#define P00_MLE(X, Y) (!(P00_MCOMP(Y, X) < 0))
+
+/* X comes strictly before Y */
+#define P00_MLT(X, Y) (P00_MCOMP(X, Y) < 0)
+
+/* Set K to the number of leading elements x of the sorted array A of
+   length L for which PRED(x, KEY) holds. The search starts with
+   exponentially growing steps from the left end. */
+#define P00_MGALLOP_L(A, L, PRED, KEY, K)                                       \
+do {                                                                            \
+  register size_t const p00Gl = (L);                                            \
+  register size_t p00Glo = 0;                                                   \
+  register size_t p00Ghi = p00Gl;                                               \
+  for (register size_t p00Gst = 1; p00Gst <= p00Gl; p00Gst *= 2) {              \
+    if (!PRED((A)[p00Gst - 1], KEY)) {                                          \
+      p00Ghi = p00Gst - 1;                                                      \
+      break;                                                                    \
+    }                                                                           \
+    p00Glo = p00Gst;                                                            \
+  }                                                                             \
+  while (p00Glo < p00Ghi) {                                                     \
+    register size_t const p00Gm = p00Glo + (p00Ghi - p00Glo)/2;                 \
+    if (PRED((A)[p00Gm], KEY)) p00Glo = p00Gm + 1;                              \
+    else p00Ghi = p00Gm;                                                        \
+  }                                                                             \
+  (K) = p00Glo;                                                                 \
+ } while (false)
+
+/* The same as P00_MGALLOP_L, only that the search starts from the
+   right end. */
+#define P00_MGALLOP_R(A, L, PRED, KEY, K)                                       \
+do {                                                                            \
+  register size_t const p00Gl = (L);                                            \
+  register size_t p00Glo = 0;                                                   \
+  register size_t p00Ghi = p00Gl;                                               \
+  for (register size_t p00Gst = 1; p00Gst <= p00Gl; p00Gst *= 2) {              \
+    if (PRED((A)[p00Gl - p00Gst], KEY)) {                                       \
+      p00Glo = p00Gl - p00Gst + 1;                                              \
+      break;                                                                    \
+    }                                                                           \
+    p00Ghi = p00Gl - p00Gst;                                                    \
+  }                                                                             \
+  while (p00Glo < p00Ghi) {                                                     \
+    register size_t const p00Gm = p00Glo + (p00Ghi - p00Glo)/2;                 \
+    if (PRED((A)[p00Gm], KEY)) p00Glo = p00Gm + 1;                              \
+    else p00Ghi = p00Gm;                                                        \
+  }                                                                             \
+  (K) = p00Glo;                                                                 \
+ } while (false)
+
+/* Merge the adjacent runs [A, A+NA) and [A+NA, A+NA+NB) by copying
+   the left one to the scratch buffer and filling from the left. */
+#define P00_MMERGE_LO(COPY, A, NA, NB)                                          \
+do {                                                                            \
+  register size_t const p00Una = (NA);                                          \
+  register size_t const p00Uend = (A) + p00Una + (NB);                          \
+  register size_t p00Ud = (A);                                                  \
+  register size_t p00Ui = 0;                                                    \
+  register size_t p00Uj = (A) + p00Una;                                         \
+  for (register size_t p00Uk = 0; p00Uk < p00Una; ++p00Uk)                      \
+    COPY(p00_W[p00Uk], p00_B[p00Ud + p00Uk]);                                   \
+  while (p00Ui < p00Una && p00Uj < p00Uend) {                                   \
+    register size_t p00Uca = 0;                                                 \
+    register size_t p00Ucb = 0;                                                 \
+    /* one element at a time, until one run wins often enough */                \
+    do {                                                                        \
+      if (P00_MLT(p00_B[p00Uj], p00_W[p00Ui])) {                                \
+        COPY(p00_B[p00Ud], p00_B[p00Uj]);                                       \
+        ++p00Ud;                                                                \
+        ++p00Uj;                                                                \
+        ++p00Ucb;                                                               \
+        p00Uca = 0;                                                             \
+      } else {                                                                  \
+        COPY(p00_B[p00Ud], p00_W[p00Ui]);                                       \
+        ++p00Ud;                                                                \
+        ++p00Ui;                                                                \
+        ++p00Uca;                                                               \
+        p00Ucb = 0;                                                             \
+      }                                                                         \
+    } while (p00Ui < p00Una && p00Uj < p00Uend && (p00Uca | p00Ucb) < p00_gallop); \
+    if (p00Ui == p00Una || p00Uj == p00Uend) break;                             \
+    /* galloping, copy whole blocks of each run */                              \
+    ++p00_gallop;                                                               \
+    do {                                                                        \
+      p00_gallop -= (p00_gallop > 1);                                           \
+      P00_MGALLOP_L(p00_W + p00Ui, p00Una - p00Ui, P00_MLE, p00_B[p00Uj], p00Uca); \
+      for (register size_t p00Uk = 0; p00Uk < p00Uca; ++p00Uk) {                \
+        COPY(p00_B[p00Ud], p00_W[p00Ui]);                                       \
+        ++p00Ud;                                                                \
+        ++p00Ui;                                                                \
+      }                                                                         \
+      if (p00Ui == p00Una) break;                                               \
+      COPY(p00_B[p00Ud], p00_B[p00Uj]);                                         \
+      ++p00Ud;                                                                  \
+      ++p00Uj;                                                                  \
+      if (p00Uj == p00Uend) break;                                              \
+      P00_MGALLOP_L(p00_B + p00Uj, p00Uend - p00Uj, P00_MLT, p00_W[p00Ui], p00Ucb); \
+      for (register size_t p00Uk = 0; p00Uk < p00Ucb; ++p00Uk) {                \
+        COPY(p00_B[p00Ud], p00_B[p00Uj]);                                       \
+        ++p00Ud;                                                                \
+        ++p00Uj;                                                                \
+      }                                                                         \
+      if (p00Uj == p00Uend) break;                                              \
+      COPY(p00_B[p00Ud], p00_W[p00Ui]);                                         \
+      ++p00Ud;                                                                  \
+      ++p00Ui;                                                                  \
+      if (p00Ui == p00Una) break;                                               \
+    } while (p00Uca >= P00_MSORT_GALLOP || p00Ucb >= P00_MSORT_GALLOP);         \
+    p00_gallop += 2;                                                            \
+  }                                                                             \
+  /* the rest of the right run is already in place */                           \
+  while (p00Ui < p00Una) {                                                      \
+    COPY(p00_B[p00Ud], p00_W[p00Ui]);                                           \
+    ++p00Ud;                                                                    \
+    ++p00Ui;                                                                    \
+  }                                                                             \
+ } while (false)
+
+/* Merge the adjacent runs [A, A+NA) and [A+NA, A+NA+NB) by copying
+   the right one to the scratch buffer and filling from the right. */
+#define P00_MMERGE_HI(COPY, A, NA, NB)                                          \
+do {                                                                            \
+  register size_t const p00Ua = (A);                                            \
+  register size_t const p00Unb = (NB);                                          \
+  register size_t p00Ud = p00Ua + (NA) + p00Unb;                                \
+  register size_t p00Ui = p00Ua + (NA);                                         \
+  register size_t p00Uj = p00Unb;                                               \
+  for (register size_t p00Uk = 0; p00Uk < p00Unb; ++p00Uk)                      \
+    COPY(p00_W[p00Uk], p00_B[p00Ui + p00Uk]);                                   \
+  while (p00Ui > p00Ua && p00Uj > 0) {                                          \
+    register size_t p00Uca = 0;                                                 \
+    register size_t p00Ucb = 0;                                                 \
+    do {                                                                        \
+      if (P00_MLT(p00_W[p00Uj - 1], p00_B[p00Ui - 1])) {                        \
+        --p00Ud;                                                                \
+        --p00Ui;                                                                \
+        COPY(p00_B[p00Ud], p00_B[p00Ui]);                                       \
+        ++p00Uca;                                                               \
+        p00Ucb = 0;                                                             \
+      } else {                                                                  \
+        --p00Ud;                                                                \
+        --p00Uj;                                                                \
+        COPY(p00_B[p00Ud], p00_W[p00Uj]);                                       \
+        ++p00Ucb;                                                               \
+        p00Uca = 0;                                                             \
+      }                                                                         \
+    } while (p00Ui > p00Ua && p00Uj > 0 && (p00Uca | p00Ucb) < p00_gallop);     \
+    if (p00Ui == p00Ua || !p00Uj) break;                                        \
+    ++p00_gallop;                                                               \
+    do {                                                                        \
+      p00_gallop -= (p00_gallop > 1);                                           \
+      P00_MGALLOP_R(p00_B + p00Ua, p00Ui - p00Ua, P00_MLE, p00_W[p00Uj - 1], p00Uca); \
+      p00Uca = p00Ui - p00Ua - p00Uca;                                          \
+      for (register size_t p00Uk = 0; p00Uk < p00Uca; ++p00Uk) {                \
+        --p00Ud;                                                                \
+        --p00Ui;                                                                \
+        COPY(p00_B[p00Ud], p00_B[p00Ui]);                                       \
+      }                                                                         \
+      if (p00Ui == p00Ua) break;                                                \
+      --p00Ud;                                                                  \
+      --p00Uj;                                                                  \
+      COPY(p00_B[p00Ud], p00_W[p00Uj]);                                         \
+      if (!p00Uj) break;                                                        \
+      P00_MGALLOP_R(p00_W, p00Uj, P00_MLT, p00_B[p00Ui - 1], p00Ucb);           \
+      p00Ucb = p00Uj - p00Ucb;                                                  \
+      for (register size_t p00Uk = 0; p00Uk < p00Ucb; ++p00Uk) {                \
+        --p00Ud;                                                                \
+        --p00Uj;                                                                \
+        COPY(p00_B[p00Ud], p00_W[p00Uj]);                                       \
+      }                                                                         \
+      if (!p00Uj) break;                                                        \
+      --p00Ud;                                                                  \
+      --p00Ui;                                                                  \
+      COPY(p00_B[p00Ud], p00_B[p00Ui]);                                         \
+      if (p00Ui == p00Ua) break;                                                \
+    } while (p00Uca >= P00_MSORT_GALLOP || p00Ucb >= P00_MSORT_GALLOP);         \
+    p00_gallop += 2;                                                            \
+  }                                                                             \
+  /* the rest of the left run is already in place */                            \
+  while (p00Uj) {                                                               \
+    --p00Ud;                                                                    \
+    --p00Uj;                                                                    \
+    COPY(p00_B[p00Ud], p00_W[p00Uj]);                                           \
+  }                                                                             \
+ } while (false)
+
+/* This is a natural merge sort in the spirit of TimSort. The array is
+   cut into maximal runs that are ascending or strictly descending,
+   the latter are reversed, and runs that are too short are extended
+   by a binary insertion sort. The runs are kept on a stack whose
+   lengths grow at least like the Fibonacci numbers from top to
+   bottom, and adjacent runs are merged as soon as that property is
+   violated. Before a merge, the prefix of the left run and the suffix
+   of the right run that are already in place are found by galloping
+   searches. The merge itself copies the shorter run to the scratch
+   buffer, and switches to galloping when one run wins several times
+   in a row.
+
+   All decisions are stable: equal elements are never moved past each
+   other. Data that consists of few runs is sorted with a linear
+   number of comparisons. */
+#define P00_MSORT_BODY(SWAP, COPY)                                              \
+if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;                        \
+if (p00_n && (!p00_base || !p00_comp)) return EINVAL;                           \
+do {                                                                            \
+  if (p00_n < 2) return 0;                                                      \
+  register p00_el *p00_W = p00_scratch;                                         \
+  register bool p00_own = false;                                                \
+  register size_t p00_gallop = P00_MSORT_GALLOP;                                \
+  register size_t p00_minrun = p00_n;                                           \
+  {                                                                             \
+    register size_t p00_r = 0;                                                  \
+    while (p00_minrun >= 2*P00_MSORT_MINRUN) {                                  \
+      p00_r |= p00_minrun & 1;                                                  \
+      p00_minrun >>= 1;                                                         \
+    }                                                                           \
+    p00_minrun += p00_r;                                                        \
+  }                                                                             \
+  p00_msort p00_R[2*p99_arith_log2(p00_n) + 4];                                 \
+  register size_t p00_nr = 0;                                                   \
+  for (register size_t p00_lo = 0;;) {                                          \
+    register bool const p00_final = (p00_lo == p00_n);                          \
+    if (!p00_final) {                                                           \
+      register size_t p00_hi = p00_lo + 1;                                      \
+      if (p00_hi < p00_n) {                                                     \
+        if (P00_MLT(p00_B[p00_hi], p00_B[p00_lo])) {                            \
+          while (p00_hi + 1 < p00_n && P00_MLT(p00_B[p00_hi + 1], p00_B[p00_hi])) ++p00_hi; \
+          ++p00_hi;                                                             \
+          for (register size_t p00_i = p00_lo, p00_j = p00_hi - 1; p00_i < p00_j; ++p00_i, --p00_j) \
+            SWAP(p00_B, p00_i, p00_j);                                          \
+        } else {                                                                \
+          while (p00_hi + 1 < p00_n && !P00_MLT(p00_B[p00_hi + 1], p00_B[p00_hi])) ++p00_hi; \
+          ++p00_hi;                                                             \
+        }                                                                       \
+      }                                                                         \
+      if (p00_hi - p00_lo < p00_minrun) {                                       \
+        register size_t const p00_top = (p00_n - p00_lo < p00_minrun) ? p00_n : p00_lo + p00_minrun; \
+        /* binary insertion, equal elements stay in front */                    \
+        for (; p00_hi < p00_top; ++p00_hi) {                                    \
+          register size_t p00_pos;                                              \
+          P00_MGALLOP_R(p00_B + p00_lo, p00_hi - p00_lo, P00_MLE, p00_B[p00_hi], p00_pos); \
+          p00_pos += p00_lo;                                                    \
+          if (p00_pos == p00_hi) continue;                                      \
+          COPY(p00_tmp, p00_B[p00_hi]);                                         \
+          for (register size_t p00_k = p00_hi; p00_k > p00_pos; --p00_k)        \
+            COPY(p00_B[p00_k], p00_B[p00_k - 1]);                               \
+          COPY(p00_B[p00_pos], p00_tmp);                                        \
+        }                                                                       \
+      }                                                                         \
+      p00_R[p00_nr++] = (p00_msort){ .bot = p00_lo, .len = p00_hi - p00_lo, };  \
+      p00_lo = p00_hi;                                                          \
+    }                                                                           \
+    while (p00_nr > 1) {                                                        \
+      register size_t p00_i = p00_nr - 2;                                       \
+      if (p00_final                                                             \
+          || (p00_i > 0 && p00_R[p00_i - 1].len <= p00_R[p00_i].len + p00_R[p00_i + 1].len) \
+          || (p00_i > 1 && p00_R[p00_i - 2].len <= p00_R[p00_i - 1].len + p00_R[p00_i].len)) { \
+        if (p00_i > 0 && p00_R[p00_i - 1].len < p00_R[p00_i + 1].len) --p00_i;  \
+      } else if (p00_R[p00_i].len > p00_R[p00_i + 1].len) break;                \
+      register size_t p00_a = p00_R[p00_i].bot;                                 \
+      register size_t p00_na = p00_R[p00_i].len;                                \
+      register size_t p00_nb = p00_R[p00_i + 1].len;                            \
+      p00_R[p00_i].len += p00_nb;                                               \
+      if (p00_i + 3 == p00_nr) p00_R[p00_i + 1] = p00_R[p00_i + 2];             \
+      --p00_nr;                                                                 \
+      /* The head of the left run and the tail of the right run stay. */        \
+      register size_t p00_k;                                                    \
+      P00_MGALLOP_L(p00_B + p00_a, p00_na, P00_MLE, p00_B[p00_a + p00_na], p00_k); \
+      p00_a += p00_k;                                                           \
+      p00_na -= p00_k;                                                          \
+      if (!p00_na) continue;                                                    \
+      P00_MGALLOP_R(p00_B + p00_a + p00_na, p00_nb, P00_MLT, p00_B[p00_a + p00_na - 1], p00_nb); \
+      if (!p00_nb) continue;                                                    \
+      if (!p00_W) {                                                             \
+        p00_W = malloc((p00_n/2)*sizeof(p00_el));                               \
+        if (!p00_W) return ENOMEM;                                              \
+        p00_own = true;                                                         \
+      }                                                                         \
+      if (p00_na <= p00_nb) P00_MMERGE_LO(COPY, p00_a, p00_na, p00_nb);         \
+      else P00_MMERGE_HI(COPY, p00_a, p00_na, p00_nb);                          \
+    }                                                                           \
+    if (p00_final) break;                                                       \
+  }                                                                             \
+  if (p00_own) free(p00_W);                                                     \
+  return 0;                                                                     \
+ } while (false)
+
+#define P00_MSORT_GENERIC(N, T, SWAP, COPY)                                     \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_msort_generic, N)(void *p00_base,                        \
+                                         rsize_t p00_n,                         \
+                                         rsize_t p00_a,                         \
+                                         rsize_t p00_s,                         \
+                                         int (*p00_comp)(const void *, const void *, void *), \
+                                         void *p00_ctx,                         \
+                                         void *p00_scratch) {                   \
+  P99_UNUSED(p00_a);                                                            \
+  size_t const p00_vsize = p00_s / sizeof(T);                                   \
+  P99_UNUSED(p00_vsize);                                                        \
+  typedef T p00_el[p00_vsize];                                                  \
+  register p00_el *const p00_B = p00_base;                                      \
+  p00_el p00_tmp;                                                               \
+  P00_MSORT_BODY(SWAP, COPY);                                                   \
+}                                                                               \
+P99_MACRO_END(p00_msort_generic, N)
+
+#ifdef UINT16_MAX
+P00_MSORT_GENERIC(16, uint16_t, P00_QSWAP_VCPY, P00_MCOPY_VCPY);
+#endif
+#ifdef UINT32_MAX
+P00_MSORT_GENERIC(32, uint32_t, P00_QSWAP_VCPY, P00_MCOPY_VCPY);
+#endif
+#ifdef UINT64_MAX
+P00_MSORT_GENERIC(64, uint64_t, P00_QSWAP_VCPY, P00_MCOPY_VCPY);
+#endif
+#ifdef UINT128_MAX
+P00_MSORT_GENERIC(128, uint128_t, P00_QSWAP_VCPY, P00_MCOPY_VCPY);
+#else
+# ifdef P99X_UINT128_MAX
+P00_MSORT_GENERIC(128, p99x_uint128, P00_QSWAP_VCPY, P00_MCOPY_VCPY);
+# endif
+#endif
+P00_MSORT_GENERIC(, unsigned char, P00_QSWAP_MEMCPY, P00_MCOPY_MEMCPY);
+
+#define P00_MSORT_DECLARE(T)                                                    \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_msort_, T)(void *p00_base,                               \
+                    rsize_t p00_n,                                              \
+                    rsize_t p00_a,                                              \
+                    rsize_t p00_s,                                              \
+                    int (*p00_comp)(const void *, const void *, void *),        \
+                    void *p00_ctx,                                              \
+                    void *p00_scratch) {                                        \
+  P99_UNUSED(p00_a);                                                            \
+  typedef T p00_el;                                                             \
+  register T *const p00_B = p00_base;                                           \
+  _Alignas(sizeof(max_align_t)) T p00_tmp;                                      \
+  P00_MSORT_BODY(P00_QSWAP_ASSIGN, P00_MCOPY_ASSIGN);                           \
+}                                                                               \
+P99_MACRO_END(p00_msort_, T)
+
+P00_MSORT_DECLARE(_Bool);
+P00_MSORT_DECLARE(schar);
+P00_MSORT_DECLARE(uchar);
+P00_MSORT_DECLARE(char);
+P00_MSORT_DECLARE(short);
+P00_MSORT_DECLARE(ushort);
+P00_MSORT_DECLARE(signed);
+P00_MSORT_DECLARE(unsigned);
+P00_MSORT_DECLARE(long);
+P00_MSORT_DECLARE(ulong);
+P00_MSORT_DECLARE(llong);
+P00_MSORT_DECLARE(ullong);
+P00_MSORT_DECLARE(float);
+P00_MSORT_DECLARE(double);
+P00_MSORT_DECLARE(ldouble);
+#ifndef __STDC_NO_COMPLEX__
+P00_MSORT_DECLARE(cfloat);
+P00_MSORT_DECLARE(cdouble);
+P00_MSORT_DECLARE(cldouble);
+#endif
+P00_MSORT_DECLARE(void_ptr);
+
+p99_inline
+errno_t p00_msort_s(void *p00_base,
+                    rsize_t p00_n,
+                    rsize_t p00_a,
+                    rsize_t p00_s,
+                    int (*p00_comp)(const void *, const void *, void *),
+                    void *p00_ctx,
+                    void *p00_scratch) {
+  switch (p00_a) {
+#ifdef UINT16_MAX
+  case sizeof(uint16_t):
+    return p00_msort_generic16(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_scratch);
+#endif
+#ifdef UINT32_MAX
+  case sizeof(uint32_t):
+    return p00_msort_generic32(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_scratch);
+#endif
+#ifdef UINT64_MAX
+  case sizeof(uint64_t):
+    return p00_msort_generic64(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_scratch);
+#endif
+#if defined(UINT128_MAX) || defined(P99X_UINT128_MAX)
+  case 16:
+    return p00_msort_generic128(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_scratch);
+#endif
+  }
+  return p00_msort_generic(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_scratch);
+}
+
+#ifdef __STDC_NO_COMPLEX__
+#define P00_MSORT_S(B)                                                          \
+  P99_GENERIC(&((B)[0]),                                                        \
+            p00_msort_s,                                                        \
+            (void_ptr*, p00_msort_void_ptr),                                    \
+            /* */                                                               \
+            (float*, p00_msort_float),                                          \
+            (double*, p00_msort_double),                                        \
+            /* */                                                               \
+            (_Bool*, p00_msort__Bool),                                          \
+            (char*, p00_msort_char),                                            \
+            (uchar*, p00_msort_uchar),                                          \
+            (schar*, p00_msort_schar),                                          \
+            /* */                                                               \
+            (ushort*, p00_msort_ushort),                                        \
+            (short*, p00_msort_short),                                          \
+            /* */                                                               \
+            (unsigned*, p00_msort_unsigned),                                    \
+            (signed*, p00_msort_signed),                                        \
+            /* */                                                               \
+            (long*, p00_msort_long),                                            \
+            (ulong*, p00_msort_ulong),                                          \
+            /* */                                                               \
+            (llong*, p00_msort_llong),                                          \
+            (ullong*, p00_msort_ullong)                                         \
+              )
+#else
+#define P00_MSORT_S(B)                                                          \
+  P99_GENERIC(&((B)[0]),                                                        \
+            p00_msort_s,                                                        \
+            (void_ptr*, p00_msort_void_ptr),                                    \
+            /* */                                                               \
+            (float*, p00_msort_float),                                          \
+            (double*, p00_msort_double),                                        \
+            (ldouble*, p00_msort_ldouble),                                      \
+            /* */                                                               \
+            (cfloat*, p00_msort_cfloat),                                        \
+            (cdouble*, p00_msort_cdouble),                                      \
+            (cldouble*, p00_msort_cldouble),                                    \
+            /* */                                                               \
+            (_Bool*, p00_msort__Bool),                                          \
+            (char*, p00_msort_char),                                            \
+            (uchar*, p00_msort_uchar),                                          \
+            (schar*, p00_msort_schar),                                          \
+            /* */                                                               \
+            (ushort*, p00_msort_ushort),                                        \
+            (short*, p00_msort_short),                                          \
+            /* */                                                               \
+            (unsigned*, p00_msort_unsigned),                                    \
+            (signed*, p00_msort_signed),                                        \
+            /* */                                                               \
+            (long*, p00_msort_long),                                            \
+            (ulong*, p00_msort_ulong),                                          \
+            /* */                                                               \
+            (llong*, p00_msort_llong),                                          \
+            (ullong*, p00_msort_ullong)                                         \
+              )
+#endif
+
+/**
+ ** @brief A stable generic sorting routine.
+ **
+ ** This has the same interface as ::qsort_s, but elements that
+ ** compare equal keep their relative order. So records can be sorted
+ ** by several keys by sorting them by the least significant key
+ ** first. Its prototype if it were not implemented as a type generic
+ ** macro, would be:
+ **
+ ** @code
+ ** errno_t p99_msort_s(void *base,
+ **                     rsize_t nmemb,
+ **                     rsize_t size,
+ **                     int (*compar)(const void *x, const void *y, void *context),
+ **                     void *context,
+ **                     void *scratch);
+ ** @endcode
+ **
+ ** The algorithm is an adaptive merge sort similar to TimSort. It
+ ** detects runs that are already ordered, so data that is sorted up
+ ** to a few runs or perturbations needs only a linear number of
+ ** comparisons. Its worst case is O(n log n).
+ **
+ ** The optional argument @a scratch is a buffer for at least @c
+ ** nmemb/2 elements, aligned as the elements of @a base. If it is
+ ** omitted or a null pointer, such a buffer is allocated with @c
+ ** malloc when it is needed for the first time, and the function
+ ** fails with @c ENOMEM if that is not possible.
+ **/
+#define p99_msort_s(...)                                                        \
+P99_IF_LT(P99_NARG(__VA_ARGS__), 6)                                             \
+(P00_MSORT(__VA_ARGS__, 0))                                                     \
+(P00_MSORT(__VA_ARGS__))
+
+#define P00_MSORT(B, N, S, CMP, CTX, W)                                         \
+  P99_CONSTRAINT_TRIGGER(                                                       \
+  P00_MSORT_S(B)((B), (N), P99_ALIGNOF((B)[0]), (S), (CMP), (CTX), (W)),        \
+  "p99_msort_s runtime constraint violation")
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -174,6 +174,37 @@ P00_DOCUMENT_TYPE_ARGUMENT(P99_MEMZERO, 0)
  ** @{
  **/
 
+/**
+ ** @def P99_SCALABLE_MALLOC
+ ** @brief Define this before including any P99 header to have the
+ ** allocation macros use ::p99_malloc and friends instead of the C
+ ** library.
+ **
+ ** Memory that is allocated by these macros then must be freed with
+ ** ::P99_FREE or ::p99_free and not with @c free.
+ ** @see p99_malloc
+ **/
+#ifdef P99_SCALABLE_MALLOC
+# include "p99_malloc.h"
+# define P00_LIB_MALLOC p99_malloc
+# define P00_LIB_REALLOC p99_realloc
+# define P00_LIB_CALLOC p99_calloc
+# define P00_LIB_FREE p99_free
+#else
+# define P00_LIB_MALLOC malloc
+# define P00_LIB_REALLOC realloc
+# define P00_LIB_CALLOC calloc
+# define P00_LIB_FREE free
+#endif
+
+/**
+ ** @brief Free an object that has been allocated with one of the
+ ** allocation macros, e.g ::P99_MALLOC or ::P99_NEW.
+ **
+ ** This is @c free, unless ::P99_SCALABLE_MALLOC is defined.
+ **/
+#define P99_FREE(P) P00_LIB_FREE(P)
+
 /**
  ** @brief A type oriented @c malloc wrapper
  **
@@ -188,7 +219,7 @@ P00_DOCUMENT_TYPE_ARGUMENT(P99_MEMZERO, 0)
  ** particular, as in the second example, when you might have a dynamic
  ** data structure with pointers.
  **/
-#define P99_MALLOC(X) malloc(sizeof(X))
+#define P99_MALLOC(X) P00_LIB_MALLOC(sizeof(X))
 
 
 #define P00_VMALLOC(X) P00_ABLESS(P99_MALLOC(X), X)
@@ -226,11 +257,11 @@ P00_ABLESS(p00_initialize(sizeof(X),
  ** not be used as a replacement for @c free, since the second
  ** argument can not be tricked to result in a size of 0.
  **/
-#define P99_REALLOC(X, T) realloc((X), sizeof(T))
+#define P99_REALLOC(X, T) P00_LIB_REALLOC((X), sizeof(T))
 
 p99_inline
 void* p00_calloc(void const* p00_src, size_t p00_size, size_t p00_nb) {
-  return p00_memset(malloc(p00_size*p00_nb), p00_src, p00_size, p00_nb);
+  return p00_memset(P00_LIB_MALLOC(p00_size*p00_nb), p00_src, p00_size, p00_nb);
 }
 
 #define P00_CALLOC0(T, N) p00_calloc((void const*)&P99_LVAL(const T), sizeof(T), N)
@@ -351,7 +382,7 @@ void P99_PASTE2(T, _delete)(T const*p00_el) {                  \
   if (p00_el) {                                                \
     T* p00_e = (T*)p00_el;                                     \
     P99_PASTE2(T, _destroy)(p00_e);                            \
-    free((void*)p00_e);                                        \
+    P00_LIB_FREE((void*)p00_e);                                \
   }                                                            \
 }
 
@@ -457,7 +488,7 @@ P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FSIZEOF, 1)
 #define P99_FSIZEOF(T, F, N) P99_MAXOF(sizeof(T), offsetof(T, F) + P99_SIZEOF(T, F[0]) * N)
 #define P00_FSIZEOF(T, F, M) p99_maxof(sizeof(T), offsetof(T, F) + M)
 
-#define P00_FREALLOC(P, T, F, M) realloc(P, P00_FSIZEOF(T, F, M))
+#define P00_FREALLOC(P, T, F, M) P00_LIB_REALLOC(P, P00_FSIZEOF(T, F, M))
 /**
  ** @def P99_FREALLOC
  ** @brief Reallocate an instance @a P of @c struct T such that it is
@@ -472,7 +503,7 @@ P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FSIZEOF, 1)
 P00_DOCUMENT_MULTIPLE_ARGUMENT(P99_FREALLOC, 3)
 P00_DOCUMENT_TYPE_ARGUMENT(P99_FREALLOC, 1)
 P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FREALLOC, 2)
-#define P99_FREALLOC(P, T, F, N) realloc(P, P99_FSIZEOF(T, F, N))
+#define P99_FREALLOC(P, T, F, N) P00_LIB_REALLOC(P, P99_FSIZEOF(T, F, N))
 
 /**
  ** @def P99_FMALLOC
@@ -484,8 +515,8 @@ P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FREALLOC, 2)
 P00_DOCUMENT_MULTIPLE_ARGUMENT(P99_FMALLOC, 2)
 P00_DOCUMENT_TYPE_ARGUMENT(P99_FMALLOC, 0)
 P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FMALLOC, 1)
-#define P99_FMALLOC(T, F, N) malloc(P99_FSIZEOF(T, F, N))
-#define P00_FMALLOC(T, F, M) malloc(P00_FSIZEOF(T, F, M))
+#define P99_FMALLOC(T, F, N) P00_LIB_MALLOC(P99_FSIZEOF(T, F, N))
+#define P00_FMALLOC(T, F, M) P00_LIB_MALLOC(P00_FSIZEOF(T, F, M))
 /**
  ** @def P99_FCALLOC
  ** @brief Allocate an instance of @c struct T that is able to hold @a
@@ -496,8 +527,8 @@ P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FMALLOC, 1)
 P00_DOCUMENT_MULTIPLE_ARGUMENT(P99_FCALLOC, 2)
 P00_DOCUMENT_TYPE_ARGUMENT(P99_FCALLOC, 0)
 P00_DOCUMENT_PERMITTED_ARGUMENT(P99_FCALLOC, 1)
-#define P99_FCALLOC(T, F, N) calloc(P99_FSIZEOF(T, F, N),1)
-#define P00_FCALLOC(T, F, M) calloc(P00_FSIZEOF(T, F, M),1)
+#define P99_FCALLOC(T, F, N) P00_LIB_CALLOC(P99_FSIZEOF(T, F, N),1)
+#define P00_FCALLOC(T, F, M) P00_LIB_CALLOC(P00_FSIZEOF(T, F, M),1)
 
 /**
  ** @}
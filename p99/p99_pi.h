@@ -0,0 +1,292 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_PI_H
+#define P99_PI_H
+
+#include "p99_futex.h"
+#include "p99_tss.h"
+
+/**
+ ** @addtogroup futex
+ ** @{
+ **/
+
+#if P00_FUTEX_LINUX
+# ifndef FUTEX_LOCK_PI
+#  define FUTEX_LOCK_PI 6
+# endif
+# ifndef FUTEX_UNLOCK_PI
+#  define FUTEX_UNLOCK_PI 7
+# endif
+# ifndef FUTEX_WAITERS
+#  define FUTEX_WAITERS 0x80000000u
+# endif
+# ifndef FUTEX_OWNER_DIED
+#  define FUTEX_OWNER_DIED 0x40000000u
+# endif
+# ifndef FUTEX_TID_MASK
+#  define FUTEX_TID_MASK 0x3fffffffu
+# endif
+#endif
+
+/**
+ ** @brief A lock with priority inheritance.
+ **
+ ** This has the same interface as the mutex part of ::p99_cm, namely
+ ** ::p99_pi_lock, ::p99_pi_unlock and ::p99_pi_trylock, and can be
+ ** used for critical sections with ::P99_PI_EXCLUDE. It is meant for
+ ** data that is shared between threads of different scheduling
+ ** priority. When a high priority thread blocks on a ::p99_pi, the
+ ** thread that holds the lock temporarily inherits that priority, so
+ ** it can not be preempted by threads of medium priority while it
+ ** holds the lock.
+ **
+ ** On Linux this uses the futex operations @c FUTEX_LOCK_PI and @c
+ ** FUTEX_UNLOCK_PI. The lock word holds the thread ID (TID) of the
+ ** owner, or @c 0 if the lock is free. The kernel needs to know the
+ ** owner to boost it, so other than for ::p99_cm, ownership is
+ ** tracked and only the owner may unlock. Locking and unlocking
+ ** without contention is just one compare-exchange operation in user
+ ** space. Only if the lock is held, the waiter asks the kernel to
+ ** enqueue it. The kernel then marks the lock word with @c
+ ** FUTEX_WAITERS, such that the owner's compare-exchange in
+ ** ::p99_pi_unlock fails and it enters the kernel to hand over the
+ ** lock.
+ **
+ ** On other platforms this falls back to a simple lock on a
+ ** ::p99_futex without priority inheritance.
+ **
+ ** @warning A ::p99_pi is not recursive. If the owner calls
+ ** ::p99_pi_lock a second time, the kernel refuses to deadlock and
+ ** the call returns ::thrd_error without acquiring the lock.
+ **
+ ** @warning Since the lock is not registered in the robust futex
+ ** list of the thread, it is not released if its owner exits.
+ **
+ ** @see p99_pi_lock
+ ** @see p99_pi_unlock
+ ** @see p99_pi_trylock
+ ** @see P99_PI_EXCLUDE
+ ** @see p99_cm for a lock that also has a wait interface
+ **/
+P99_DECLARE_STRUCT(p99_pi);
+
+struct p99_pi {
+#if P00_FUTEX_LINUX
+  _Atomic(unsigned) p00_w;
+#else
+  p99_futex p00_w;
+#endif
+};
+
+/**
+ ** @brief Initialize an ::p99_pi object.
+ **/
+#if P00_FUTEX_LINUX
+# define P99_PI_INITIALIZER { .p00_w = ATOMIC_VAR_INIT(0u), }
+#else
+# define P99_PI_INITIALIZER { .p00_w = P99_FUTEX_INITIALIZER(0u), }
+#endif
+
+/**
+ ** @brief Initialize a pi lock
+ ** @related p99_pi
+ **/
+p99_inline
+p99_pi* p99_pi_init(p99_pi* p00_pi) {
+  if (p00_pi) {
+#if P00_FUTEX_LINUX
+    atomic_init(&p00_pi->p00_w, 0u);
+#else
+    p99_futex_init(&p00_pi->p00_w, 0u);
+#endif
+  }
+  return p00_pi;
+}
+
+/**
+ ** @brief destroy a pi lock
+ ** @related p99_pi
+ **/
+p99_inline
+void p99_pi_destroy(p99_pi* p00_pi) {
+#if !P00_FUTEX_LINUX
+  if (p00_pi) p99_futex_destroy(&p00_pi->p00_w);
+#else
+  (void)p00_pi;
+#endif
+}
+
+#if P00_FUTEX_LINUX
+
+/* The thread ID is needed for every lock operation, so we cache it.
+   The child of a fork has a new thread ID, so there the cache of the
+   thread that called fork is cleared. */
+P99_DECLARE_THREAD_LOCAL(unsigned, p00_pi_tid);
+
+P99_WEAK(p00_pi_tid_once)
+once_flag p00_pi_tid_once = ONCE_FLAG_INIT;
+
+P99_WEAK(p00_pi_tid_reset)
+void p00_pi_tid_reset(void) {
+  P99_THREAD_LOCAL(p00_pi_tid) = 0;
+}
+
+P99_WEAK(p00_pi_tid_atfork)
+void p00_pi_tid_atfork(void) {
+  pthread_atfork(0, 0, p00_pi_tid_reset);
+}
+
+p99_inline
+unsigned p00_pi_tid_get(void) {
+  register unsigned p00_tid = P99_THREAD_LOCAL(p00_pi_tid);
+  if (P99_UNLIKELY(!p00_tid)) {
+    call_once(&p00_pi_tid_once, p00_pi_tid_atfork);
+    p00_tid = syscall(SYS_gettid);
+    P99_THREAD_LOCAL(p00_pi_tid) = p00_tid;
+  }
+  return p00_tid;
+}
+
+p99_inline
+int p00_pi_syscall(p99_pi volatile* p00_pi, int p00_op) {
+  static_assert(sizeof p00_pi->p00_w == sizeof(int),
+                "linux futex supposes that there is no hidden lock field");
+  for (;;) {
+    register int p00_ret = p00_futex((int*)&p00_pi->p00_w, p00_op, 0);
+    if (P99_LIKELY(!p00_ret)) return 0;
+    p00_ret = errno;
+    errno = 0;
+    /* EAGAIN tells that the owner is about to exit, so the lock will
+       be released soon. */
+    if (p00_ret != EINTR && p00_ret != EAGAIN) return p00_ret;
+  }
+}
+
+#endif
+
+/**
+ ** @brief Try to acquire @a p00_pi without blocking.
+ **
+ ** @return ::thrd_success if the lock has been acquired, ::thrd_busy
+ ** otherwise.
+ ** @related p99_pi
+ **/
+p99_inline
+int p99_pi_trylock(p99_pi volatile* p00_pi) {
+#if P00_FUTEX_LINUX
+  unsigned p00_own = 0u;
+  return atomic_compare_exchange_strong(&p00_pi->p00_w, &p00_own, p00_pi_tid_get())
+    ? thrd_success
+    : thrd_busy;
+#else
+  return p99_futex_exchange(&p00_pi->p00_w, 1u, 0u, 0u, 0u, 0u)
+    ? thrd_busy
+    : thrd_success;
+#endif
+}
+
+/**
+ ** @brief Acquire @a p00_pi.
+ **
+ ** If @a p00_pi is currently held this function is blocking, and the
+ ** owner of the lock inherits the priority of the calling thread
+ ** while it blocks.
+ **
+ ** @return ::thrd_success if the lock has been acquired,
+ ** ::thrd_error if the kernel refused, e.g because the calling
+ ** thread already holds the lock.
+ ** @related p99_pi
+ **/
+P00_FUTEX_INLINE(p99_pi_lock)
+int p99_pi_lock(p99_pi volatile* p00_pi) {
+#if P00_FUTEX_LINUX
+  if (P99_UNLIKELY(p99_pi_trylock(p00_pi) != thrd_success))
+    /* The kernel sets FUTEX_WAITERS and the TID for us. */
+    if (p00_pi_syscall(p00_pi, FUTEX_LOCK_PI)) return thrd_error;
+#else
+  P99_FUTEX_COMPARE_EXCHANGE(&p00_pi->p00_w, p00_act,
+                             // wait while locked by another thread
+                             !p00_act,
+                             1u,
+                             // never wake up anyone
+                             0u, 0u);
+#endif
+  return thrd_success;
+}
+
+/**
+ ** @brief Release @a p00_pi and hand it over to the waiter of highest
+ ** priority, if any.
+ **
+ ** @warning Only the thread that holds @a p00_pi may call this.
+ ** @related p99_pi
+ **/
+P00_FUTEX_INLINE(p99_pi_unlock)
+void p99_pi_unlock(p99_pi volatile* p00_pi) {
+#if P00_FUTEX_LINUX
+  unsigned p00_own = p00_pi_tid_get();
+  if (P99_UNLIKELY(!atomic_compare_exchange_strong(&p00_pi->p00_w, &p00_own, 0u)))
+    /* FUTEX_WAITERS is set, only the kernel may release the lock. */
+    p00_pi_syscall(p00_pi, FUTEX_UNLOCK_PI);
+#else
+  p99_futex_exchange(&p00_pi->p00_w, 0u, 0u, 1u, 0u, 1u);
+#endif
+}
+
+/**
+ ** @brief Protect the following block or statement as a critical
+ ** section of the program by using @a PIP as a priority inheritance
+ ** lock.
+ **
+ ** @param PIP is an expression that evaluates to a pointer to
+ ** ::p99_pi.
+ **
+ ** @remark @a PIP is only evaluated once at the beginning, so it
+ ** would be safe to change it in the depending block or statement.
+ **
+ ** @remark If ::p99_pi_lock fails, e.g because the calling thread
+ ** already holds the lock, the depending block or statement is
+ ** skipped and the lock is not released.
+ **
+ ** @warning Such a section should not contain preliminary exits such
+ ** as @c goto, @c break, @c return, @c longjmp, or ::P99_UNWIND etc.
+ **
+ ** @see P99_CM_EXCLUDE for a lock without priority inheritance
+ **/
+#define P99_PI_EXCLUDE(PIP)   P00_PI_EXCLUDE(PIP, P99_UNIQ(pi))
+
+#define P00_PI_EXCLUDE(PIP, ID)                                \
+P00_BLK_START                                                  \
+P00_BLK_DECL(register p99_pi volatile*const, ID, (PIP))        \
+P00_BLK_DECL(int const, p00_pi_ret, p99_pi_lock(ID))           \
+/* Don't release a lock that we didn't acquire. */             \
+P00_BLK_CONDITIONAL(p00_pi_ret == thrd_success)                \
+P00_BLK_AFTER(p99_pi_unlock(ID))                               \
+P00_BLK_END
+
+
+/**
+ ** @}
+ **/
+
+
+#endif
@@ -38,6 +38,7 @@ P99_DECLARE_STRUCT(p00_qsort);
 struct p00_qsort {
   size_t bot;
   size_t top;
+  unsigned bad;
 };
 
 #define P00_QSWAP_MEMCPY(P, A, B)                              \
@@ -72,11 +73,12 @@ do {                                                           \
 
 #define P00_QCOMP(A, B) p00_comp(&p00_B[A], &p00_B[B], p00_ctx)
 
-#define P00_QPUSH(P, B, T)                                     \
+#define P00_QPUSH(P, B, T, BAD)                                \
 do {                                                           \
   register p00_qsort *const p00Mp = ++(P);                     \
   p00Mp->bot = (B);                                            \
   p00Mp->top = (T);                                            \
+  p00Mp->bad = (BAD);                                          \
  } while (false)
 
 #define P00_QTOP(P, B, T)                                      \
@@ -85,92 +87,221 @@ do {                                                           \
 
 #define P00_QEMPTY(S, P) ((S) == (P))
 
-#define P00_QSORT_BODY(SWAP)                                          \
-if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;              \
-if (p00_n && (!p00_base || !p00_comp)) return EINVAL;                 \
-do {                                                                  \
-  register p99_seed *const seed = p99_seed_get();                     \
-  /* Initialize a stack of states */                                  \
-  P99_CONSTANT(int, p00_tail, 20);                                    \
-  /* provide a reasonable stack of states */                          \
-  p00_qsort p00_a[(p99_arith_log2(p00_n) + 1)*p00_tail];              \
-  p00_qsort* p00_p = p00_a;                                           \
-  P00_QPUSH(p00_p, 0, p00_n);                                         \
-  while(!P00_QEMPTY(p00_a, p00_p)) {                                  \
-    /* read the values from the stack */                              \
-    P00_QTOP(p00_p, p00_bot, p00_top);                                \
-    register size_t const p00_len = p00_top - p00_bot;                \
-                                                                      \
-    switch (p00_len) {                                                \
-      /* special cases all fall through. */                           \
-    case 2:                                                           \
-      if (P00_QCOMP(p00_bot, p00_bot + 1) > 0)                        \
-        SWAP(p00_B, p00_bot, p00_bot + 1);                            \
-    case 1: ;                                                         \
-    case 0:                                                           \
-      --p00_p;                                                        \
-      break;                                                          \
-    default:                                                          \
-      /* move the pivot to the bottom element */                      \
-      {                                                               \
-        size_t p00_c = p99_rand(seed) % p00_len;                      \
-        if (p00_c) SWAP(p00_B, p00_bot, p00_bot + p00_c);             \
-      }                                                               \
-                                                                      \
-      /* The running variables. The fact that p00_b is > p00_bot,     \
-         guarantees progress. */                                      \
-      register size_t p00_b = p00_bot + 1;                            \
-      register size_t p00_t = p00_top;                                \
-                                                                      \
-      while (P99_LIKELY(p00_b < p00_t)) {                             \
-        /* Try to find two misplaced elements. */                     \
-        while (!(P00_QCOMP(p00_bot, p00_b) < 0)) {                    \
-          ++p00_b;                                                    \
-          if (P99_UNLIKELY(p00_b == p00_t)) goto P00_RECURSE;         \
-        }                                                             \
-        while (P00_QCOMP(p00_bot, p00_t - 1) < 0){                    \
-          --p00_t;                                                    \
-          if (P99_UNLIKELY(p00_b == p00_t)) goto P00_RECURSE;         \
-        }                                                             \
-                                                                      \
-        /* Two distinct misplaced elements are found. */              \
-        --p00_t;                                                      \
-        SWAP(p00_B, p00_b, p00_t);                                    \
-        ++p00_b;                                                      \
-      }                                                               \
-    P00_RECURSE:                                                      \
-      if ((p00_b - p00_bot) > 1) {                                    \
-        /* The pivot is always a maximal element in the lower part */ \
-        --p00_b;                                                      \
-        SWAP(p00_B, p00_bot, p00_b);                                  \
-        /* Move all elements that compare equal adjacent */           \
-        register size_t const p00_bb = p00_b;                         \
-        for (register size_t p00_c = p00_bot;                         \
-             p00_c < p00_b;) {                                        \
-          if (P00_QCOMP(p00_bb, p00_c) <= 0) {                        \
-            --p00_b;                                                  \
-            if (p00_c == p00_b) break;                                \
-            SWAP(p00_B, p00_c, p00_b);                                \
-          } else ++p00_c;                                             \
-        }                                                             \
-      }                                                               \
-      /* Register the "recursive" calls into the two halfs. Most */   \
-      /* recursive calls are actually close to the bottom, so we */   \
-      /* rarely have to do the check if they are small enough.   */   \
-      if (P99_UNLIKELY(p00_len >= p00_tail)) {                        \
-        size_t p00Mmax = p00_len*0.99;                                \
-        /* If the split isn't good enough we just try again     */    \
-        if (P99_UNLIKELY(((p00_b - p00_bot) >= p00Mmax)               \
-                         ||                                           \
-                         ((p00_top - p00_t) >= p00Mmax)))             \
-          continue;                                                   \
-      }                                                               \
-      --p00_p;                                                        \
-      if ((p00_b - p00_bot) > 1) P00_QPUSH(p00_p, p00_bot, p00_b);    \
-      if ((p00_top - p00_t) > 1) P00_QPUSH(p00_p, p00_t, p00_top);    \
-    }                                                                 \
-  }                                                                   \
-  return 0;                                                           \
+/* Partitions below this size are sorted by insertion. */
+#define P00_QSORT_INSERTION 24u
+
+/* Partitions above this size use the ninther as pivot. */
+#define P00_QSORT_NINTHER 128u
+
+/* Partial insertion sort gives up after moving this many elements. */
+#define P00_QSORT_PARTIAL 8u
+
+/* Order the elements at positions A and B. */
+#define P00_QSORT2(SWAP, A, B)                                 \
+do {                                                           \
+  register size_t const p00Qa = (A);                           \
+  register size_t const p00Qb = (B);                           \
+  if (P00_QCOMP(p00Qb, p00Qa) < 0) SWAP(p00_B, p00Qa, p00Qb);  \
+ } while (false)
+
+#define P00_QSORT3(SWAP, A, B, C)                              \
+do {                                                           \
+  P00_QSORT2(SWAP, (A), (B));                                  \
+  P00_QSORT2(SWAP, (B), (C));                                  \
+  P00_QSORT2(SWAP, (A), (B));                                  \
+ } while (false)
+
+/* Insertion sort of the range [BOT, TOP). RET is set to false if
+   more than LIMIT elements had to be moved, and the sort is then
+   abandoned. */
+#define P00_QINSERT(SWAP, BOT, TOP, LIMIT, RET)                                 \
+do {                                                                            \
+  register size_t const p00Qbot = (BOT);                                        \
+  register size_t const p00Qtop = (TOP);                                        \
+  register size_t p00Qmoved = 0;                                                \
+  (RET) = true;                                                                 \
+  for (register size_t p00Qi = p00Qbot + 1; p00Qi < p00Qtop; ++p00Qi) {         \
+    register size_t p00Qj = p00Qi;                                              \
+    for (; p00Qj > p00Qbot && P00_QCOMP(p00Qj - 1, p00Qj) > 0; --p00Qj)         \
+      SWAP(p00_B, p00Qj - 1, p00Qj);                                            \
+    p00Qmoved += p00Qi - p00Qj;                                                 \
+    if (p00Qmoved > (LIMIT)) {                                                  \
+      (RET) = false;                                                            \
+      break;                                                                    \
+    }                                                                           \
+  }                                                                             \
+ } while (false)
+
+/* Restore the heap property of the heap of size N at BOT below
+   position K. */
+#define P00_QSIFT(SWAP, BOT, K, N)                                              \
+do {                                                                            \
+  register size_t p00Qr = (K);                                                  \
+  for (;;) {                                                                    \
+    register size_t p00Qc = 2*p00Qr + 1;                                        \
+    if (p00Qc >= (N)) break;                                                    \
+    if (p00Qc + 1 < (N) && P00_QCOMP((BOT) + p00Qc, (BOT) + p00Qc + 1) < 0)     \
+      ++p00Qc;                                                                  \
+    if (!(P00_QCOMP((BOT) + p00Qr, (BOT) + p00Qc) < 0)) break;                  \
+    SWAP(p00_B, (BOT) + p00Qr, (BOT) + p00Qc);                                  \
+    p00Qr = p00Qc;                                                              \
+  }                                                                             \
+ } while (false)
+
+/* Heap sort of the range [BOT, TOP), the fallback if there are too
+   many bad partitions. */
+#define P00_QHEAP(SWAP, BOT, TOP)                                               \
+do {                                                                            \
+  register size_t const p00Hbot = (BOT);                                        \
+  register size_t const p00Hn = (TOP) - p00Hbot;                                \
+  for (register size_t p00Hk = p00Hn/2; p00Hk-- > 0;)                           \
+    P00_QSIFT(SWAP, p00Hbot, p00Hk, p00Hn);                                     \
+  for (register size_t p00He = p00Hn; p00He-- > 1;) {                           \
+    SWAP(p00_B, p00Hbot, p00Hbot + p00He);                                      \
+    P00_QSIFT(SWAP, p00Hbot, 0, p00He);                                         \
+  }                                                                             \
+ } while (false)
+
+/* Break up patterns after a bad partition by swapping some elements of
+   the partition [BOT, TOP) of length LEN with elements of its
+   quarters. */
+#define P00_QSHUFFLE(SWAP, BOT, TOP, LEN)                                       \
+do {                                                                            \
+  register size_t const p00Qq = (LEN)/4;                                        \
+  if ((LEN) >= P00_QSORT_INSERTION) {                                           \
+    SWAP(p00_B, (BOT), (BOT) + p00Qq);                                          \
+    SWAP(p00_B, (TOP) - 1, (TOP) - p00Qq);                                      \
+    if ((LEN) > P00_QSORT_NINTHER) {                                            \
+      SWAP(p00_B, (BOT) + 1, (BOT) + (p00Qq + 1));                              \
+      SWAP(p00_B, (BOT) + 2, (BOT) + (p00Qq + 2));                              \
+      SWAP(p00_B, (TOP) - 2, (TOP) - (p00Qq + 1));                              \
+      SWAP(p00_B, (TOP) - 3, (TOP) - (p00Qq + 2));                              \
+    }                                                                           \
+  }                                                                             \
+ } while (false)
+
+/* This is a pattern-defeating quicksort. Small partitions are sorted
+   by insertion. The pivot is the median of three, or for large
+   partitions the median of three medians, and is kept at the bottom
+   of the partition during partitioning. If the partition splits very
+   unevenly, some elements are swapped to break up patterns in the
+   data, and after too many such bad partitions the partition is heap
+   sorted, so the worst case is O(n log n). If a partitioning didn't
+   need to swap anything, the data is likely to be sorted, and both
+   halves are tried with an insertion sort that gives up early. So
+   sorted data needs a linear number of comparisons, and so does data
+   in reverse order, which is detected up front. If the pivot compares
+   equal to the element before the partition, which is the pivot of a
+   previous step, all elements that are equal to it are split off at
+   once, so many duplicates are handled in linear time, too.
+
+   The larger of the two partitions is pushed first on the stack, so
+   the stack has at most a logarithmic number of entries. */
+#define P00_QSORT_BODY(SWAP)                                                    \
+if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;                        \
+if (p00_n && (!p00_base || !p00_comp)) return EINVAL;                           \
+do {                                                                            \
+  if (p00_n < 2) return 0;                                                      \
+  /* A sequence that is ordered backwards is just reversed. */                  \
+  {                                                                             \
+    register size_t p00_r = 1;                                                  \
+    while (p00_r < p00_n && P00_QCOMP(p00_r - 1, p00_r) > 0) ++p00_r;           \
+    if (p00_r == p00_n) {                                                       \
+      for (register size_t p00_i = 0, p00_j = p00_n - 1; p00_i < p00_j; ++p00_i, --p00_j) \
+        SWAP(p00_B, p00_i, p00_j);                                              \
+      return 0;                                                                 \
+    }                                                                           \
+  }                                                                             \
+  p00_qsort p00_a[p99_arith_log2(p00_n) + 2];                                   \
+  p00_qsort* p00_p = p00_a;                                                     \
+  P00_QPUSH(p00_p, 0, p00_n, p99_arith_log2(p00_n));                            \
+  while (!P00_QEMPTY(p00_a, p00_p)) {                                           \
+    /* read the values from the stack */                                       \
+    P00_QTOP(p00_p, p00_bot, p00_top);                                          \
+    register unsigned p00_bad = p00_p->bad;                                     \
+    --p00_p;                                                                    \
+    register size_t const p00_len = p00_top - p00_bot;                          \
+    bool p00_ok;                                                                \
+    if (p00_len < P00_QSORT_INSERTION) {                                        \
+      P00_QINSERT(SWAP, p00_bot, p00_top, SIZE_MAX, p00_ok);                    \
+      continue;                                                                 \
+    }                                                                           \
+    /* move the pivot to the bottom element */                                  \
+    {                                                                           \
+      register size_t const p00_h = p00_len/2;                                  \
+      if (p00_len > P00_QSORT_NINTHER) {                                        \
+        P00_QSORT3(SWAP, p00_bot, p00_bot + p00_h, p00_top - 1);                \
+        P00_QSORT3(SWAP, p00_bot + 1, p00_bot + (p00_h - 1), p00_top - 2);      \
+        P00_QSORT3(SWAP, p00_bot + 2, p00_bot + (p00_h + 1), p00_top - 3);      \
+        P00_QSORT3(SWAP, p00_bot + (p00_h - 1), p00_bot + p00_h, p00_bot + (p00_h + 1)); \
+        SWAP(p00_B, p00_bot, p00_bot + p00_h);                                  \
+      } else {                                                                  \
+        P00_QSORT3(SWAP, p00_bot + p00_h, p00_bot, p00_top - 1);                \
+      }                                                                         \
+    }                                                                           \
+    register size_t p00_b = p00_bot;                                            \
+    register size_t p00_t = p00_top;                                            \
+    if (p00_bot && !(P00_QCOMP(p00_bot - 1, p00_bot) < 0)) {                    \
+      /* The pivot is equal to the previous one, so there is nothing         \
+         smaller. Put the elements that are equal to the left and only      \
+         continue with the larger ones. */                                     \
+      while (P00_QCOMP(p00_bot, --p00_t) < 0);                                  \
+      if (p00_t + 1 == p00_top)                                                 \
+        while (p00_b < p00_t && !(P00_QCOMP(p00_bot, ++p00_b) < 0));            \
+      else                                                                      \
+        while (!(P00_QCOMP(p00_bot, ++p00_b) < 0));                             \
+      while (p00_b < p00_t) {                                                   \
+        SWAP(p00_B, p00_b, p00_t);                                              \
+        while (P00_QCOMP(p00_bot, --p00_t) < 0);                                \
+        while (!(P00_QCOMP(p00_bot, ++p00_b) < 0));                             \
+      }                                                                         \
+      if (p00_t != p00_bot) SWAP(p00_B, p00_bot, p00_t);                        \
+      if (p00_top - p00_t > 2) P00_QPUSH(p00_p, p00_t + 1, p00_top, p00_bad);   \
+      continue;                                                                 \
+    }                                                                           \
+    /* Find two misplaced elements. The median guarantees that both        \
+       searches stop inside the partition. */                                  \
+    while (P00_QCOMP(++p00_b, p00_bot) < 0);                                    \
+    if (p00_b - 1 == p00_bot)                                                   \
+      while (p00_b < p00_t && !(P00_QCOMP(--p00_t, p00_bot) < 0));              \
+    else                                                                        \
+      while (!(P00_QCOMP(--p00_t, p00_bot) < 0));                               \
+    register bool const p00_sorted = (p00_b >= p00_t);                          \
+    while (p00_b < p00_t) {                                                     \
+      SWAP(p00_B, p00_b, p00_t);                                                \
+      while (P00_QCOMP(++p00_b, p00_bot) < 0);                                  \
+      while (!(P00_QCOMP(--p00_t, p00_bot) < 0));                               \
+    }                                                                           \
+    /* The pivot goes between the two parts. */                                 \
+    register size_t const p00_pv = p00_b - 1;                                   \
+    if (p00_pv != p00_bot) SWAP(p00_B, p00_bot, p00_pv);                        \
+    register size_t const p00_ls = p00_pv - p00_bot;                            \
+    register size_t const p00_rs = p00_top - (p00_pv + 1);                      \
+    if (p00_ls < p00_len/8 || p00_rs < p00_len/8) {                             \
+      if (!p00_bad || !--p00_bad) {                                             \
+        P00_QHEAP(SWAP, p00_bot, p00_top);                                      \
+        continue;                                                               \
+      }                                                                         \
+      P00_QSHUFFLE(SWAP, p00_bot, p00_pv, p00_ls);                              \
+      P00_QSHUFFLE(SWAP, p00_pv + 1, p00_top, p00_rs);                          \
+    } else if (p00_sorted) {                                                    \
+      P00_QINSERT(SWAP, p00_bot, p00_pv, P00_QSORT_PARTIAL, p00_ok);            \
+      if (p00_ok) {                                                             \
+        P00_QINSERT(SWAP, p00_pv + 1, p00_top, P00_QSORT_PARTIAL, p00_ok);      \
+        if (p00_ok) continue;                                                   \
+      }                                                                         \
+    }                                                                           \
+    /* Register the "recursive" calls into the two halfs, the smaller */       \
+    /* one on top. */                                                           \
+    if (p00_ls < p00_rs) {                                                      \
+      if (p00_rs > 1) P00_QPUSH(p00_p, p00_pv + 1, p00_top, p00_bad);           \
+      if (p00_ls > 1) P00_QPUSH(p00_p, p00_bot, p00_pv, p00_bad);               \
+    } else {                                                                    \
+      if (p00_ls > 1) P00_QPUSH(p00_p, p00_bot, p00_pv, p00_bad);               \
+      if (p00_rs > 1) P00_QPUSH(p00_p, p00_pv + 1, p00_top, p00_bad);           \
+    }                                                                           \
+  }                                                                             \
+  return 0;                                                                     \
  } while(false)
 
 
@@ -287,21 +418,194 @@ errno_t P99_PASTE2(p00_qsort_, T)(void *p00_base,                        \
 }                                                                        \
 P99_MACRO_END(p00_qsort_, T)
 
+/* Partitions up to this size are sorted by a sorting network if the
+   order is the natural one. */
+#define P00_QNATURAL_SMALL 16u
+
+#define P00_QNLESS(A, B) (p00_B[A] < p00_B[B])
+
+/* Compare and exchange without branches, see P00_SORTNET_CE. */
+#define P00_QNCE(A, B)                                         \
+do {                                                           \
+  p00_tmp = p00_B[A];                                          \
+  register bool const p00Nc = p00_B[B] < p00_tmp;              \
+  p00_B[A] = p00Nc ? p00_B[B] : p00_tmp;                       \
+  p00_B[B] = p00Nc ? p00_tmp : p00_B[B];                       \
+ } while (false)
+
+#define P00_QNSORT3(A, B, C)                                   \
+do {                                                           \
+  P00_QNCE((A), (B));                                          \
+  P00_QNCE((B), (C));                                          \
+  P00_QNCE((A), (B));                                          \
+ } while (false)
+
+/* Batcher's merge exchange for the range [BOT, BOT+N), algorithm M
+   of Knuth, TAOCP 5.2.2. This is a sorting network for any N, where
+   the compare-exchange operations are found by a loop. */
+#define P00_QNET(BOT, N)                                                        \
+do {                                                                            \
+  register size_t const p00Nb = (BOT);                                          \
+  register size_t const p00Nn = (N);                                            \
+  register size_t p00Nt = 1;                                                    \
+  while (((size_t)1 << p00Nt) < p00Nn) ++p00Nt;                                 \
+  for (register size_t p00Np = (size_t)1 << (p00Nt - 1); p00Np; p00Np /= 2) {   \
+    register size_t p00Nq = (size_t)1 << (p00Nt - 1);                           \
+    register size_t p00Nr = 0;                                                  \
+    register size_t p00Nd = p00Np;                                              \
+    for (;;) {                                                                  \
+      for (register size_t p00Ni = 0; p00Ni + p00Nd < p00Nn; ++p00Ni)           \
+        if ((p00Ni & p00Np) == p00Nr) P00_QNCE(p00Nb + p00Ni, p00Nb + p00Ni + p00Nd); \
+      if (p00Nq == p00Np) break;                                                \
+      p00Nd = p00Nq - p00Np;                                                    \
+      p00Nq /= 2;                                                               \
+      p00Nr = p00Np;                                                            \
+    }                                                                           \
+  }                                                                             \
+ } while (false)
+
+/* Partition [BOT, TOP) around the pivot at BOT. The elements for
+   which the condition COND holds go to the front, starting at BOT +
+   1. Each step swaps unconditionally and only the position of the
+   next element of the front depends on COND, so there is no branch
+   to mispredict. P is set to the end of the front. */
+#define P00_QNPART(T, BOT, TOP, COND, P)                                        \
+do {                                                                            \
+  register size_t const p00Ntop = (TOP);                                        \
+  T const p00Npiv = p00_B[BOT];                                                 \
+  register size_t p00Nl = (BOT) + 1;                                            \
+  for (register size_t p00Ni = p00Nl; p00Ni < p00Ntop; ++p00Ni) {               \
+    register T const p00x = p00_B[p00Ni];                                       \
+    register bool const p00Nc = COND;                                           \
+    p00_B[p00Ni] = p00_B[p00Nl];                                                \
+    p00_B[p00Nl] = p00x;                                                        \
+    p00Nl += p00Nc;                                                             \
+  }                                                                             \
+  (P) = p00Nl;                                                                  \
+ } while (false)
+
+/* The same algorithm as P00_QSORT_BODY, specialized for the natural
+   order of a real type. The comparisons are the < operator and the
+   partitioning has no data dependent branches, so it doesn't suffer
+   from mispredictions, and small partitions are sorted by a sorting
+   network. p00_comp is only used for the heap sort fallback. */
+#define P00_QNATURAL_BODY(T)                                                    \
+do {                                                                            \
+  if (p00_n < 2) return 0;                                                      \
+  /* Sorted sequences are left alone and ones that are ordered       \
+     backwards are reversed. */                                                 \
+  {                                                                             \
+    register size_t p00_r = 1;                                                  \
+    while (p00_r < p00_n && !P00_QNLESS(p00_r, p00_r - 1)) ++p00_r;             \
+    if (p00_r == p00_n) return 0;                                               \
+    for (p00_r = 1; p00_r < p00_n && P00_QNLESS(p00_r, p00_r - 1);) ++p00_r;    \
+    if (p00_r == p00_n) {                                                       \
+      for (register size_t p00_i = 0, p00_j = p00_n - 1; p00_i < p00_j; ++p00_i, --p00_j) \
+        P00_QSWAP_ASSIGN(p00_B, p00_i, p00_j);                                  \
+      return 0;                                                                 \
+    }                                                                           \
+  }                                                                             \
+  p00_qsort p00_a[p99_arith_log2(p00_n) + 2];                                   \
+  p00_qsort* p00_p = p00_a;                                                     \
+  P00_QPUSH(p00_p, 0, p00_n, p99_arith_log2(p00_n));                            \
+  while (!P00_QEMPTY(p00_a, p00_p)) {                                           \
+    P00_QTOP(p00_p, p00_bot, p00_top);                                          \
+    register unsigned p00_bad = p00_p->bad;                                     \
+    --p00_p;                                                                    \
+    register size_t const p00_len = p00_top - p00_bot;                          \
+    if (p00_len <= P00_QNATURAL_SMALL) {                                        \
+      P00_QNET(p00_bot, p00_len);                                               \
+      continue;                                                                 \
+    }                                                                           \
+    /* move the pivot to the bottom element */                                  \
+    {                                                                           \
+      register size_t const p00_h = p00_len/2;                                  \
+      if (p00_len > P00_QSORT_NINTHER) {                                        \
+        P00_QNSORT3(p00_bot, p00_bot + p00_h, p00_top - 1);                     \
+        P00_QNSORT3(p00_bot + 1, p00_bot + (p00_h - 1), p00_top - 2);           \
+        P00_QNSORT3(p00_bot + 2, p00_bot + (p00_h + 1), p00_top - 3);           \
+        P00_QNSORT3(p00_bot + (p00_h - 1), p00_bot + p00_h, p00_bot + (p00_h + 1)); \
+        P00_QSWAP_ASSIGN(p00_B, p00_bot, p00_bot + p00_h);                      \
+      } else {                                                                  \
+        P00_QNSORT3(p00_bot + p00_h, p00_bot, p00_top - 1);                     \
+      }                                                                         \
+    }                                                                           \
+    register size_t p00_pv;                                                     \
+    if (p00_bot && !P00_QNLESS(p00_bot - 1, p00_bot)) {                         \
+      /* The pivot is equal to the previous one, so there is nothing         \
+         smaller. Only continue with the larger ones. */                        \
+      P00_QNPART(T, p00_bot, p00_top, !(p00Npiv < p00x), p00_pv);                  \
+      if (p00_top - p00_pv > 1) P00_QPUSH(p00_p, p00_pv, p00_top, p00_bad);     \
+      continue;                                                                 \
+    }                                                                           \
+    P00_QNPART(T, p00_bot, p00_top, p00x < p00Npiv, p00_pv);                       \
+    /* The pivot goes between the two parts. */                                 \
+    --p00_pv;                                                                   \
+    P00_QSWAP_ASSIGN(p00_B, p00_bot, p00_pv);                                   \
+    register size_t const p00_ls = p00_pv - p00_bot;                            \
+    register size_t const p00_rs = p00_top - (p00_pv + 1);                      \
+    if (p00_ls < p00_len/8 || p00_rs < p00_len/8) {                             \
+      if (!p00_bad || !--p00_bad) {                                             \
+        P00_QHEAP(P00_QSWAP_ASSIGN, p00_bot, p00_top);                          \
+        continue;                                                               \
+      }                                                                         \
+      P00_QSHUFFLE(P00_QSWAP_ASSIGN, p00_bot, p00_pv, p00_ls);                  \
+      P00_QSHUFFLE(P00_QSWAP_ASSIGN, p00_pv + 1, p00_top, p00_rs);              \
+    }                                                                           \
+    if (p00_ls < p00_rs) {                                                      \
+      if (p00_rs > 1) P00_QPUSH(p00_p, p00_pv + 1, p00_top, p00_bad);           \
+      if (p00_ls > 1) P00_QPUSH(p00_p, p00_bot, p00_pv, p00_bad);               \
+    } else {                                                                    \
+      if (p00_ls > 1) P00_QPUSH(p00_p, p00_bot, p00_pv, p00_bad);               \
+      if (p00_rs > 1) P00_QPUSH(p00_p, p00_pv + 1, p00_top, p00_bad);           \
+    }                                                                           \
+  }                                                                             \
+  return 0;                                                                     \
+ } while(false)
+
+/* For a real type, there is a comparison function p99_natural_T for
+   the natural order. If qsort_s receives that, the specialized
+   algorithm is used. */
+#define P00_QSORT_DECLARE_NATURAL(T)                                     \
+P99_WEAK(P99_PASTE2(p99_natural_, T))                                    \
+int P99_PASTE2(p99_natural_, T)(void const* p00_a, void const* p00_b, void* p00_c) { \
+  P99_UNUSED(p00_c);                                                     \
+  T const p00_A = *(T const*)p00_a;                                      \
+  T const p00_B = *(T const*)p00_b;                                      \
+  return (p00_A > p00_B) - (p00_A < p00_B);                              \
+}                                                                        \
+p99_inline                                                               \
+errno_t P99_PASTE2(p00_qsort_, T)(void *p00_base,                        \
+                    rsize_t p00_n,                                       \
+                    rsize_t p00_a,                                       \
+                    rsize_t p00_s,                                       \
+                    int (*p00_comp)(const void *, const void *, void *), \
+                    void *p00_ctx) {                                     \
+  P99_UNUSED(p00_a);                                                     \
+  register T *const p00_B = p00_base;                                    \
+  _Alignas(sizeof(max_align_t)) T p00_tmp;                               \
+  if (p00_comp == P99_PASTE2(p99_natural_, T)                            \
+      && p00_n <= RSIZE_MAX && p00_s == sizeof(T) && (p00_base || !p00_n)) \
+    P00_QNATURAL_BODY(T);                                                \
+  P00_QSORT_BODY(P00_QSWAP_ASSIGN);                                      \
+}                                                                        \
+P99_MACRO_END(p00_qsort_, T)
+
 P00_QSORT_DECLARE(_Bool);
-P00_QSORT_DECLARE(schar);
-P00_QSORT_DECLARE(uchar);
-P00_QSORT_DECLARE(char);
-P00_QSORT_DECLARE(short);
-P00_QSORT_DECLARE(ushort);
-P00_QSORT_DECLARE(signed);
-P00_QSORT_DECLARE(unsigned);
-P00_QSORT_DECLARE(long);
-P00_QSORT_DECLARE(ulong);
-P00_QSORT_DECLARE(llong);
-P00_QSORT_DECLARE(ullong);
-P00_QSORT_DECLARE(float);
-P00_QSORT_DECLARE(double);
-P00_QSORT_DECLARE(ldouble);
+P00_QSORT_DECLARE_NATURAL(schar);
+P00_QSORT_DECLARE_NATURAL(uchar);
+P00_QSORT_DECLARE_NATURAL(char);
+P00_QSORT_DECLARE_NATURAL(short);
+P00_QSORT_DECLARE_NATURAL(ushort);
+P00_QSORT_DECLARE_NATURAL(signed);
+P00_QSORT_DECLARE_NATURAL(unsigned);
+P00_QSORT_DECLARE_NATURAL(long);
+P00_QSORT_DECLARE_NATURAL(ulong);
+P00_QSORT_DECLARE_NATURAL(llong);
+P00_QSORT_DECLARE_NATURAL(ullong);
+P00_QSORT_DECLARE_NATURAL(float);
+P00_QSORT_DECLARE_NATURAL(double);
+P00_QSORT_DECLARE_NATURAL(ldouble);
 #ifndef __STDC_NO_COMPLEX__
 P00_QSORT_DECLARE(cfloat);
 P00_QSORT_DECLARE(cdouble);
@@ -529,6 +833,52 @@ errno_t p00_qsort_s(void *p00_base,
 #endif
 
 
+/**
+ ** @brief The comparison function for the natural order of the base
+ ** type of @a B.
+ **
+ ** The base type must be a real type that is supported by
+ ** ::P99_GENERIC. The function can be used with any sorting or
+ ** searching routine that has the interface of ::qsort_s, but
+ ** ::qsort_s itself recognizes it and then sorts with the @c <
+ ** operator directly. The partitioning then has no data dependent
+ ** branches and small partitions are sorted by a sorting network,
+ ** which is much faster than the general algorithm for random data.
+ **
+ ** @code
+ ** double tab[n];
+ ** ...
+ ** qsort_s(tab, n, sizeof tab[0], P99_NATURAL(tab), 0);
+ ** @endcode
+ **
+ ** For floating point types the result is unspecified if @a B
+ ** contains NaN.
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_NATURAL, 0)
+#define P99_NATURAL(B)                                         \
+  P99_GENERIC(&((B)[0]), ,                                     \
+            (float*, p99_natural_float),                       \
+            (double*, p99_natural_double),                     \
+            (ldouble*, p99_natural_ldouble),                   \
+            /* */                                              \
+            (char*, p99_natural_char),                         \
+            (uchar*, p99_natural_uchar),                       \
+            (schar*, p99_natural_schar),                       \
+            /* */                                              \
+            (ushort*, p99_natural_ushort),                     \
+            (short*, p99_natural_short),                       \
+            /* */                                              \
+            (unsigned*, p99_natural_unsigned),                 \
+            (signed*, p99_natural_signed),                     \
+            /* */                                              \
+            (long*, p99_natural_long),                         \
+            (ulong*, p99_natural_ulong),                       \
+            /* */                                              \
+            (llong*, p99_natural_llong),                       \
+            (ullong*, p99_natural_ullong)                      \
+              )
+
+
 /**
  ** @brief Check if the array passed in as @a p00_base is sorted and
  ** return the first mismatch if it is not.
@@ -0,0 +1,389 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_QSORT_PARALLEL_H
+#define P99_QSORT_PARALLEL_H
+
+#include "p99_qsort.h"
+#include "p99_topology.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/**
+ ** @brief The minimal number of elements per thread for
+ ** ::p99_qsort_parallel.
+ **
+ ** Ranges that are shorter than twice this are sorted sequentially.
+ **/
+#ifndef P99_QSORT_CUTOFF
+# define P99_QSORT_CUTOFF 65536u
+#endif
+
+P99_DECLARE_STRUCT(p00_qsort_par);
+
+/* The parameters that are common to all parts of a parallel sort. */
+struct p00_qsort_par {
+  unsigned char* p00_B;
+  rsize_t p00_a;
+  rsize_t p00_s;
+  int (*p00_comp)(const void *, const void *, void *);
+  void *p00_ctx;
+};
+
+P99_DECLARE_STRUCT(p00_qsort_task);
+
+/* The range [p00_bot, p00_top) is sorted by p00_nt threads. */
+struct p00_qsort_task {
+  p00_qsort_par const* p00_par;
+  size_t p00_bot;
+  size_t p00_top;
+  unsigned p00_nt;
+  errno_t p00_ret;
+};
+
+P99_DECLARE_STRUCT(p00_qsort_block);
+
+/* One block of a parallel partition, or one share of the swaps that
+   bring the misplaced elements to their side. */
+struct p00_qsort_block {
+  p00_qsort_par const* p00_par;
+  void const* p00_piv;
+  bool p00_le;
+  size_t p00_b;
+  size_t p00_e;
+  size_t p00_k;
+  size_t p00_n;
+  size_t const* p00_big;
+  size_t const* p00_small;
+};
+
+p99_inline
+void p00_qsort_par_swap(unsigned char* p00_x, unsigned char* p00_y, size_t p00_s) {
+  unsigned char p00_t[64];
+  for (size_t p00_i = 0; p00_i < p00_s; p00_i += sizeof p00_t) {
+    size_t const p00_l = (p00_s - p00_i < sizeof p00_t) ? p00_s - p00_i : sizeof p00_t;
+    memcpy(p00_t, p00_x + p00_i, p00_l);
+    memcpy(p00_x + p00_i, p00_y + p00_i, p00_l);
+    memcpy(p00_y + p00_i, p00_t, p00_l);
+  }
+}
+
+/* Does element p00_i go to the left of the pivot? */
+p99_inline
+bool p00_qsort_par_left(p00_qsort_block const* p00_bl, size_t p00_i) {
+  p00_qsort_par const* p00_par = p00_bl->p00_par;
+  int const p00_c = p00_par->p00_comp(p00_par->p00_B + p00_i*p00_par->p00_s, p00_bl->p00_piv, p00_par->p00_ctx);
+  return p00_bl->p00_le ? (p00_c <= 0) : (p00_c < 0);
+}
+
+/* Partition one block sequentially and count the elements that go
+   to the left. */
+P99_WEAK(p00_qsort_par_block)
+int p00_qsort_par_block(void* p00_arg) {
+  p00_qsort_block* p00_bl = p00_arg;
+  size_t const p00_s = p00_bl->p00_par->p00_s;
+  unsigned char* p00_B = p00_bl->p00_par->p00_B;
+  size_t p00_i = p00_bl->p00_b;
+  size_t p00_j = p00_bl->p00_e;
+  for (;;) {
+    while (p00_i < p00_j && p00_qsort_par_left(p00_bl, p00_i)) ++p00_i;
+    while (p00_i < p00_j && !p00_qsort_par_left(p00_bl, p00_j - 1)) --p00_j;
+    if (p00_i >= p00_j) break;
+    --p00_j;
+    p00_qsort_par_swap(p00_B + p00_i*p00_s, p00_B + p00_j*p00_s, p00_s);
+    ++p00_i;
+  }
+  p00_bl->p00_k = p00_i - p00_bl->p00_b;
+  return 0;
+}
+
+/* Find the position of the p00_j-th element in a list of intervals
+   that are given as pairs of bounds. */
+p99_inline
+size_t p00_qsort_par_locate(size_t const* p00_iv, size_t* p00_at, size_t p00_j) {
+  for (;; p00_at[0] += 2) {
+    size_t const p00_len = p00_iv[p00_at[0] + 1] - p00_iv[p00_at[0]];
+    if (p00_j < p00_len) return p00_iv[p00_at[0]] + p00_j;
+    p00_j -= p00_len;
+  }
+}
+
+/* Swap a share of the misplaced elements. p00_big and p00_small are
+   lists of intervals, terminated by an empty one. */
+P99_WEAK(p00_qsort_par_fix)
+int p00_qsort_par_fix(void* p00_arg) {
+  p00_qsort_block* p00_bl = p00_arg;
+  size_t const p00_s = p00_bl->p00_par->p00_s;
+  unsigned char* p00_B = p00_bl->p00_par->p00_B;
+  if (p00_bl->p00_b == p00_bl->p00_e) return 0;
+  size_t p00_ab = 0;
+  size_t p00_as = 0;
+  size_t p00_x = p00_qsort_par_locate(p00_bl->p00_big, &p00_ab, p00_bl->p00_b);
+  size_t p00_y = p00_qsort_par_locate(p00_bl->p00_small, &p00_as, p00_bl->p00_b);
+  for (size_t p00_j = p00_bl->p00_b; p00_j < p00_bl->p00_e; ++p00_j) {
+    if (p00_x == p00_bl->p00_big[p00_ab + 1]) {
+      p00_ab += 2;
+      p00_x = p00_bl->p00_big[p00_ab];
+    }
+    if (p00_y == p00_bl->p00_small[p00_as + 1]) {
+      p00_as += 2;
+      p00_y = p00_bl->p00_small[p00_as];
+    }
+    p00_qsort_par_swap(p00_B + p00_x*p00_s, p00_B + p00_y*p00_s, p00_s);
+    ++p00_x;
+    ++p00_y;
+  }
+  return 0;
+}
+
+/* Run p00_n instances of p00_f, all but the first in threads of
+   their own. If a thread can't be created, its part is done by the
+   calling thread. */
+p99_inline
+void p00_qsort_par_fork(thrd_start_t p00_f, p00_qsort_block* p00_bl, size_t p00_n) {
+  thrd_t p00_id[p00_n];
+  bool p00_run[p00_n];
+  for (size_t p00_i = 1; p00_i < p00_n; ++p00_i)
+    p00_run[p00_i] = thrd_create(&p00_id[p00_i], p00_f, &p00_bl[p00_i]) == thrd_success;
+  p00_f(&p00_bl[0]);
+  for (size_t p00_i = 1; p00_i < p00_n; ++p00_i) {
+    if (p00_run[p00_i]) thrd_join(p00_id[p00_i], 0);
+    else p00_f(&p00_bl[p00_i]);
+  }
+}
+
+/* Partition the range of p00_t around the pivot with all its threads.
+   Returns the number of elements that go to the left. */
+p99_inline
+size_t p00_qsort_par_partition(p00_qsort_task const* p00_t, void const* p00_piv, bool p00_le) {
+  size_t const p00_nt = p00_t->p00_nt;
+  size_t const p00_bot = p00_t->p00_bot;
+  size_t const p00_n = p00_t->p00_top - p00_bot;
+  p00_qsort_block p00_bl[p00_nt];
+  size_t p00_L = 0;
+  for (size_t p00_i = 0; p00_i < p00_nt; ++p00_i)
+    p00_bl[p00_i] = (p00_qsort_block) {
+      .p00_par = p00_t->p00_par,
+      .p00_piv = p00_piv,
+      .p00_le = p00_le,
+      .p00_b = p00_bot + (p00_n*p00_i)/p00_nt,
+      .p00_e = p00_bot + (p00_n*(p00_i + 1))/p00_nt,
+    };
+  p00_qsort_par_fork(p00_qsort_par_block, p00_bl, p00_nt);
+  for (size_t p00_i = 0; p00_i < p00_nt; ++p00_i) p00_L += p00_bl[p00_i].p00_k;
+  if (!p00_L || p00_L == p00_n) return p00_L;
+  /* Each block now has a left and a right part. The right parts that
+     lie below p00_mid must be exchanged with the left parts above. */
+  size_t const p00_mid = p00_bot + p00_L;
+  size_t p00_big[2*p00_nt + 2];
+  size_t p00_small[2*p00_nt + 2];
+  size_t p00_nb = 0;
+  size_t p00_ns = 0;
+  size_t p00_M = 0;
+  for (size_t p00_i = 0; p00_i < p00_nt; ++p00_i) {
+    size_t const p00_b = p00_bl[p00_i].p00_b;
+    size_t const p00_k = p00_b + p00_bl[p00_i].p00_k;
+    size_t const p00_e = p00_bl[p00_i].p00_e;
+    if (p00_k < p00_mid && p00_k < p00_e) {
+      p00_big[p00_nb++] = p00_k;
+      p00_big[p00_nb++] = (p00_e < p00_mid) ? p00_e : p00_mid;
+      p00_M += p00_big[p00_nb - 1] - p00_k;
+    }
+    if (p00_k > p00_mid && p00_b < p00_k) {
+      p00_small[p00_ns++] = (p00_b > p00_mid) ? p00_b : p00_mid;
+      p00_small[p00_ns++] = p00_k;
+    }
+  }
+  p00_big[p00_nb] = p00_big[p00_nb + 1] = 0;
+  p00_small[p00_ns] = p00_small[p00_ns + 1] = 0;
+  for (size_t p00_i = 0; p00_i < p00_nt; ++p00_i) {
+    p00_bl[p00_i].p00_b = (p00_M*p00_i)/p00_nt;
+    p00_bl[p00_i].p00_e = (p00_M*(p00_i + 1))/p00_nt;
+    p00_bl[p00_i].p00_big = p00_big;
+    p00_bl[p00_i].p00_small = p00_small;
+  }
+  if (p00_M) p00_qsort_par_fork(p00_qsort_par_fix, p00_bl, p00_nt);
+  return p00_L;
+}
+
+/* Sort the range of a task, either sequentially or by partitioning it
+   with all threads and then splitting the threads among the two
+   parts. */
+P99_WEAK(p00_qsort_par_run)
+int p00_qsort_par_run(void* p00_arg) {
+  p00_qsort_task* p00_t = p00_arg;
+  p00_qsort_par const* p00_par = p00_t->p00_par;
+  size_t const p00_n = p00_t->p00_top - p00_t->p00_bot;
+  size_t const p00_s = p00_par->p00_s;
+  if (p00_t->p00_nt < 2 || p00_n < 2*P99_QSORT_CUTOFF) {
+    p00_t->p00_ret = p00_qsort_s(p00_par->p00_B + p00_t->p00_bot*p00_s, p00_n,
+                                 p00_par->p00_a, p00_s, p00_par->p00_comp, p00_par->p00_ctx);
+    return 0;
+  }
+  if ((p00_n/P99_QSORT_CUTOFF) < p00_t->p00_nt) p00_t->p00_nt = p00_n/P99_QSORT_CUTOFF;
+  /* The pivot is the median of the medians of three groups of three
+     samples. It is copied, since the elements will move. */
+  size_t p00_c[9];
+  for (size_t p00_i = 0; p00_i < 9; ++p00_i)
+    p00_c[p00_i] = p00_t->p00_bot + ((2*p00_i + 1)*p00_n)/18;
+#define P00_QPAR_COMP(A, B) p00_par->p00_comp(p00_par->p00_B + (A)*p00_s, p00_par->p00_B + (B)*p00_s, p00_par->p00_ctx)
+#define P00_QPAR_MED(A, B, C)                                          \
+  (P00_QPAR_COMP(A, B) < 0                                             \
+   ? (P00_QPAR_COMP(B, C) < 0 ? (B) : (P00_QPAR_COMP(A, C) < 0 ? (C) : (A))) \
+   : (P00_QPAR_COMP(A, C) < 0 ? (A) : (P00_QPAR_COMP(B, C) < 0 ? (C) : (B))))
+  size_t const p00_m0 = P00_QPAR_MED(p00_c[0], p00_c[1], p00_c[2]);
+  size_t const p00_m1 = P00_QPAR_MED(p00_c[3], p00_c[4], p00_c[5]);
+  size_t const p00_m2 = P00_QPAR_MED(p00_c[6], p00_c[7], p00_c[8]);
+  size_t const p00_m = P00_QPAR_MED(p00_m0, p00_m1, p00_m2);
+#undef P00_QPAR_MED
+#undef P00_QPAR_COMP
+  max_align_t p00_piv[(p00_s + sizeof(max_align_t) - 1)/sizeof(max_align_t)];
+  memcpy(p00_piv, p00_par->p00_B + p00_m*p00_s, p00_s);
+  size_t p00_L = p00_qsort_par_partition(p00_t, p00_piv, false);
+  if (!p00_L) {
+    /* Nothing is smaller than the pivot, so put the equal ones to the
+       left. If that is all, the range is constant. */
+    p00_L = p00_qsort_par_partition(p00_t, p00_piv, true);
+    if (p00_L == p00_n) {
+      p00_t->p00_ret = 0;
+      return 0;
+    }
+  }
+  /* The threads are shared in proportion to the sizes. */
+  unsigned p00_ntl = ((double)p00_t->p00_nt*p00_L)/p00_n + 0.5;
+  if (p00_ntl < 1) p00_ntl = 1;
+  if (p00_ntl >= p00_t->p00_nt) p00_ntl = p00_t->p00_nt - 1;
+  p00_qsort_task p00_sub[2] = {
+    { .p00_par = p00_par, .p00_bot = p00_t->p00_bot, .p00_top = p00_t->p00_bot + p00_L, .p00_nt = p00_ntl, },
+    { .p00_par = p00_par, .p00_bot = p00_t->p00_bot + p00_L, .p00_top = p00_t->p00_top, .p00_nt = p00_t->p00_nt - p00_ntl, },
+  };
+  thrd_t p00_id;
+  bool const p00_run = thrd_create(&p00_id, p00_qsort_par_run, &p00_sub[0]) == thrd_success;
+  p00_qsort_par_run(&p00_sub[1]);
+  if (p00_run) thrd_join(p00_id, 0);
+  else p00_qsort_par_run(&p00_sub[0]);
+  p00_t->p00_ret = p00_sub[0].p00_ret ? p00_sub[0].p00_ret : p00_sub[1].p00_ret;
+  return 0;
+}
+
+p99_inline
+errno_t p00_qsort_parallel(void *p00_base,
+                           rsize_t p00_n,
+                           rsize_t p00_a,
+                           rsize_t p00_s,
+                           int (*p00_comp)(const void *, const void *, void *),
+                           void *p00_ctx,
+                           unsigned p00_nt) {
+  if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;
+  if (p00_n && (!p00_base || !p00_comp)) return EINVAL;
+  p00_qsort_par const p00_par = {
+    .p00_B = p00_base,
+    .p00_a = p00_a,
+    .p00_s = p00_s,
+    .p00_comp = p00_comp,
+    .p00_ctx = p00_ctx,
+  };
+  p00_qsort_task p00_t = {
+    .p00_par = &p00_par,
+    .p00_bot = 0,
+    .p00_top = p00_n,
+    .p00_nt = p00_nt ? p00_nt : p99_topology_get()->p99_cpus,
+  };
+  p00_qsort_par_run(&p00_t);
+  return p00_t.p00_ret;
+}
+
+/**
+ ** @brief Sort an array with several threads.
+ **
+ ** The interface is the same as for @c qsort_s. The array is split by
+ ** partitioning it around a pivot, where all threads partition a
+ ** block of the array each, and then exchange the elements that are
+ ** on the wrong side of the blocks. The threads are then split among
+ ** the two parts in proportion to their sizes, until each part has
+ ** only one thread or fewer than twice ::P99_QSORT_CUTOFF
+ ** elements. These parts are then sorted with the sequential
+ ** algorithm of @c qsort_s, with the alignment that can be deduced
+ ** from @a p00_base and @a p00_s.
+ **
+ ** @param p00_nt is the maximal number of threads that are used. It
+ ** defaults to @c 0, which stands for the number of CPUs as given by
+ ** ::p99_topology_get.
+ **
+ ** @warning Other than for @c qsort_s, @a p00_comp is called from
+ ** several threads at the same time, with the same @a p00_ctx. So
+ ** the comparison function must be reentrant, and the object to which
+ ** @a p00_ctx points must be safe to be read concurrently. In
+ ** particular, don't use it to count comparisons or for any other
+ ** modification without proper synchronization.
+ **
+ ** @see P99_QSORT_PARALLEL for a type generic macro that takes the
+ ** alignment from the base type.
+ **/
+P99_DEFARG_DOCU(p99_qsort_parallel)
+p99_inline
+errno_t p99_qsort_parallel(void *p00_base,
+                           rsize_t p00_n,
+                           rsize_t p00_s,
+                           int (*p00_comp)(const void *, const void *, void *),
+                           void *p00_ctx,
+                           unsigned p00_nt) {
+  /* The alignment that we may assume from the base and the size. */
+  rsize_t p00_a = ((uintptr_t)p00_base | p00_s) & -((uintptr_t)p00_base | p00_s);
+  if (p00_a > sizeof(max_align_t)) p00_a = sizeof(max_align_t);
+  return p00_qsort_parallel(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_nt);
+}
+
+#ifndef DOXYGEN
+#define p99_qsort_parallel(...) P99_CALL_DEFARG(p99_qsort_parallel, 6, __VA_ARGS__)
+#define p99_qsort_parallel_defarg_5() 0U
+#endif
+
+/**
+ ** @brief A type generic parallel sorting routine.
+ **
+ ** This has the same interface as @c qsort_s. The alignment of the
+ ** base type of @a B is used to choose the most efficient way to
+ ** move elements around. An optional sixth argument gives the
+ ** maximal number of threads, as for ::p99_qsort_parallel.
+ **
+ ** @warning The comparison function must be reentrant and @a CTX
+ ** must be safe to be read concurrently, see ::p99_qsort_parallel.
+ **
+ ** @see p99_qsort_parallel
+ **/
+#define P99_QSORT_PARALLEL(...)                                                 \
+P99_IF_LT(P99_NARG(__VA_ARGS__), 6)                                             \
+(P00_QSORT_PARALLEL(__VA_ARGS__, 0U))                                           \
+(P00_QSORT_PARALLEL(__VA_ARGS__))
+
+#define P00_QSORT_PARALLEL(B, N, S, CMP, CTX, NT)                               \
+  P99_CONSTRAINT_TRIGGER(                                                       \
+  p00_qsort_parallel((B), (N), P99_ALIGNOF((B)[0]), (S), (CMP), (CTX), (NT)),   \
+  "p99_qsort_parallel runtime constraint violation")
+
+/**
+ ** @}
+ **/
+
+#endif
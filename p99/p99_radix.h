@@ -0,0 +1,454 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_RADIX_H
+#define P99_RADIX_H 1
+
+#include "p99_qsort.h"
+#include <float.h>
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/* Arrays below this size are sorted by insertion. */
+#define P00_RADIX_INSERTION 48u
+
+/* The number of buckets of one pass, one for each byte value. */
+#define P00_RADIX_BUCKETS (UCHAR_MAX + 1u)
+
+/* Each arithmetic type is mapped to a sequence of digits, one per
+   byte of its representation, such that the order of the values is
+   the lexicographic order of the digits, most significant first. The
+   function for type T returns digit number D, counted from the least
+   significant one. */
+
+#define P00_RADIX_UNSIGNED(T)                                           \
+p99_inline                                                              \
+unsigned P99_PASTE2(p00_radix_digit_, T)(T p00_x, unsigned p00_d) {     \
+  return (p00_x >> (p00_d*CHAR_BIT)) & UCHAR_MAX;                       \
+}                                                                       \
+P99_MACRO_END(p00_radix_digit_, T)
+
+/* For signed types the sign bit is flipped, such that negative
+   values come first. */
+#define P00_RADIX_SIGNED(T, U)                                          \
+p99_inline                                                              \
+unsigned P99_PASTE2(p00_radix_digit_, T)(T p00_x, unsigned p00_d) {     \
+  U const p00_u = (U)p00_x ^ (U)~((U)-1 >> 1);                          \
+  return (p00_u >> (p00_d*CHAR_BIT)) & UCHAR_MAX;                       \
+}                                                                       \
+P99_MACRO_END(p00_radix_digit_, T)
+
+/* For the IEEE binary formats all bits of a negative value are
+   flipped, and only the sign bit of a positive one. So -0.0 comes
+   before +0.0, NaN with the sign bit set come first and the others
+   last. */
+#define P00_RADIX_FLOATING(T, U)                                        \
+p99_inline                                                              \
+U P99_PASTE2(p00_radix_key_, T)(T p00_x) {                              \
+  U p00_u;                                                              \
+  memcpy(&p00_u, &p00_x, sizeof p00_u);                                 \
+  U const p00_sign = (U)~((U)-1 >> 1);                                  \
+  return (p00_u & p00_sign) ? (U)~p00_u : (U)(p00_u | p00_sign);        \
+}                                                                       \
+p99_inline                                                              \
+unsigned P99_PASTE2(p00_radix_digit_, T)(T p00_x, unsigned p00_d) {     \
+  return (P99_PASTE2(p00_radix_key_, T)(p00_x) >> (p00_d*CHAR_BIT)) & UCHAR_MAX; \
+}                                                                       \
+P99_MACRO_END(p00_radix_digit_, T)
+
+P00_RADIX_UNSIGNED(_Bool);
+P00_RADIX_UNSIGNED(uchar);
+P00_RADIX_SIGNED(schar, uchar);
+#if CHAR_MIN < 0
+P00_RADIX_SIGNED(char, uchar);
+#else
+P00_RADIX_UNSIGNED(char);
+#endif
+P00_RADIX_UNSIGNED(ushort);
+P00_RADIX_SIGNED(short, ushort);
+P00_RADIX_UNSIGNED(unsigned);
+P00_RADIX_SIGNED(signed, unsigned);
+P00_RADIX_UNSIGNED(ulong);
+P00_RADIX_SIGNED(long, ulong);
+P00_RADIX_UNSIGNED(ullong);
+P00_RADIX_SIGNED(llong, ullong);
+
+/* Pointers are ordered by their address. */
+p99_inline
+unsigned p00_radix_digit_void_ptr(void_ptr p00_x, unsigned p00_d) {
+  return ((uintptr_t)p00_x >> (p00_d*CHAR_BIT)) & UCHAR_MAX;
+}
+
+#if FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128
+P00_RADIX_FLOATING(float, uint32_t);
+#endif
+#if DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024
+P00_RADIX_FLOATING(double, uint64_t);
+#endif
+
+/* The number of digits of a long double. If it has the same format
+   as double it is sorted as such. Otherwise, the x87 extended format
+   has 10 significant bytes and the binary128 format has 16, both
+   with the sign in the highest bit. */
+#if LDBL_MANT_DIG == DBL_MANT_DIG && LDBL_MAX_EXP == DBL_MAX_EXP
+# define P00_RADIX_LDBL sizeof(double)
+p99_inline
+unsigned p00_radix_digit_ldouble(ldouble p00_x, unsigned p00_d) {
+  return p00_radix_digit_double(p00_x, p00_d);
+}
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# if LDBL_MANT_DIG == 64 && LDBL_MAX_EXP == 16384 && CHAR_BIT == 8
+#  define P00_RADIX_LDBL 10u
+# elif LDBL_MANT_DIG == 113 && LDBL_MAX_EXP == 16384 && CHAR_BIT == 8
+#  define P00_RADIX_LDBL 16u
+# endif
+# ifdef P00_RADIX_LDBL
+p99_inline
+unsigned p00_radix_digit_ldouble(ldouble p00_x, unsigned p00_d) {
+  unsigned char p00_b[sizeof p00_x];
+  memcpy(p00_b, &p00_x, sizeof p00_b);
+  unsigned const p00_v = p00_b[p00_d];
+  if (p00_b[P00_RADIX_LDBL - 1] >> (CHAR_BIT - 1)) return ~p00_v & UCHAR_MAX;
+  else return (p00_d == P00_RADIX_LDBL - 1) ? p00_v ^ (1u << (CHAR_BIT - 1)) : p00_v;
+}
+# endif
+#endif
+
+/* Complex values are ordered lexicographically, first by the real
+   and then by the imaginary part. Their representation is that of
+   an array of two reals. */
+#ifndef __STDC_NO_COMPLEX__
+# define P00_RADIX_COMPLEX(T, R, N)                                     \
+p99_inline                                                              \
+unsigned P99_PASTE2(p00_radix_digit_, T)(T p00_x, unsigned p00_d) {     \
+  R p00_p[2];                                                           \
+  memcpy(p00_p, &p00_x, sizeof p00_p);                                  \
+  return (p00_d < (N))                                                  \
+    ? P99_PASTE2(p00_radix_digit_, R)(p00_p[1], p00_d)                  \
+    : P99_PASTE2(p00_radix_digit_, R)(p00_p[0], p00_d - (N));           \
+}                                                                       \
+P99_MACRO_END(p00_radix_digit_, T)
+# if FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128
+P00_RADIX_COMPLEX(cfloat, float, sizeof(float));
+# endif
+# if DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024
+P00_RADIX_COMPLEX(cdouble, double, sizeof(double));
+# endif
+# ifdef P00_RADIX_LDBL
+P00_RADIX_COMPLEX(cldouble, ldouble, P00_RADIX_LDBL);
+# endif
+#endif
+
+/* Sort the array p00_base of type T with an LSD radix sort, one pass
+   per digit. The counts for all passes are taken in one sweep, and
+   passes where all elements have the same digit are skipped. If
+   p00_ps is not 0, p00_pay is an array of p00_n elements of that
+   size that is permuted along. */
+#define P00_RADIX_BODY(T, D, DIGIT)                                                     \
+if (p00_n > RSIZE_MAX || p00_ps > RSIZE_MAX) return EDOM;                               \
+if (p00_n && (!p00_base || (p00_ps && !p00_pay))) return EINVAL;                        \
+do {                                                                                    \
+  if (p00_n < 2) return 0;                                                              \
+  unsigned char *const p00_P = p00_pay;                                                 \
+  if (p00_n < P00_RADIX_INSERTION) {                                                    \
+    unsigned char p00_tmp[p00_ps + 1];                                                  \
+    for (register size_t p00_i = 1; p00_i < p00_n; ++p00_i) {                           \
+      T const p00_x = p00_base[p00_i];                                                  \
+      register size_t p00_j = p00_i;                                                    \
+      for (; p00_j; --p00_j) {                                                          \
+        register unsigned p00_d = (D);                                                  \
+        while (p00_d-- > 1 && DIGIT(p00_x, p00_d) == DIGIT(p00_base[p00_j - 1], p00_d)); \
+        if (!(DIGIT(p00_x, p00_d) < DIGIT(p00_base[p00_j - 1], p00_d))) break;          \
+      }                                                                                 \
+      if (p00_j == p00_i) continue;                                                     \
+      memmove(p00_base + p00_j + 1, p00_base + p00_j, (p00_i - p00_j)*sizeof(T));       \
+      p00_base[p00_j] = p00_x;                                                          \
+      if (p00_ps) {                                                                     \
+        memcpy(p00_tmp, p00_P + p00_i*p00_ps, p00_ps);                                  \
+        memmove(p00_P + (p00_j + 1)*p00_ps, p00_P + p00_j*p00_ps, (p00_i - p00_j)*p00_ps); \
+        memcpy(p00_P + p00_j*p00_ps, p00_tmp, p00_ps);                                  \
+      }                                                                                 \
+    }                                                                                   \
+    return 0;                                                                           \
+  }                                                                                     \
+  size_t p00_c[(D)][P00_RADIX_BUCKETS] = { 0 };                                         \
+  for (register size_t p00_i = 0; p00_i < p00_n; ++p00_i)                               \
+    for (register unsigned p00_d = 0; p00_d < (D); ++p00_d)                             \
+      ++p00_c[p00_d][DIGIT(p00_base[p00_i], p00_d)];                                    \
+  T *const p00_buf = malloc(p00_n*sizeof(T));                                           \
+  unsigned char *const p00_pbuf = p00_ps ? malloc(p00_n*p00_ps) : 0;                    \
+  if (!p00_buf || (p00_ps && !p00_pbuf)) {                                              \
+    free(p00_buf);                                                                      \
+    free(p00_pbuf);                                                                     \
+    return ENOMEM;                                                                      \
+  }                                                                                     \
+  T *p00_src = p00_base;                                                                \
+  T *p00_dst = p00_buf;                                                                 \
+  unsigned char *p00_psrc = p00_P;                                                      \
+  unsigned char *p00_pdst = p00_pbuf;                                                   \
+  for (register unsigned p00_d = 0; p00_d < (D); ++p00_d) {                             \
+    size_t *const p00_cd = p00_c[p00_d];                                                \
+    if (p00_cd[DIGIT(p00_src[0], p00_d)] == p00_n) continue;                            \
+    for (register size_t p00_k = 0, p00_sum = 0; p00_k < P00_RADIX_BUCKETS; ++p00_k) {  \
+      register size_t const p00_v = p00_cd[p00_k];                                      \
+      p00_cd[p00_k] = p00_sum;                                                          \
+      p00_sum += p00_v;                                                                 \
+    }                                                                                   \
+    if (p00_ps) {                                                                       \
+      for (register size_t p00_i = 0; p00_i < p00_n; ++p00_i) {                         \
+        register size_t const p00_j = p00_cd[DIGIT(p00_src[p00_i], p00_d)]++;           \
+        p00_dst[p00_j] = p00_src[p00_i];                                                \
+        memcpy(p00_pdst + p00_j*p00_ps, p00_psrc + p00_i*p00_ps, p00_ps);               \
+      }                                                                                 \
+      unsigned char *const p00_pt = p00_psrc;                                           \
+      p00_psrc = p00_pdst;                                                              \
+      p00_pdst = p00_pt;                                                                \
+    } else {                                                                            \
+      for (register size_t p00_i = 0; p00_i < p00_n; ++p00_i)                           \
+        p00_dst[p00_cd[DIGIT(p00_src[p00_i], p00_d)]++] = p00_src[p00_i];               \
+    }                                                                                   \
+    T *const p00_t = p00_src;                                                           \
+    p00_src = p00_dst;                                                                  \
+    p00_dst = p00_t;                                                                    \
+  }                                                                                     \
+  if (p00_src != p00_base) {                                                            \
+    memcpy(p00_base, p00_src, p00_n*sizeof(T));                                         \
+    if (p00_ps) memcpy(p00_P, p00_psrc, p00_n*p00_ps);                                  \
+  }                                                                                     \
+  free(p00_buf);                                                                        \
+  free(p00_pbuf);                                                                       \
+  return 0;                                                                             \
+ } while (false)
+
+#define P00_RADIX_DECLARE(T, D)                                         \
+p99_inline                                                              \
+errno_t P99_PASTE2(p00_radix_, T)(T *p00_base,                          \
+                                  rsize_t p00_n,                        \
+                                  void *p00_pay,                        \
+                                  rsize_t p00_ps) {                     \
+  P00_RADIX_BODY(T, D, P99_PASTE2(p00_radix_digit_, T));                \
+}                                                                       \
+P99_MACRO_END(p00_radix_, T)
+
+/* A floating type with an unknown representation can't be sorted
+   this way. */
+#define P00_RADIX_UNSUPPORTED(T)                                        \
+p99_inline                                                              \
+errno_t P99_PASTE2(p00_radix_, T)(T *p00_base,                          \
+                                  rsize_t p00_n,                        \
+                                  void *p00_pay,                        \
+                                  rsize_t p00_ps) {                     \
+  P99_UNUSED(p00_base);                                                 \
+  P99_UNUSED(p00_n);                                                    \
+  P99_UNUSED(p00_pay);                                                  \
+  P99_UNUSED(p00_ps);                                                   \
+  return EINVAL;                                                        \
+}                                                                       \
+P99_MACRO_END(p00_radix_, T)
+
+P00_RADIX_DECLARE(_Bool, sizeof(_Bool));
+P00_RADIX_DECLARE(char, sizeof(char));
+P00_RADIX_DECLARE(uchar, sizeof(uchar));
+P00_RADIX_DECLARE(schar, sizeof(schar));
+P00_RADIX_DECLARE(ushort, sizeof(ushort));
+P00_RADIX_DECLARE(short, sizeof(short));
+P00_RADIX_DECLARE(unsigned, sizeof(unsigned));
+P00_RADIX_DECLARE(signed, sizeof(signed));
+P00_RADIX_DECLARE(ulong, sizeof(ulong));
+P00_RADIX_DECLARE(long, sizeof(long));
+P00_RADIX_DECLARE(ullong, sizeof(ullong));
+P00_RADIX_DECLARE(llong, sizeof(llong));
+P00_RADIX_DECLARE(void_ptr, sizeof(void_ptr));
+#if FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128
+P00_RADIX_DECLARE(float, sizeof(float));
+#else
+P00_RADIX_UNSUPPORTED(float);
+#endif
+#if DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024
+P00_RADIX_DECLARE(double, sizeof(double));
+#else
+P00_RADIX_UNSUPPORTED(double);
+#endif
+#ifdef P00_RADIX_LDBL
+P00_RADIX_DECLARE(ldouble, P00_RADIX_LDBL);
+#else
+P00_RADIX_UNSUPPORTED(ldouble);
+#endif
+#ifndef __STDC_NO_COMPLEX__
+# if FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128
+P00_RADIX_DECLARE(cfloat, 2*sizeof(float));
+# else
+P00_RADIX_UNSUPPORTED(cfloat);
+# endif
+# if DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024
+P00_RADIX_DECLARE(cdouble, 2*sizeof(double));
+# else
+P00_RADIX_UNSUPPORTED(cdouble);
+# endif
+# ifdef P00_RADIX_LDBL
+P00_RADIX_DECLARE(cldouble, 2*P00_RADIX_LDBL);
+# else
+P00_RADIX_UNSUPPORTED(cldouble);
+# endif
+#endif
+
+#ifdef __STDC_NO_COMPLEX__
+#define P00_RADIX_SORT(B)                                      \
+  P99_GENERIC(&((B)[0]), ,                                     \
+            (void_ptr*, p00_radix_void_ptr),                   \
+            /* */                                              \
+            (float*, p00_radix_float),                         \
+            (double*, p00_radix_double),                       \
+            /* */                                              \
+            (_Bool*, p00_radix__Bool),                         \
+            (char*, p00_radix_char),                           \
+            (uchar*, p00_radix_uchar),                         \
+            (schar*, p00_radix_schar),                         \
+            /* */                                              \
+            (ushort*, p00_radix_ushort),                       \
+            (short*, p00_radix_short),                         \
+            /* */                                              \
+            (unsigned*, p00_radix_unsigned),                   \
+            (signed*, p00_radix_signed),                       \
+            /* */                                              \
+            (long*, p00_radix_long),                           \
+            (ulong*, p00_radix_ulong),                         \
+            /* */                                              \
+            (llong*, p00_radix_llong),                         \
+            (ullong*, p00_radix_ullong)                        \
+              )
+#else
+#define P00_RADIX_SORT(B)                                      \
+  P99_GENERIC(&((B)[0]), ,                                     \
+            (void_ptr*, p00_radix_void_ptr),                   \
+            /* */                                              \
+            (float*, p00_radix_float),                         \
+            (double*, p00_radix_double),                       \
+            (ldouble*, p00_radix_ldouble),                     \
+            /* */                                              \
+            (cfloat*, p00_radix_cfloat),                       \
+            (cdouble*, p00_radix_cdouble),                     \
+            (cldouble*, p00_radix_cldouble),                   \
+            /* */                                              \
+            (_Bool*, p00_radix__Bool),                         \
+            (char*, p00_radix_char),                           \
+            (uchar*, p00_radix_uchar),                         \
+            (schar*, p00_radix_schar),                         \
+            /* */                                              \
+            (ushort*, p00_radix_ushort),                       \
+            (short*, p00_radix_short),                         \
+            /* */                                              \
+            (unsigned*, p00_radix_unsigned),                   \
+            (signed*, p00_radix_signed),                       \
+            /* */                                              \
+            (long*, p00_radix_long),                           \
+            (ulong*, p00_radix_ulong),                         \
+            /* */                                              \
+            (llong*, p00_radix_llong),                         \
+            (ullong*, p00_radix_ullong)                        \
+              )
+#endif
+
+/**
+ ** @brief Sort the array @a B of @a N elements in the natural order
+ ** of its base type.
+ **
+ ** This is an LSD radix sort for all the arithmetic types that are
+ ** handled by ::qsort_s, and for @c void*. It uses no comparison
+ ** function, but one pass over the array per byte of the base type,
+ ** and a temporary buffer of the size of the array. Its prototype if
+ ** it were not implemented as a type generic macro, would be:
+ **
+ ** @code
+ ** errno_t p99_radix_sort(T *base, rsize_t nmemb);
+ ** @endcode
+ **
+ ** Signed integers and floating point values are mapped to unsigned
+ ** keys that preserve their order. For floating point this is the
+ ** total order of the representation, that is -0.0 comes before
+ ** +0.0, and NaN are put at the beginning or the end according to
+ ** their sign bit. Complex values are ordered by their real part and
+ ** then by their imaginary part. Pointers are ordered by their
+ ** address.
+ **
+ ** The sort is stable, and if the buffer can't be allocated it
+ ** fails with @c ENOMEM. For a floating type that doesn't have one
+ ** of the IEEE formats it fails with @c EINVAL.
+ **
+ ** @see p99_radix_sort_payload to permute a second array along
+ ** @see P99_RADIX_ASORT
+ **/
+#define p99_radix_sort(B, N)                                   \
+  P99_CONSTRAINT_TRIGGER(                                      \
+  P00_RADIX_SORT(B)((B), (N), 0, 0),                           \
+  "p99_radix_sort runtime constraint violation")
+
+/**
+ ** @brief Sort the array @a B of @a N keys in the natural order of
+ ** its base type, and permute the array @a P in the same way.
+ **
+ ** @a P must have at least @a N elements, of any type. So this can
+ ** be used to sort records by a key that is stored apart, or to
+ ** compute the sorting permutation by sorting an array of indices
+ ** along.
+ **
+ ** @see p99_radix_sort
+ **/
+#define p99_radix_sort_payload(B, N, P)                        \
+  P99_CONSTRAINT_TRIGGER(                                      \
+  P00_RADIX_SORT(B)((B), (N), (P), sizeof (P)[0]),             \
+  "p99_radix_sort runtime constraint violation")
+
+/**
+ ** @brief Radix sort the first @a NB elements of @a TAB, and
+ ** optionally permute a payload array along.
+ **
+ ** @see p99_radix_sort
+ ** @see p99_radix_sort_payload
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_RADIX_SORT, 0)
+#define P99_RADIX_SORT(TAB, ...)                               \
+P99_IF_LT(P99_NARG(__VA_ARGS__), 2)                            \
+(p99_radix_sort((TAB), __VA_ARGS__))                           \
+(p99_radix_sort_payload((TAB), __VA_ARGS__))
+
+/**
+ ** @brief Radix sort the array @a TAB, and optionally permute a
+ ** payload array along.
+ **
+ ** The analogue of ::P99_ASORT without comparison function.
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_RADIX_ASORT, 0)
+#define P99_RADIX_ASORT(...)                                   \
+P99_IF_LT(P99_NARG(__VA_ARGS__), 2)                            \
+(P00_RADIX_ASORT1(__VA_ARGS__))                                \
+(P00_RADIX_ASORT2(__VA_ARGS__))
+
+#define P00_RADIX_ASORT1(TAB) p99_radix_sort((TAB), P99_ALEN(TAB))
+#define P00_RADIX_ASORT2(TAB, P) p99_radix_sort_payload((TAB), P99_ALEN(TAB), (P))
+
+/**
+ ** @}
+ **/
+
+#endif
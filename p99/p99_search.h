@@ -0,0 +1,333 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_SEARCH_H
+#define P99_SEARCH_H 1
+
+#include "p99_qsort.h"
+#include "p99_generic.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/* An address that is only used as a hint. Computing it as an integer
+   avoids pointer arithmetic beyond the array. */
+#define P00_SEARCH_HINT(B, OFF) ((void const*)((uintptr_t)(B) + (OFF)))
+
+p99_inline
+void *p00_bsearch_branchless(char const* p00_file, char const* p00_context,
+                             const void *p00_key, const void *p00_base,
+                             rsize_t p00_nmemb, rsize_t p00_size,
+                             int (*p00_compar)(const void *, const void *, void *),
+                             void *p00_ctx) {
+  if (p00_nmemb) {
+    if (p00_nmemb > RSIZE_MAX || p00_size > RSIZE_MAX) {
+      p00_constraint_call(EDOM, p00_file, p00_context, "p99_bsearch_branchless runtime constraint violation");
+    } else if (!p00_key || !p00_base || !p00_compar) {
+      p00_constraint_call(EINVAL, p00_file, p00_context, "p99_bsearch_branchless runtime constraint violation");
+    } else {
+      register unsigned char const* p00_f = p00_base;
+      /* All elements before p00_f are less than the key. */
+      for (register size_t p00_len = p00_nmemb; p00_len > 1;) {
+        register size_t const p00_h = p00_len/2;
+        p00_len -= p00_h;
+        /* The middle elements of both halves for the next step. */
+        P99_PREFETCH(P00_SEARCH_HINT(p00_f, (p00_len/2 - 1)*p00_size));
+        P99_PREFETCH(P00_SEARCH_HINT(p00_f, (p00_h + p00_len/2 - 1)*p00_size));
+        p00_f += (p00_compar(p00_f + (p00_h - 1)*p00_size, p00_key, p00_ctx) < 0) ? p00_h*p00_size : 0;
+      }
+      register int p00_c = p00_compar(p00_f, p00_key, p00_ctx);
+      if (p00_c < 0 && p00_f + p00_size < (unsigned char const*)p00_base + p00_nmemb*p00_size) {
+        p00_f += p00_size;
+        p00_c = p00_compar(p00_f, p00_key, p00_ctx);
+      }
+      if (!p00_c) return (void*)p00_f;
+    }
+  }
+  return 0;
+}
+
+/**
+ ** @brief A binary search without unpredictable branches.
+ **
+ ** This has the same interface as @c bsearch_s and also the same
+ ** runtime constraints, but if there are several matching elements
+ ** it returns the first. Other than @c bsearch_s it doesn't stop
+ ** when it hits a matching element, but always halves the search
+ ** range. So the number of steps only depends on @c nmemb, and the
+ ** choice of the half is a conditional move instead of a branch.
+ ** The candidates for the next step are prefetched, such that their
+ ** loads overlap with the comparison.
+ **
+ ** For large arrays the accesses of the first steps still miss the
+ ** cache. If a table is searched often, ::p99_eytzinger_search or
+ ** ::p99_stree_search are better choices.
+ **/
+#define p99_bsearch_branchless(...) p00_bsearch_branchless(P99_STRINGIFY(__LINE__), __func__, __VA_ARGS__)
+
+/**
+ ** @brief Copy the sorted array @a p00_src to @a p00_dst in
+ ** Eytzinger order.
+ **
+ ** This is the order of a complete binary search tree that is stored
+ ** as a heap: the children of the element at position @c i are at
+ ** positions @c 2i+1 and @c 2i+2. The first levels of the tree are
+ ** then at the start of the array and are shared by all searches, so
+ ** they stay in the cache.
+ **
+ ** @return @c EINVAL if a pointer is null or the arrays overlap, @c
+ ** EDOM if a size is larger than @c RSIZE_MAX, @c 0 otherwise.
+ **
+ ** @see p99_eytzinger_search
+ **/
+p99_inline
+errno_t p99_eytzinger_s(void *p00_dst, void const* p00_src,
+                        rsize_t p00_n, rsize_t p00_s) {
+  if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;
+  if (!p00_n) return 0;
+  if (!p00_dst || !p00_src) return EINVAL;
+  unsigned char* p00_D = p00_dst;
+  unsigned char const* p00_S = p00_src;
+  if (p00_D < p00_S + p00_n*p00_s && p00_S < p00_D + p00_n*p00_s) return EINVAL;
+  /* An in order traversal of the tree, with 1 based positions: the
+     leftmost node, then the leftmost node of the right subtree or
+     the first ancestor of which this is in the left subtree. */
+  register size_t p00_k = 1;
+  while (2*p00_k <= p00_n) p00_k *= 2;
+  for (register size_t p00_i = 0; p00_i < p00_n; ++p00_i) {
+    memcpy(p00_D + (p00_k - 1)*p00_s, p00_S + p00_i*p00_s, p00_s);
+    if (2*p00_k + 1 <= p00_n) {
+      p00_k = 2*p00_k + 1;
+      while (2*p00_k <= p00_n) p00_k *= 2;
+    } else {
+      while (p00_k & 1) p00_k /= 2;
+      p00_k /= 2;
+    }
+  }
+  return 0;
+}
+
+p99_inline
+void *p00_eytzinger_search(char const* p00_file, char const* p00_context,
+                           const void *p00_key, const void *p00_base,
+                           rsize_t p00_nmemb, rsize_t p00_size,
+                           int (*p00_compar)(const void *, const void *, void *),
+                           void *p00_ctx) {
+  if (p00_nmemb) {
+    if (p00_nmemb > RSIZE_MAX || p00_size > RSIZE_MAX) {
+      p00_constraint_call(EDOM, p00_file, p00_context, "p99_eytzinger_search runtime constraint violation");
+    } else if (!p00_key || !p00_base || !p00_compar) {
+      p00_constraint_call(EINVAL, p00_file, p00_context, "p99_eytzinger_search runtime constraint violation");
+    } else {
+      register unsigned char const* p00_B = p00_base;
+      /* Descend with 1 based positions, to the right if the element is
+         less than the key. The 16 descendants four levels below are
+         consecutive, and the first of them is prefetched. */
+      register size_t p00_k = 1;
+      while (p00_k <= p00_nmemb) {
+        P99_PREFETCH(P00_SEARCH_HINT(p00_B, (16*p00_k - 1)*p00_size));
+        p00_k = 2*p00_k + (p00_compar(p00_B + (p00_k - 1)*p00_size, p00_key, p00_ctx) < 0);
+      }
+      /* Undo the right turns at the end and the last left turn. That
+         is the node where the search went left for the last time, so
+         the first that is not less than the key. */
+      while (p00_k & 1) p00_k /= 2;
+      p00_k /= 2;
+      if (p00_k && !p00_compar(p00_B + (p00_k - 1)*p00_size, p00_key, p00_ctx))
+        return (void*)(p00_B + (p00_k - 1)*p00_size);
+    }
+  }
+  return 0;
+}
+
+/**
+ ** @brief Search @a key in an array in Eytzinger order.
+ **
+ ** This has the same interface as @c bsearch_s, only that the array
+ ** must have been produced by ::p99_eytzinger_s from a sorted array.
+ ** If there are several matching elements, the one that came first in
+ ** the sorted array is returned.
+ **
+ ** The search visits the same number of elements as a binary search,
+ ** but the first levels of the tree are close together at the start
+ ** of the array, and the descendants of the current element a few
+ ** levels below are prefetched. So for large tables there are far
+ ** fewer cache misses that the search has to wait for.
+ **/
+#define p99_eytzinger_search(...) p00_eytzinger_search(P99_STRINGIFY(__LINE__), __func__, __VA_ARGS__)
+
+/* The size of a node of a static B-tree. */
+#define P00_STREE_LINE 64u
+
+#define P00_STREE_B(T) (P00_STREE_LINE/sizeof(T))
+
+/**
+ ** @brief The number of elements of type @a T that a static B-tree
+ ** for @a N keys needs.
+ **
+ ** This is @a N rounded up to a multiple of the keys that fit in 64
+ ** bytes.
+ **
+ ** @see p99_stree_build
+ **/
+#define P99_STREE_LEN(T, N) ((((N) + P00_STREE_B(T) - 1)/P00_STREE_B(T))*P00_STREE_B(T))
+
+P99_DECLARE_STRUCT(p00_stree_pos);
+
+struct p00_stree_pos {
+  size_t p00_node;
+  size_t p00_i;
+};
+
+/* The nodes of the tree hold P00_STREE_B(T) keys and have one more
+   children, where the children of node k are the nodes
+   k*(B+1) + 1 + i. They are filled by an in order traversal, where
+   the keys after the end of p00_src are copies of the last key. The
+   stack is large enough for a tree of at least 2^64 elements. */
+#define P00_STREE_DECLARE(T)                                                    \
+p99_inline                                                                      \
+void P99_PASTE2(p00_stree_build_, T)(T *p00_tree, T const* p00_src, size_t p00_n) { \
+  size_t const p00_B = P00_STREE_B(T);                                          \
+  size_t const p00_nb = (p00_n + p00_B - 1)/p00_B;                              \
+  p00_stree_pos p00_st[64];                                                     \
+  size_t p00_d = 0;                                                             \
+  size_t p00_t = 0;                                                             \
+  p00_st[0] = (p00_stree_pos){ .p00_node = 0, };                                \
+  while (p00_nb) {                                                              \
+    p00_stree_pos*const p00_p = &p00_st[p00_d];                                 \
+    size_t const p00_c = p00_p->p00_node*(p00_B + 1) + 1 + p00_p->p00_i;        \
+    if (p00_p->p00_i <= p00_B && p00_c < p00_nb) {                              \
+      /* go down to child p00_i first */                                        \
+      p00_st[++p00_d] = (p00_stree_pos){ .p00_node = p00_c, };                  \
+      continue;                                                                 \
+    }                                                                           \
+    if (p00_p->p00_i < p00_B) {                                                 \
+      p00_tree[p00_p->p00_node*p00_B + p00_p->p00_i]                            \
+        = p00_src[p00_t < p00_n ? p00_t : p00_n - 1];                           \
+      ++p00_t;                                                                  \
+      ++p00_p->p00_i;                                                           \
+      continue;                                                                 \
+    }                                                                           \
+    /* this node and its last child are done */                                 \
+    if (!p00_d) break;                                                          \
+    --p00_d;                                                                    \
+    /* the key after the child that we come from */                             \
+    if (p00_st[p00_d].p00_i < p00_B) {                                          \
+      p00_tree[p00_st[p00_d].p00_node*p00_B + p00_st[p00_d].p00_i]              \
+        = p00_src[p00_t < p00_n ? p00_t : p00_n - 1];                           \
+      ++p00_t;                                                                  \
+    }                                                                           \
+    ++p00_st[p00_d].p00_i;                                                      \
+  }                                                                             \
+}                                                                               \
+p99_inline                                                                      \
+T const* P99_PASTE2(p00_stree_search_, T)(T const* p00_tree, size_t p00_n, T p00_key) { \
+  size_t const p00_B = P00_STREE_B(T);                                          \
+  size_t const p00_nb = (p00_n + p00_B - 1)/p00_B;                              \
+  T const* p00_ret = 0;                                                         \
+  for (size_t p00_k = 0; p00_k < p00_nb;) {                                     \
+    T const*const p00_node = p00_tree + p00_k*p00_B;                            \
+    /* This loop has a constant number of iterations and no branches, \
+       so the compiler may do all comparisons at once with vector    \
+       instructions. */                                                         \
+    size_t p00_i = 0;                                                           \
+    for (size_t p00_j = 0; p00_j < P00_STREE_B(T); ++p00_j)                     \
+      p00_i += (p00_node[p00_j] < p00_key);                                     \
+    p00_ret = (p00_i < p00_B) ? p00_node + p00_i : p00_ret;                     \
+    p00_k = p00_k*(p00_B + 1) + 1 + p00_i;                                      \
+  }                                                                             \
+  return (p00_ret && !(p00_key < *p00_ret)) ? p00_ret : 0;                      \
+}                                                                               \
+P99_MACRO_END(p00_stree_, T)
+
+P00_STREE_DECLARE(unsigned);
+P00_STREE_DECLARE(signed);
+P00_STREE_DECLARE(ulong);
+P00_STREE_DECLARE(long);
+P00_STREE_DECLARE(ullong);
+P00_STREE_DECLARE(llong);
+P00_STREE_DECLARE(float);
+P00_STREE_DECLARE(double);
+
+#define P00_STREE(P, B)                                        \
+  P99_GENERIC(&((B)[0]), ,                                     \
+            (float*, P99_PASTE2(P, float)),                    \
+            (double*, P99_PASTE2(P, double)),                  \
+            (float const*, P99_PASTE2(P, float)),              \
+            (double const*, P99_PASTE2(P, double)),            \
+            /* */                                              \
+            (unsigned*, P99_PASTE2(P, unsigned)),              \
+            (signed*, P99_PASTE2(P, signed)),                  \
+            (unsigned const*, P99_PASTE2(P, unsigned)),        \
+            (signed const*, P99_PASTE2(P, signed)),            \
+            /* */                                              \
+            (ulong*, P99_PASTE2(P, ulong)),                    \
+            (long*, P99_PASTE2(P, long)),                      \
+            (ulong const*, P99_PASTE2(P, ulong)),              \
+            (long const*, P99_PASTE2(P, long)),                \
+            /* */                                              \
+            (ullong*, P99_PASTE2(P, ullong)),                  \
+            (llong*, P99_PASTE2(P, llong)),                    \
+            (ullong const*, P99_PASTE2(P, ullong)),            \
+            (llong const*, P99_PASTE2(P, llong))               \
+              )
+
+/**
+ ** @brief Build a static B-tree in @a TREE from the sorted array @a
+ ** SRC of @a N elements.
+ **
+ ** @a TREE must have room for ::P99_STREE_LEN(T, N) elements of the
+ ** base type @c T of @a SRC, which must be a real type that is
+ ** supported by ::P99_GENERIC. The tree consists of nodes of 64 bytes
+ ** that hold sorted keys, and the children of a node are found by
+ ** arithmetic on its position, so there are no pointers.
+ **
+ ** @see p99_stree_search
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(p99_stree_build, 0)
+P00_DOCUMENT_PERMITTED_ARGUMENT(p99_stree_build, 1)
+#define p99_stree_build(TREE, SRC, N) P00_STREE(p00_stree_build_, SRC)((TREE), (SRC), (N))
+
+/**
+ ** @brief Search @a KEY in the static B-tree @a TREE for @a N
+ ** elements.
+ **
+ ** @return a pointer to the first key in @a TREE that is equal to @a
+ ** KEY, or a null pointer if there is none.
+ **
+ ** Each step of the search reads one node of 64 bytes, that is one
+ ** cache line, and compares all its keys to @a KEY. For 4 byte keys
+ ** one step goes down 4 levels of a binary search, for 8 byte keys
+ ** 3 levels. So the search has much fewer cache misses than a binary
+ ** search, and the comparisons of a node don't depend on each other,
+ ** such that the compiler may vectorize them.
+ **
+ ** @see p99_stree_build
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(p99_stree_search, 0)
+#define p99_stree_search(TREE, N, KEY) P00_STREE(p00_stree_search_, TREE)((TREE), (N), (KEY))
+
+/**
+ ** @}
+ **/
+
+#endif
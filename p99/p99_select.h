@@ -0,0 +1,522 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_SELECT_H
+#define P99_SELECT_H 1
+
+#include "p99_qsort.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/* The recursion for the median of medians. This is a function of its
+   own, because the others are always inlined. */
+errno_t p00_select_rec(void *p00_base,
+                       rsize_t p00_n,
+                       rsize_t p00_a,
+                       rsize_t p00_s,
+                       int (*p00_comp)(const void *, const void *, void *),
+                       void *p00_ctx,
+                       rsize_t p00_k);
+
+/* An introselect. The pivot is chosen and the partition is split as
+   for P00_QSORT_BODY, only that the loop just continues with the part
+   that contains position p00_k. The partitions with these pivots may
+   scan at most P00_QSELECT_BUDGET times p00_n elements in total.
+   When that budget is spent the pivot is the median of the medians
+   of groups of five, which is found by a recursive call and which
+   guarantees that the part shrinks by a constant factor. So the worst
+   case is linear. */
+#define P00_QSELECT_BUDGET 4u
+
+#define P00_QSELECT_BODY(SWAP)                                            \
+if (p00_n > RSIZE_MAX || p00_s > RSIZE_MAX) return EDOM;                        \
+if (p00_n && (!p00_base || !p00_comp)) return EINVAL;                           \
+if (p00_k >= p00_n) return EINVAL;                                              \
+do {                                                                            \
+  register size_t p00_bot = 0;                                                  \
+  register size_t p00_top = p00_n;                                              \
+  register size_t p00_budget                                                    \
+    = (p00_n < SIZE_MAX/P00_QSELECT_BUDGET) ? P00_QSELECT_BUDGET*p00_n : SIZE_MAX; \
+  bool p00_ok;                                                                  \
+  while (p00_top - p00_bot > P00_QSORT_INSERTION) {                             \
+    register size_t const p00_len = p00_top - p00_bot;                          \
+    register size_t const p00_h = p00_len/2;                                    \
+    /* move the pivot to the bottom element */                                  \
+    if (p00_len <= p00_budget) {                                                \
+      p00_budget -= p00_len;                                                    \
+      if (p00_len > P00_QSORT_NINTHER) {                                        \
+        P00_QSORT3(SWAP, p00_bot, p00_bot + p00_h, p00_top - 1);                \
+        P00_QSORT3(SWAP, p00_bot + 1, p00_bot + (p00_h - 1), p00_top - 2);      \
+        P00_QSORT3(SWAP, p00_bot + 2, p00_bot + (p00_h + 1), p00_top - 3);      \
+        P00_QSORT3(SWAP, p00_bot + (p00_h - 1), p00_bot + p00_h, p00_bot + (p00_h + 1)); \
+        SWAP(p00_B, p00_bot, p00_bot + p00_h);                                  \
+      } else {                                                                  \
+        P00_QSORT3(SWAP, p00_bot + p00_h, p00_bot, p00_top - 1);                \
+      }                                                                         \
+    } else {                                                                    \
+      register size_t const p00_m = p00_len/5;                                  \
+      for (register size_t p00_i = 0; p00_i < p00_m; ++p00_i) {                 \
+        register size_t const p00_g = p00_bot + 5*p00_i;                        \
+        P00_QINSERT(SWAP, p00_g, p00_g + 5, SIZE_MAX, p00_ok);                  \
+        SWAP(p00_B, p00_bot + p00_i, p00_g + 2);                                \
+      }                                                                         \
+      p00_select_rec(&p00_B[p00_bot], p00_m, p00_a, p00_s, p00_comp, p00_ctx, p00_m/2); \
+      SWAP(p00_B, p00_bot, p00_bot + p00_m/2);                                  \
+    }                                                                           \
+    /* There are elements that are not less than the pivot above it,     \
+       so the searches stop inside the partition. */                           \
+    register size_t p00_b = p00_bot;                                            \
+    register size_t p00_t = p00_top;                                            \
+    while (P00_QCOMP(++p00_b, p00_bot) < 0);                                    \
+    while (P00_QCOMP(p00_bot, --p00_t) < 0);                                    \
+    while (p00_b < p00_t) {                                                     \
+      SWAP(p00_B, p00_b, p00_t);                                                \
+      while (P00_QCOMP(++p00_b, p00_bot) < 0);                                  \
+      while (P00_QCOMP(p00_bot, --p00_t) < 0);                                  \
+    }                                                                           \
+    if (p00_t != p00_bot) SWAP(p00_B, p00_bot, p00_t);                          \
+    if (p00_t == p00_k) return 0;                                               \
+    if (p00_k < p00_t) p00_top = p00_t;                                         \
+    else p00_bot = p00_t + 1;                                                   \
+  }                                                                             \
+  P00_QINSERT(SWAP, p00_bot, p00_top, SIZE_MAX, p00_ok);                        \
+  P99_UNUSED(p00_ok);                                                           \
+  return 0;                                                                     \
+ } while(false)
+
+/* Select the element at position p00_k, such that the first p00_k
+   elements are the smallest, and sort these. */
+#define P00_QPARTIAL_BODY(SELECT, SORT)                                         \
+if (p00_k > p00_n) return EINVAL;                                               \
+if (p00_k < p00_n) {                                                            \
+  errno_t const p00_ret = SELECT(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k); \
+  if (p00_ret) return p00_ret;                                                  \
+}                                                                               \
+return SORT(p00_base, p00_k, p00_a, p00_s, p00_comp, p00_ctx)
+
+#define P00_QSELECT_GENERIC(N, T, SWAP)                                         \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_select_generic, N)(void *p00_base,                       \
+                                          rsize_t p00_n,                        \
+                                          rsize_t p00_a,                        \
+                                          rsize_t p00_s,                        \
+                                          int (*p00_comp)(const void *, const void *, void *), \
+                                          void *p00_ctx,                        \
+                                          rsize_t p00_k) {                      \
+  size_t const p00_vsize = p00_s / sizeof(T);                                   \
+  P99_UNUSED(p00_vsize);                                                        \
+  typedef T p00_el[p00_vsize];                                                  \
+  register p00_el *const p00_B = p00_base;                                      \
+  p00_el p00_tmp;                                                               \
+  P00_QSELECT_BODY(SWAP);                                                       \
+}                                                                               \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_partial_generic, N)(void *p00_base,                      \
+                                           rsize_t p00_n,                       \
+                                           rsize_t p00_a,                       \
+                                           rsize_t p00_s,                       \
+                                           int (*p00_comp)(const void *, const void *, void *), \
+                                           void *p00_ctx,                       \
+                                           rsize_t p00_k) {                     \
+  P00_QPARTIAL_BODY(P99_PASTE2(p00_select_generic, N), P99_PASTE2(p00_qsort_generic, N)); \
+}                                                                               \
+P99_MACRO_END(p00_select_generic, N)
+
+#ifdef UINT16_MAX
+P00_QSELECT_GENERIC(16, uint16_t, P00_QSWAP_VCPY);
+#endif
+#ifdef UINT32_MAX
+P00_QSELECT_GENERIC(32, uint32_t, P00_QSWAP_VCPY);
+#endif
+#ifdef UINT64_MAX
+P00_QSELECT_GENERIC(64, uint64_t, P00_QSWAP_VCPY);
+#endif
+#ifdef UINT128_MAX
+P00_QSELECT_GENERIC(128, uint128_t, P00_QSWAP_VCPY);
+#else
+# ifdef P99X_UINT128_MAX
+P00_QSELECT_GENERIC(128, p99x_uint128, P00_QSWAP_VCPY);
+# endif
+#endif
+P00_QSELECT_GENERIC(, unsigned char, P00_QSWAP_MEMCPY);
+
+#define P00_QSELECT_DECLARE(T)                                                  \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_select_, T)(void *p00_base,                              \
+                    rsize_t p00_n,                                              \
+                    rsize_t p00_a,                                              \
+                    rsize_t p00_s,                                              \
+                    int (*p00_comp)(const void *, const void *, void *),        \
+                    void *p00_ctx,                                              \
+                    rsize_t p00_k) {                                            \
+  register T *const p00_B = p00_base;                                           \
+  _Alignas(sizeof(max_align_t)) T p00_tmp;                                      \
+  P00_QSELECT_BODY(P00_QSWAP_ASSIGN);                                           \
+}                                                                               \
+p99_inline                                                                      \
+errno_t P99_PASTE2(p00_partial_, T)(void *p00_base,                             \
+                    rsize_t p00_n,                                              \
+                    rsize_t p00_a,                                              \
+                    rsize_t p00_s,                                              \
+                    int (*p00_comp)(const void *, const void *, void *),        \
+                    void *p00_ctx,                                              \
+                    rsize_t p00_k) {                                            \
+  P00_QPARTIAL_BODY(P99_PASTE2(p00_select_, T), P99_PASTE2(p00_qsort_, T));     \
+}                                                                               \
+P99_MACRO_END(p00_select_, T)
+
+P00_QSELECT_DECLARE(_Bool);
+P00_QSELECT_DECLARE(schar);
+P00_QSELECT_DECLARE(uchar);
+P00_QSELECT_DECLARE(char);
+P00_QSELECT_DECLARE(short);
+P00_QSELECT_DECLARE(ushort);
+P00_QSELECT_DECLARE(signed);
+P00_QSELECT_DECLARE(unsigned);
+P00_QSELECT_DECLARE(long);
+P00_QSELECT_DECLARE(ulong);
+P00_QSELECT_DECLARE(llong);
+P00_QSELECT_DECLARE(ullong);
+P00_QSELECT_DECLARE(float);
+P00_QSELECT_DECLARE(double);
+P00_QSELECT_DECLARE(ldouble);
+#ifndef __STDC_NO_COMPLEX__
+P00_QSELECT_DECLARE(cfloat);
+P00_QSELECT_DECLARE(cdouble);
+P00_QSELECT_DECLARE(cldouble);
+#endif
+P00_QSELECT_DECLARE(void_ptr);
+
+p99_inline
+errno_t p00_select_s(void *p00_base,
+                     rsize_t p00_n,
+                     rsize_t p00_a,
+                     rsize_t p00_s,
+                     int (*p00_comp)(const void *, const void *, void *),
+                     void *p00_ctx,
+                     rsize_t p00_k) {
+  switch (p00_a) {
+#ifdef UINT16_MAX
+  case sizeof(uint16_t):
+    return p00_select_generic16(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#ifdef UINT32_MAX
+  case sizeof(uint32_t):
+    return p00_select_generic32(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#ifdef UINT64_MAX
+  case sizeof(uint64_t):
+    return p00_select_generic64(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#if defined(UINT128_MAX) || defined(P99X_UINT128_MAX)
+  case 16:
+    return p00_select_generic128(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+  }
+  return p00_select_generic(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+}
+
+P99_WEAK(p00_select_rec)
+errno_t p00_select_rec(void *p00_base,
+                       rsize_t p00_n,
+                       rsize_t p00_a,
+                       rsize_t p00_s,
+                       int (*p00_comp)(const void *, const void *, void *),
+                       void *p00_ctx,
+                       rsize_t p00_k) {
+  return p00_select_s(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+}
+
+p99_inline
+errno_t p00_partial_s(void *p00_base,
+                      rsize_t p00_n,
+                      rsize_t p00_a,
+                      rsize_t p00_s,
+                      int (*p00_comp)(const void *, const void *, void *),
+                      void *p00_ctx,
+                      rsize_t p00_k) {
+  switch (p00_a) {
+#ifdef UINT16_MAX
+  case sizeof(uint16_t):
+    return p00_partial_generic16(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#ifdef UINT32_MAX
+  case sizeof(uint32_t):
+    return p00_partial_generic32(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#ifdef UINT64_MAX
+  case sizeof(uint64_t):
+    return p00_partial_generic64(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+#if defined(UINT128_MAX) || defined(P99X_UINT128_MAX)
+  case 16:
+    return p00_partial_generic128(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+#endif
+  }
+  return p00_partial_generic(p00_base, p00_n, p00_a, p00_s, p00_comp, p00_ctx, p00_k);
+}
+
+#ifdef __STDC_NO_COMPLEX__
+#define P00_QSELECT(P, B)                                                       \
+  P99_GENERIC(&((B)[0]),                                                        \
+            P99_PASTE2(P, s),                                                   \
+            (void_ptr*, P99_PASTE2(P, void_ptr)),                               \
+            /* */                                                               \
+            (float*, P99_PASTE2(P, float)),                                     \
+            (double*, P99_PASTE2(P, double)),                                   \
+            /* */                                                               \
+            (_Bool*, P99_PASTE2(P, _Bool)),                                     \
+            (char*, P99_PASTE2(P, char)),                                       \
+            (uchar*, P99_PASTE2(P, uchar)),                                     \
+            (schar*, P99_PASTE2(P, schar)),                                     \
+            /* */                                                               \
+            (ushort*, P99_PASTE2(P, ushort)),                                   \
+            (short*, P99_PASTE2(P, short)),                                     \
+            /* */                                                               \
+            (unsigned*, P99_PASTE2(P, unsigned)),                               \
+            (signed*, P99_PASTE2(P, signed)),                                   \
+            /* */                                                               \
+            (long*, P99_PASTE2(P, long)),                                       \
+            (ulong*, P99_PASTE2(P, ulong)),                                     \
+            /* */                                                               \
+            (llong*, P99_PASTE2(P, llong)),                                     \
+            (ullong*, P99_PASTE2(P, ullong))                                    \
+              )
+#else
+#define P00_QSELECT(P, B)                                                       \
+  P99_GENERIC(&((B)[0]),                                                        \
+            P99_PASTE2(P, s),                                                   \
+            (void_ptr*, P99_PASTE2(P, void_ptr)),                               \
+            /* */                                                               \
+            (float*, P99_PASTE2(P, float)),                                     \
+            (double*, P99_PASTE2(P, double)),                                   \
+            (ldouble*, P99_PASTE2(P, ldouble)),                                 \
+            /* */                                                               \
+            (cfloat*, P99_PASTE2(P, cfloat)),                                   \
+            (cdouble*, P99_PASTE2(P, cdouble)),                                 \
+            (cldouble*, P99_PASTE2(P, cldouble)),                               \
+            /* */                                                               \
+            (_Bool*, P99_PASTE2(P, _Bool)),                                     \
+            (char*, P99_PASTE2(P, char)),                                       \
+            (uchar*, P99_PASTE2(P, uchar)),                                     \
+            (schar*, P99_PASTE2(P, schar)),                                     \
+            /* */                                                               \
+            (ushort*, P99_PASTE2(P, ushort)),                                   \
+            (short*, P99_PASTE2(P, short)),                                     \
+            /* */                                                               \
+            (unsigned*, P99_PASTE2(P, unsigned)),                               \
+            (signed*, P99_PASTE2(P, signed)),                                   \
+            /* */                                                               \
+            (long*, P99_PASTE2(P, long)),                                       \
+            (ulong*, P99_PASTE2(P, ulong)),                                     \
+            /* */                                                               \
+            (llong*, P99_PASTE2(P, llong)),                                     \
+            (ullong*, P99_PASTE2(P, ullong))                                    \
+              )
+#endif
+
+/**
+ ** @brief Move the element of rank @a K of @a B to position @a K.
+ **
+ ** This is the @c nth_element of C++ with the interface of
+ ** ::qsort_s. Its prototype if it were not implemented as a type
+ ** generic macro, would be:
+ **
+ ** @code
+ ** errno_t p99_select_s(void *base,
+ **                      rsize_t nmemb,
+ **                      rsize_t size,
+ **                      int (*compar)(const void *x, const void *y, void *context),
+ **                      void *context,
+ **                      rsize_t k);
+ ** @endcode
+ **
+ ** Afterwards, the element at position @a K is the one that would be
+ ** there if @a B were sorted, all elements before are not greater
+ ** and all elements after are not less. So this can be used to find
+ ** the median or to split off the @a K smallest elements.
+ **
+ ** The algorithm is the partitioning of ::qsort_s, where only the
+ ** part that contains position @a K is considered further. This
+ ** needs a linear number of comparisons on average. If the
+ ** partitions don't shrink fast enough, the pivot is the median of
+ ** medians, so the worst case is linear, too.
+ **
+ ** It is a runtime constraint violation if @a K is not less than @a
+ ** N.
+ **
+ ** @see p99_partial_sort_s
+ **/
+#define p99_select_s(B, N, S, CMP, CTX, K)                                      \
+  P99_CONSTRAINT_TRIGGER(                                                       \
+  P00_QSELECT(p00_select_, B)((B), (N), P99_ALIGNOF((B)[0]), (S), (CMP), (CTX), (K)), \
+  "p99_select_s runtime constraint violation")
+
+/**
+ ** @brief Sort the @a K smallest elements of @a B into its first @a
+ ** K positions.
+ **
+ ** This has the interface of ::p99_select_s. It first uses
+ ** ::p99_select_s to move the @a K smallest elements to the front
+ ** and then sorts these with ::qsort_s. So the complexity is O(n + k
+ ** log k) instead of O(n log n). The order of the other elements is
+ ** unspecified.
+ **
+ ** It is a runtime constraint violation if @a K is greater than @a
+ ** N.
+ **/
+#define p99_partial_sort_s(B, N, S, CMP, CTX, K)                                \
+  P99_CONSTRAINT_TRIGGER(                                                       \
+  P00_QSELECT(p00_partial_, B)((B), (N), P99_ALIGNOF((B)[0]), (S), (CMP), (CTX), (K)), \
+  "p99_partial_sort_s runtime constraint violation")
+
+P99_DECLARE_STRUCT(p99_topk);
+
+/**
+ ** @brief Keep the @c k smallest of a stream of elements.
+ **
+ ** The elements are kept in a buffer that is provided by the user and
+ ** that is organized as a heap with the largest kept element at the
+ ** top. So each new element is compared to that one first, and only
+ ** if it is smaller it replaces it, with O(log k) comparisons. If
+ ** most elements are not kept, this is about one comparison for each
+ ** element of the stream.
+ **
+ ** To keep the @c k largest elements, use a comparison function
+ ** that inverts the order.
+ **
+ ** @code
+ ** double best[100];
+ ** p99_topk top;
+ ** p99_topk_init(&top, best, 100, sizeof best[0], dComp, 0);
+ ** for (size_t i = 0; i < n; ++i) p99_topk_push(&top, &score[i]);
+ ** rsize_t len = p99_topk_sort(&top);
+ ** @endcode
+ **
+ ** @see p99_topk_init
+ ** @see p99_topk_push
+ ** @see p99_topk_sort
+ **/
+struct p99_topk {
+  unsigned char* p00_B;
+  rsize_t p00_k;
+  rsize_t p00_n;
+  rsize_t p00_s;
+  int (*p00_comp)(const void *, const void *, void *);
+  void *p00_ctx;
+};
+
+/**
+ ** @brief Initialize @a p00_t to keep the @a p00_k smallest elements
+ ** in the buffer @a p00_base.
+ **
+ ** @a p00_base must have room for @a p00_k elements of size @a p00_s.
+ ** Returns @c EINVAL if a pointer argument is null or if a size is
+ ** @c 0 or larger than @c RSIZE_MAX.
+ ** @related p99_topk
+ **/
+p99_inline
+errno_t p99_topk_init(p99_topk* p00_t,
+                      void *p00_base,
+                      rsize_t p00_k,
+                      rsize_t p00_s,
+                      int (*p00_comp)(const void *, const void *, void *),
+                      void *p00_ctx) {
+  if (!p00_t || !p00_base || !p00_comp
+      || !p00_k || p00_k > RSIZE_MAX || !p00_s || p00_s > RSIZE_MAX)
+    return EINVAL;
+  *p00_t = (p99_topk) {
+    .p00_B = p00_base,
+    .p00_k = p00_k,
+    .p00_s = p00_s,
+    .p00_comp = p00_comp,
+    .p00_ctx = p00_ctx,
+  };
+  return 0;
+}
+
+/**
+ ** @brief Offer the element at @a p00_el to @a p00_t.
+ **
+ ** @return @c true if the element is kept, that is if there were
+ ** fewer than @c k elements, or if it is smaller than the largest of
+ ** them, which is then dropped.
+ ** @related p99_topk
+ **/
+p99_inline
+bool p99_topk_push(p99_topk* p00_t, void const* p00_el) {
+  rsize_t const p00_s = p00_t->p00_s;
+  typedef unsigned char p00_el_t[p00_s];
+  p00_el_t *const p00_B = (p00_el_t*)p00_t->p00_B;
+  int (*const p00_comp)(const void *, const void *, void *) = p00_t->p00_comp;
+  void *const p00_ctx = p00_t->p00_ctx;
+  p00_el_t p00_tmp;
+  if (p00_t->p00_n < p00_t->p00_k) {
+    /* append and move it up */
+    register size_t p00_c = p00_t->p00_n++;
+    memcpy(p00_B[p00_c], p00_el, p00_s);
+    while (p00_c) {
+      register size_t const p00_p = (p00_c - 1)/2;
+      if (!(P00_QCOMP(p00_p, p00_c) < 0)) break;
+      P00_QSWAP_MEMCPY(p00_B, p00_p, p00_c);
+      p00_c = p00_p;
+    }
+    return true;
+  }
+  if (!(p00_comp(p00_el, p00_B[0], p00_ctx) < 0)) return false;
+  memcpy(p00_B[0], p00_el, p00_s);
+  P00_QSIFT(P00_QSWAP_MEMCPY, 0, 0, p00_t->p00_n);
+  return true;
+}
+
+/**
+ ** @brief Sort the elements that are kept in @a p00_t.
+ **
+ ** @return the number of elements, which is @c k unless fewer
+ ** elements have been pushed.
+ **
+ ** The buffer is then no more a heap, so @a p00_t must be initialized
+ ** again before the next element is pushed.
+ ** @related p99_topk
+ **/
+p99_inline
+rsize_t p99_topk_sort(p99_topk* p00_t) {
+  rsize_t const p00_s = p00_t->p00_s;
+  typedef unsigned char p00_el_t[p00_s];
+  p00_el_t *const p00_B = (p00_el_t*)p00_t->p00_B;
+  int (*const p00_comp)(const void *, const void *, void *) = p00_t->p00_comp;
+  void *const p00_ctx = p00_t->p00_ctx;
+  p00_el_t p00_tmp;
+  /* This is the second phase of a heap sort. */
+  for (register size_t p00_e = p00_t->p00_n; p00_e-- > 1;) {
+    P00_QSWAP_MEMCPY(p00_B, 0, p00_e);
+    P00_QSIFT(P00_QSWAP_MEMCPY, 0, 0, p00_e);
+  }
+  return p00_t->p00_n;
+}
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -0,0 +1,278 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_SEM_H
+#define P99_SEM_H
+
+#include "p99_futex.h"
+
+/**
+ ** @addtogroup futex
+ ** @{
+ **/
+
+/**
+ ** @brief A counting semaphore.
+ **
+ ** Other than ::p99_count, which waits for the count to fall to @c
+ ** 0, a ::p99_sem blocks as long as its count is @c 0 and then
+ ** decrements the count atomically. A typical use is admission
+ ** control, where the count reflects the number of free slots:
+ **
+ ** @code
+ ** p99_sem slots = P99_SEM_INITIALIZER(16);
+ **
+ ** int my_worker(void* arg) {
+ **   p99_sem_wait(&slots);
+ **   // at most 16 threads are here
+ **   p99_sem_post(&slots);
+ **   ...
+ ** }
+ ** @endcode
+ **
+ ** The count is held in a ::p99_futex. In addition the number of
+ ** threads that are blocked on the semaphore is tracked, such that
+ ** ::p99_sem_post only calls into the OS if there is somebody to
+ ** wake up. So as long as there is no contention, all operations
+ ** are just atomic operations in user space.
+ **
+ ** @see p99_sem_post
+ ** @see p99_sem_wait
+ ** @see p99_sem_wait_n
+ ** @see p99_sem_trywait
+ ** @see p99_sem_timedwait
+ **/
+#ifdef P00_DOXYGEN
+struct p99_sem {};
+#else
+typedef struct p99_sem p99_sem;
+struct p99_sem {
+  p99_futex p00_f;
+  _Atomic(unsigned) p00_w;
+  _Atomic(unsigned) p00_wn;
+};
+#endif
+
+/**
+ ** @brief Initialize an ::p99_sem object with count @a INITIAL.
+ **/
+# define P99_SEM_INITIALIZER(INITIAL)                          \
+{                                                              \
+  .p00_f = P99_FUTEX_INITIALIZER(INITIAL),                     \
+  .p00_w = ATOMIC_VAR_INIT(0),                                 \
+  .p00_wn = ATOMIC_VAR_INIT(0),                                \
+}
+
+/**
+ ** @brief Initialize an ::p99_sem object with count @a p00_v.
+ ** @related p99_sem
+ **/
+P99_DEFARG_DOCU(p99_sem_init)
+p99_inline
+p99_sem* p99_sem_init(p99_sem* p00_s, unsigned p00_v) {
+  if (p00_s) {
+    p99_futex_init(&p00_s->p00_f, p00_v);
+    atomic_init(&p00_s->p00_w, 0u);
+    atomic_init(&p00_s->p00_wn, 0u);
+  }
+  return p00_s;
+}
+
+#ifndef DOXYGEN
+#define p99_sem_init(...) P99_CALL_DEFARG(p99_sem_init, 2, __VA_ARGS__)
+#define p99_sem_init_defarg_1() 0U
+#endif
+
+/**
+ ** @brief destroy a semaphore
+ ** @related p99_sem
+ **/
+p99_inline
+void p99_sem_destroy(p99_sem* p00_s) {
+  if (p00_s) {
+    p99_futex_destroy(&p00_s->p00_f);
+  }
+}
+
+/**
+ ** @brief Obtain the count of the semaphore. Non blocking.
+ **
+ ** @remark this gives only a temporary picture of the state
+ ** @related p99_sem
+ **/
+p99_inline
+unsigned p99_sem_value(p99_sem volatile* p00_s) {
+  return p99_futex_load(&p00_s->p00_f);
+}
+
+/**
+ ** @brief Increment the count of @a p00_s by @a p00_n and wake up
+ ** waiters, if any.
+ **
+ ** @remark @a p00_n defaults to @c 1.
+ ** @related p99_sem
+ **/
+P99_DEFARG_DOCU(p99_sem_post)
+p99_inline
+void p99_sem_post(p99_sem volatile* p00_s, unsigned p00_n) {
+  if (!p00_n) return;
+  p99_futex_add(&p00_s->p00_f, p00_n, 0u, 0u, 0u, 0u);
+  atomic_thread_fence(memory_order_seq_cst);
+  register unsigned p00_w = atomic_load(&p00_s->p00_w);
+  if (p00_w) {
+    /* A waiter for a batch may not be satisfied by the tokens that we
+       place, so then we have to wake up everybody. Otherwise at most
+       one waiter per token. */
+    if (atomic_load(&p00_s->p00_wn)) p00_w = P99_FUTEX_MAX_WAITERS;
+    else if (p00_w > p00_n) p00_w = p00_n;
+    p99_futex_wakeup(&p00_s->p00_f, 0u, p00_w);
+  }
+}
+
+#ifndef DOXYGEN
+#define p99_sem_post(...) P99_CALL_DEFARG(p99_sem_post, 2, __VA_ARGS__)
+#define p99_sem_post_defarg_1() 1U
+#endif
+
+/**
+ ** @brief Decrement the count of @a p00_s by @a p00_n if this is
+ ** possible without blocking.
+ **
+ ** @return ::thrd_success if the count has been decremented,
+ ** ::thrd_busy otherwise.
+ ** @remark @a p00_n defaults to @c 1.
+ ** @related p99_sem
+ **/
+P99_DEFARG_DOCU(p99_sem_trywait)
+P00_FUTEX_INLINE(p99_sem_trywait)
+int p99_sem_trywait(p99_sem volatile* p00_s, unsigned p00_n) {
+  if (!p00_n) return thrd_success;
+  int p00_ret = thrd_busy;
+  P99_FUTEX_COMPARE_EXCHANGE(&p00_s->p00_f, p00_act,
+                             /* never wait */
+                             true,
+                             /* only take the tokens if there are enough */
+                             ((p00_act >= p00_n) ? p00_act - p00_n : p00_act),
+                             /* capture the result by side effect, but
+                                never wake up anybody */
+                             ((p00_ret = (p00_act >= p00_n) ? thrd_success : thrd_busy), 0u),
+                             0u);
+  return p00_ret;
+}
+
+#ifndef DOXYGEN
+#define p99_sem_trywait(...) P99_CALL_DEFARG(p99_sem_trywait, 2, __VA_ARGS__)
+#define p99_sem_trywait_defarg_1() 1U
+#endif
+
+/**
+ ** @brief Block until the count of @a p00_s is at least @a p00_n
+ ** and then decrement it by @a p00_n atomically.
+ **
+ ** The @a p00_n tokens are taken all at once, so two threads that
+ ** wait for a batch can't deadlock by each holding a part of the
+ ** tokens that the other one needs.
+ **
+ ** @warning A waiter for a large batch may starve if there is a
+ ** steady stream of waiters for small batches.
+ ** @related p99_sem
+ **/
+P00_FUTEX_INLINE(p99_sem_wait_n)
+void p99_sem_wait_n(p99_sem volatile* p00_s, unsigned p00_n) {
+  if (p99_sem_trywait(p00_s, p00_n) == thrd_success) return;
+  register bool const p00_batch = (p00_n > 1u);
+  if (p00_batch) atomic_fetch_add(&p00_s->p00_wn, 1u);
+  atomic_fetch_add(&p00_s->p00_w, 1u);
+  /* Either we see the tokens of a concurrent post, or that post sees
+     us as a waiter. */
+  atomic_thread_fence(memory_order_seq_cst);
+  P99_FUTEX_COMPARE_EXCHANGE(&p00_s->p00_f, p00_act,
+                             /* block until there are enough tokens */
+                             (p00_act >= p00_n),
+                             /* take them */
+                             p00_act - p00_n,
+                             /* never wake up anybody */
+                             0u, 0u);
+  atomic_fetch_sub(&p00_s->p00_w, 1u);
+  if (p00_batch) atomic_fetch_sub(&p00_s->p00_wn, 1u);
+}
+
+/**
+ ** @brief Block until the count of @a p00_s is positive and then
+ ** decrement it atomically.
+ **
+ ** @related p99_sem
+ **/
+p99_inline
+void p99_sem_wait(p99_sem volatile* p00_s) {
+  p99_sem_wait_n(p00_s, 1u);
+}
+
+/**
+ ** @brief Block until the count of @a p00_s is at least @a p00_n
+ ** and then decrement it by @a p00_n, but not beyond the time @a
+ ** p00_abs
+ **
+ ** @a p00_abs is an absolute time with respect to ::TIME_UTC, as
+ ** for ::cnd_timedwait.
+ **
+ ** @return ::thrd_success if the count has been decremented,
+ ** ::thrd_timedout if the time has elapsed before.
+ ** @remark @a p00_n defaults to @c 1.
+ ** @related p99_sem
+ **/
+P99_DEFARG_DOCU(p99_sem_timedwait)
+P00_FUTEX_INLINE(p99_sem_timedwait)
+int p99_sem_timedwait(p99_sem volatile* p00_s, struct timespec const* p00_abs, unsigned p00_n) {
+  int p00_ret = p99_sem_trywait(p00_s, p00_n);
+  if (p00_ret == thrd_success) return p00_ret;
+  register bool const p00_batch = (p00_n > 1u);
+  if (p00_batch) atomic_fetch_add(&p00_s->p00_wn, 1u);
+  atomic_fetch_add(&p00_s->p00_w, 1u);
+  /* Either we see the tokens of a concurrent post, or that post sees
+     us as a waiter. */
+  atomic_thread_fence(memory_order_seq_cst);
+  for (;;) {
+    register unsigned const p00_act = p99_futex_load(&p00_s->p00_f);
+    if (p00_act >= p00_n) {
+      p00_ret = p99_sem_trywait(p00_s, p00_n);
+      if (p00_ret == thrd_success) break;
+    } else if (p99_futex_timedwait(&p00_s->p00_f, p00_act, p00_abs) == thrd_timedout) {
+      /* Give it a last chance. */
+      p00_ret = (p99_sem_trywait(p00_s, p00_n) == thrd_success) ? thrd_success : thrd_timedout;
+      break;
+    }
+  }
+  atomic_fetch_sub(&p00_s->p00_w, 1u);
+  if (p00_batch) atomic_fetch_sub(&p00_s->p00_wn, 1u);
+  return p00_ret;
+}
+
+#ifndef DOXYGEN
+#define p99_sem_timedwait(...) P99_CALL_DEFARG(p99_sem_timedwait, 3, __VA_ARGS__)
+#define p99_sem_timedwait_defarg_2() 1U
+#endif
+
+/**
+ ** @}
+ **/
+
+
+#endif
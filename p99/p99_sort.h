@@ -0,0 +1,189 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_SORT_H
+#define P99_SORT_H 1
+
+#include "p99_qsort.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/* Paste directly, such that a function-like macro CMP is not
+   expanded. */
+#define P00_SORT_NAME(A, B) A ## _ ## B
+
+/* The comparison CMP of P99_SORT_DEFINE and friends with the
+   interface that P00_QSORT_BODY expects. The functions below use a
+   constant pointer to it as p00_comp, so the compiler sees through
+   the call and inlines CMP. */
+#define P00_SORT_COMP(T, CMP)                                                   \
+static_inline                                                                   \
+int P00_SORT_NAME(p00_comp, CMP)(void const *p00_a, void const *p00_b, void *p00_c) { \
+  P99_UNUSED(p00_c);                                                            \
+  return CMP((T const*)p00_a, (T const*)p00_b);                                 \
+}                                                                               \
+P99_MACRO_END(p00_comp)
+
+#define P00_SORT_LOCALS(T, CMP)                                                 \
+  int (*const p00_comp)(const void *, const void *, void *) = P00_SORT_NAME(p00_comp, CMP); \
+  void *const p00_ctx = 0;                                                      \
+  rsize_t const p00_s = sizeof(T);                                              \
+  register T *const p00_B = p00_base;                                           \
+  T p00_tmp
+
+/**
+ ** @brief Define a sorting function for base type @a T and comparison
+ ** @a CMP.
+ **
+ ** @a CMP must be the name of a function or of a function-like macro
+ ** that receives two pointers to <code>T const</code> and returns an
+ ** @c int that is negative, @c 0 or positive, as the comparison
+ ** functions for @c qsort. So the usual comparison functions that
+ ** take <code>void const*</code> can be used, too.
+ **
+ ** This defines a static inline function
+ ** @code
+ ** errno_t CMP_sort(T* base, rsize_t nmemb);
+ ** @endcode
+ ** that uses the same algorithm as ::qsort_s. Other than for ::qsort_s,
+ ** the comparison is not called through a function pointer, so it is
+ ** usually inlined, even if ::qsort_s would receive a comparison
+ ** function from another compilation unit.
+ **
+ ** @code
+ ** #define DLESS(A, B) ((*(A) > *(B)) - (*(A) < *(B)))
+ ** P99_SORT_DEFINE(double, DLESS);
+ ** ...
+ ** DLESS_sort(tab, n);
+ ** @endcode
+ **
+ ** @see P99_SELECT_DEFINE
+ ** @see P99_BSEARCH_DEFINE
+ **/
+#define P99_SORT_DEFINE(T, CMP)                                                 \
+P00_SORT_COMP(T, CMP);                                                          \
+static_inline                                                                   \
+errno_t P00_SORT_NAME(CMP, sort)(T *p00_base, rsize_t p00_n) {                  \
+  P00_SORT_LOCALS(T, CMP);                                                      \
+  P00_QSORT_BODY(P00_QSWAP_ASSIGN);                                             \
+}                                                                               \
+P99_MACRO_END(P99_SORT_DEFINE)
+
+/**
+ ** @brief Define a selection function for base type @a T and
+ ** comparison @a CMP.
+ **
+ ** This defines a static inline function
+ ** @code
+ ** void CMP_select(T* base, rsize_t nmemb, rsize_t k);
+ ** @endcode
+ ** that reorders @a base such that the element at position @a k is
+ ** the one that would be there if the array were sorted, all
+ ** elements before are not greater and all elements after are not
+ ** less. If @a k is not less than @a nmemb nothing is done.
+ **
+ ** This is a quickselect with a median of three pivot, which needs a
+ ** linear number of comparisons on average. If too many partitions
+ ** are unbalanced, the remaining range is sorted, so the worst case
+ ** is O(n log n).
+ **
+ ** ::P99_SORT_DEFINE must have been used with the same arguments.
+ **/
+#define P99_SELECT_DEFINE(T, CMP)                                               \
+static_inline                                                                   \
+void P00_SORT_NAME(CMP, select)(T *p00_base, rsize_t p00_n, rsize_t p00_k) {    \
+  if (p00_k >= p00_n) return;                                                   \
+  P00_SORT_LOCALS(T, CMP);                                                      \
+  register size_t p00_bot = 0;                                                  \
+  register size_t p00_top = p00_n;                                              \
+  register unsigned p00_bad = p99_arith_log2(p00_n);                            \
+  while (p00_top - p00_bot > P00_QSORT_INSERTION) {                             \
+    register size_t const p00_len = p00_top - p00_bot;                          \
+    /* the median of three goes to the bottom */                                \
+    P00_QSORT3(P00_QSWAP_ASSIGN, p00_bot + p00_len/2, p00_bot, p00_top - 1);    \
+    register size_t p00_b = p00_bot;                                            \
+    register size_t p00_t = p00_top;                                            \
+    while (P00_QCOMP(++p00_b, p00_bot) < 0);                                    \
+    while (P00_QCOMP(p00_bot, --p00_t) < 0);                                    \
+    while (p00_b < p00_t) {                                                     \
+      P00_QSWAP_ASSIGN(p00_B, p00_b, p00_t);                                    \
+      while (P00_QCOMP(++p00_b, p00_bot) < 0);                                  \
+      while (P00_QCOMP(p00_bot, --p00_t) < 0);                                  \
+    }                                                                           \
+    P00_QSWAP_ASSIGN(p00_B, p00_bot, p00_t);                                    \
+    if (p00_t == p00_k) return;                                                 \
+    if ((p00_t - p00_bot < p00_len/8 || p00_top - p00_t < p00_len/8)            \
+        && !p00_bad--) {                                                        \
+      P00_SORT_NAME(CMP, sort)(p00_B + p00_bot, p00_top - p00_bot);             \
+      return;                                                                   \
+    }                                                                           \
+    if (p00_k < p00_t) p00_top = p00_t;                                         \
+    else p00_bot = p00_t + 1;                                                   \
+  }                                                                             \
+  bool p00_ok;                                                                  \
+  P00_QINSERT(P00_QSWAP_ASSIGN, p00_bot, p00_top, SIZE_MAX, p00_ok);            \
+  P99_UNUSED(p00_ok);                                                           \
+  P99_UNUSED(p00_ctx);                                                          \
+  P99_UNUSED(p00_s);                                                            \
+}                                                                               \
+P99_MACRO_END(P99_SELECT_DEFINE)
+
+/**
+ ** @brief Define a binary search function for base type @a T and
+ ** comparison @a CMP.
+ **
+ ** This defines a static inline function
+ ** @code
+ ** T* CMP_bsearch(T const* key, T* base, rsize_t nmemb);
+ ** @endcode
+ ** that has the same semantics as @c bsearch, only that it returns
+ ** the first of several matching elements. @a base must be sorted
+ ** with respect to @a CMP.
+ **
+ ** The loop always halves the search range, and the choice of the
+ ** half is a conditional move instead of a branch.
+ **/
+#define P99_BSEARCH_DEFINE(T, CMP)                                              \
+static_inline                                                                   \
+T *P00_SORT_NAME(CMP, bsearch)(T const *p00_key, T *p00_base, rsize_t p00_n) {  \
+  if (!p00_n) return 0;                                                         \
+  register T *p00_f = p00_base;                                                 \
+  for (register size_t p00_len = p00_n; p00_len > 1;) {                         \
+    register size_t const p00_h = p00_len/2;                                    \
+    p00_f = (CMP(&p00_f[p00_h - 1], p00_key) < 0) ? p00_f + p00_h : p00_f;      \
+    p00_len -= p00_h;                                                           \
+  }                                                                             \
+  register int const p00_c = CMP(p00_f, p00_key);                               \
+  if (p00_c < 0 && p00_f + 1 < p00_base + p00_n) {                              \
+    ++p00_f;                                                                    \
+    return CMP(p00_f, p00_key) ? 0 : p00_f;                                     \
+  }                                                                             \
+  return p00_c ? 0 : p00_f;                                                     \
+}                                                                               \
+P99_MACRO_END(P99_BSEARCH_DEFINE)
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -0,0 +1,150 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_SORTNET_H
+#define P99_SORTNET_H 1
+
+#include "p99_for.h"
+#include "p99_generic.h"
+
+/**
+ ** @addtogroup sorting
+ ** @{
+ **/
+
+/* Compare and exchange elements I and J of p00_A. Both are written
+   unconditionally, such that the compiler may use min and max
+   instructions or conditional moves instead of a branch. */
+#define P00_SORTNET_CE(T, I, J)                                \
+{                                                              \
+  T const p00_a = p00_A[I];                                    \
+  T const p00_b = p00_A[J];                                    \
+  bool const p00_c = p00_b < p00_a;                            \
+  p00_A[I] = p00_c ? p00_b : p00_a;                            \
+  p00_A[J] = p00_c ? p00_a : p00_b;                            \
+}
+
+#define P00_SORTNET_CASE(T, N, I)                              \
+case N: P99_PASTE2(P00_SORTNET_, N)(P00_SORTNET_CE, T) break;
+
+/* The network for each size is in p99_generated.h. After inlining,
+   the switch disappears if the size is a compile time constant. Sizes
+   without a network are sorted by insertion, as P00_QINSERT does. */
+#define P00_SORTNET_DECLARE(T)                                                  \
+p99_inline                                                                      \
+void P99_PASTE2(p00_sortnet_, T)(T *p00_A, size_t p00_n) {                      \
+  switch (p00_n) {                                                              \
+    P99_FOR(T, P99_NARG(P00_SORTNET_SIZES), P00_SER, P00_SORTNET_CASE, P00_SORTNET_SIZES) \
+  default:                                                                      \
+    for (size_t p00_i = 1; p00_i < p00_n; ++p00_i) {                            \
+      T const p00_x = p00_A[p00_i];                                             \
+      size_t p00_j = p00_i;                                                     \
+      for (; p00_j && p00_x < p00_A[p00_j - 1]; --p00_j)                        \
+        p00_A[p00_j] = p00_A[p00_j - 1];                                        \
+      p00_A[p00_j] = p00_x;                                                     \
+    }                                                                           \
+  }                                                                             \
+}                                                                               \
+P99_MACRO_END(p00_sortnet_, T)
+
+P00_SORTNET_DECLARE(char);
+P00_SORTNET_DECLARE(uchar);
+P00_SORTNET_DECLARE(schar);
+P00_SORTNET_DECLARE(ushort);
+P00_SORTNET_DECLARE(short);
+P00_SORTNET_DECLARE(unsigned);
+P00_SORTNET_DECLARE(signed);
+P00_SORTNET_DECLARE(ulong);
+P00_SORTNET_DECLARE(long);
+P00_SORTNET_DECLARE(ullong);
+P00_SORTNET_DECLARE(llong);
+P00_SORTNET_DECLARE(float);
+P00_SORTNET_DECLARE(double);
+P00_SORTNET_DECLARE(ldouble);
+
+#define P00_SORTNET(B)                                         \
+  P99_GENERIC(&((B)[0]), ,                                     \
+            (float*, p00_sortnet_float),                       \
+            (double*, p00_sortnet_double),                     \
+            (ldouble*, p00_sortnet_ldouble),                   \
+            /* */                                              \
+            (char*, p00_sortnet_char),                         \
+            (uchar*, p00_sortnet_uchar),                       \
+            (schar*, p00_sortnet_schar),                       \
+            /* */                                              \
+            (ushort*, p00_sortnet_ushort),                     \
+            (short*, p00_sortnet_short),                       \
+            /* */                                              \
+            (unsigned*, p00_sortnet_unsigned),                 \
+            (signed*, p00_sortnet_signed),                     \
+            /* */                                              \
+            (long*, p00_sortnet_long),                         \
+            (ulong*, p00_sortnet_ulong),                       \
+            /* */                                              \
+            (llong*, p00_sortnet_llong),                       \
+            (ullong*, p00_sortnet_ullong)                      \
+              )
+
+/**
+ ** @brief Sort the array @a TAB of real arithmetic type with a
+ ** sorting network.
+ **
+ ** The length of @a TAB is determined with ::P99_ALEN, so it must be
+ ** an array and not a pointer, and its length must be at most 32.
+ ** This is checked at compile time.
+ **
+ ** The network is a fixed sequence of compare-exchange operations
+ ** that is chosen at compile time. It is Batcher's odd-even merge
+ ** sort, which is optimal for up to 8 elements and needs only a few
+ ** more comparisons than the best known networks above. The
+ ** compare-exchange operations don't branch, so they don't suffer
+ ** from mispredictions, and the compiler may interleave independent
+ ** ones. For arrays of a few elements this is much faster than
+ ** ::P99_ASORT.
+ **
+ ** The order is the one of the @c < operator. If @a TAB contains NaN
+ ** the result is not sorted, but it is still a permutation of the
+ ** original.
+ **
+ ** @see P99_SORTNET_N for arrays that are accessed through a pointer
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_SORTNET, 0)
+#define P99_SORTNET(TAB)                                                \
+P00_SORTNET(TAB)((TAB), P99_ALEN(TAB)                                   \
+                 + 0*sizeof(char[P99_ALEN(TAB) <= P00_SORTNET_MAX ? 1 : -1]))
+
+/**
+ ** @brief Sort the first @a N elements of @a TAB with a sorting
+ ** network.
+ **
+ ** @a N should be a compile time constant that is at most 32. Larger
+ ** values are still sorted, but by insertion and not by a network,
+ ** so this is only suitable for moderate sizes.
+ **
+ ** @see P99_SORTNET
+ **/
+P00_DOCUMENT_PERMITTED_ARGUMENT(P99_SORTNET_N, 0)
+#define P99_SORTNET_N(TAB, N) P00_SORTNET(TAB)((TAB), (N))
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -0,0 +1,168 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_THRD_INDEX_H
+#define P99_THRD_INDEX_H 1
+
+#include "p99_threads.h"
+
+/**
+ ** @addtogroup threads
+ ** @{
+ **/
+
+/**
+ ** @brief The maximal number of threads that may hold an index from
+ ** ::p99_thrd_index at the same time.
+ **/
+#ifndef P99_THRD_INDEX_MAX
+# define P99_THRD_INDEX_MAX 1024u
+#endif
+
+/**
+ ** @brief The value that ::p99_thrd_index returns if there are
+ ** already ::P99_THRD_INDEX_MAX threads with an index.
+ **/
+#define P99_THRD_INDEX_NONE SIZE_MAX
+
+enum {
+  p00_thrd_index_bits = sizeof(unsigned)*CHAR_BIT,
+  p00_thrd_index_words = (P99_THRD_INDEX_MAX + p00_thrd_index_bits - 1)/p00_thrd_index_bits,
+};
+
+/* The bitmap of the indices that are in use. */
+P99_WEAK(p00_thrd_index_map)
+_Atomic(unsigned) p00_thrd_index_map[p00_thrd_index_words];
+
+P99_WEAK(p00_thrd_index_hi)
+_Atomic(size_t) p00_thrd_index_hi;
+
+/* The index of the thread plus one, or 0 if it has none. */
+P99_DECLARE_THREAD_LOCAL(size_t, p00_thrd_index_cache);
+
+P99_WEAK(p00_thrd_index_release)
+void p00_thrd_index_release(void* p00_val) {
+  register size_t const p00_i = (uintptr_t)p00_val - 1;
+  P99_THREAD_LOCAL(p00_thrd_index_cache) = 0;
+  atomic_fetch_and(&p00_thrd_index_map[p00_i / p00_thrd_index_bits],
+                   ~(1u << (p00_i % p00_thrd_index_bits)));
+}
+
+/* The key only serves to release the index when the thread exits. */
+P99_WEAK(p00_thrd_index_key)
+p99_tss p00_thrd_index_key = { .p99_dtor = p00_thrd_index_release, };
+
+p99_inline
+size_t p00_thrd_index_acquire(void) {
+  for (size_t p00_w = 0; p00_w < p00_thrd_index_words; ++p00_w) {
+    unsigned p00_act = atomic_load(&p00_thrd_index_map[p00_w]);
+    while (~p00_act) {
+      /* Take the lowest bit that is not set. */
+      register unsigned const p00_bit = ~p00_act & (p00_act + 1u);
+      size_t p00_ret = p00_w * p00_thrd_index_bits;
+      for (unsigned p00_b = p00_bit; p00_b > 1u; p00_b >>= 1) ++p00_ret;
+      if (p00_ret >= P99_THRD_INDEX_MAX) return P99_THRD_INDEX_NONE;
+      if (atomic_compare_exchange_weak(&p00_thrd_index_map[p00_w], &p00_act, p00_act | p00_bit)) {
+        size_t p00_hi = atomic_load(&p00_thrd_index_hi);
+        while (p00_hi <= p00_ret
+               && !atomic_compare_exchange_weak(&p00_thrd_index_hi, &p00_hi, p00_ret + 1)) {
+          /* empty */
+        }
+        return p00_ret;
+      }
+    }
+  }
+  return P99_THRD_INDEX_NONE;
+}
+
+p99_inline
+size_t p00_thrd_index_slow(void) {
+  size_t p00_ret = p00_thrd_index_acquire();
+  if (p00_ret != P99_THRD_INDEX_NONE) {
+    if (p99_tss_set(&p00_thrd_index_key, (void*)(uintptr_t)(p00_ret + 1)) != thrd_success) {
+      p00_thrd_index_release((void*)(uintptr_t)(p00_ret + 1));
+      return P99_THRD_INDEX_NONE;
+    }
+    P99_THREAD_LOCAL(p00_thrd_index_cache) = p00_ret + 1;
+  }
+  return p00_ret;
+}
+
+/**
+ ** @brief Return a small integer that identifies the calling thread
+ ** among all threads that are alive.
+ **
+ ** The indices are dense: a thread receives the smallest index that
+ ** is not in use by another thread, and the index is released when
+ ** the thread exits. So this can be used to index arrays of per-thread
+ ** data, e.g for sharded counters or statistics, without hashing the
+ ** thread ID:
+ **
+ ** @code
+ ** static _Atomic(size_t) hits[P99_THRD_INDEX_MAX];
+ **
+ ** void count_hit(void) {
+ **   atomic_fetch_add_explicit(&hits[p99_thrd_index()], 1, memory_order_relaxed);
+ ** }
+ **
+ ** size_t total_hits(void) {
+ **   size_t ret = 0;
+ **   for (size_t i = 0; i < p99_thrd_index_bound(); ++i)
+ **     ret += atomic_load_explicit(&hits[i], memory_order_relaxed);
+ **   return ret;
+ ** }
+ ** @endcode
+ **
+ ** The index is assigned at the first call in a thread and then
+ ** cached in a thread local variable, so this is cheap after the
+ ** first call. Only the first call and the release at thread exit use
+ ** atomic operations on a bitmap of indices.
+ **
+ ** Since indices are reused, data that is attached to an index must
+ ** remain valid when a thread inherits it from a previous one. In the
+ ** example above the counts of the terminated threads simply remain
+ ** in the total.
+ **
+ ** @return the index of the calling thread, or ::P99_THRD_INDEX_NONE
+ ** if ::P99_THRD_INDEX_MAX threads already hold an index.
+ **
+ ** @see p99_thrd_index_bound
+ **/
+p99_inline
+size_t p99_thrd_index(void) {
+  register size_t const p00_ret = P99_THREAD_LOCAL(p00_thrd_index_cache);
+  if (P99_LIKELY(p00_ret)) return p00_ret - 1;
+  else return p00_thrd_index_slow();
+}
+
+/**
+ ** @brief Return a bound for all indices that ::p99_thrd_index has
+ ** returned so far.
+ **/
+p99_inline
+size_t p99_thrd_index_bound(void) {
+  return atomic_load(&p00_thrd_index_hi);
+}
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -0,0 +1,426 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_THREADS_FUTEX_H
+#define P99_THREADS_FUTEX_H 1
+
+/**
+ ** @file
+ ** @brief Native implementation of ::mtx_t and ::cnd_t with Linux
+ ** futexes.
+ **
+ ** This file is only used by the POSIX thread emulation if
+ ** ::P99_FUTEX_THREADS or ::P99_THRD_CACHE is defined before any P99
+ ** header is included. The first replaces the mutex and condition
+ ** variable types. Then a mutex is essentially one 4 byte word that holds
+ ** the thread ID (TID) of the owner, instead of a @c
+ ** pthread_mutex_t.
+ **
+ ** - Locking and unlocking a mutex without contention is one atomic
+ **   operation in user space. A thread that finds a mutex locked
+ **   spins for ::P99_MTX_SPIN rounds and then sets the @c
+ **   FUTEX_WAITERS bit and parks in the kernel. Only if that bit is
+ **   set, ::mtx_unlock enters the kernel to wake up a waiter.
+ **
+ ** - Since the owner is known, recursive and error checking mutexes
+ **   come at no extra cost. All mutexes support ::mtx_timedlock.
+ **
+ ** - A condition variable is a sequence counter that the waiters
+ **   observe. ::cnd_signal increments it and wakes up one waiter, if
+ **   any. ::cnd_broadcast wakes up one waiter and requeues all others
+ **   to the futex of the mutex, so they are woken one after another
+ **   when the mutex is released, instead of all contending for it at
+ **   the same time.
+ **
+ ** All futex operations are process private.
+ **/
+
+#if defined(P00_DOXYGEN)
+/**
+ ** @brief Define this to use the native futex implementation of
+ ** ::mtx_t and ::cnd_t instead of wrappers around POSIX mutexes and
+ ** condition variables.
+ **
+ ** This is only effective on Linux when P99 emulates C11 threads on
+ ** top of POSIX threads, and if ::NO_FUTEX is not defined.
+ **
+ ** @see p99_threads_futex.h
+ **/
+# define P99_FUTEX_THREADS
+#endif
+
+#if __GLIBC__
+# include <linux/futex.h>
+#endif
+#include <unistd.h>
+#include <sys/syscall.h>
+
+long syscall(long number, ...);
+
+#ifndef FUTEX_WAIT
+# define FUTEX_WAIT 0
+#endif
+#ifndef FUTEX_WAKE
+# define FUTEX_WAKE 1
+#endif
+#ifndef FUTEX_CMP_REQUEUE
+# define FUTEX_CMP_REQUEUE 4
+#endif
+#ifndef FUTEX_WAIT_BITSET
+# define FUTEX_WAIT_BITSET 9
+#endif
+#ifndef FUTEX_PRIVATE_FLAG
+# define FUTEX_PRIVATE_FLAG 128
+#endif
+#ifndef FUTEX_CLOCK_REALTIME
+# define FUTEX_CLOCK_REALTIME 256
+#endif
+#ifndef FUTEX_BITSET_MATCH_ANY
+# define FUTEX_BITSET_MATCH_ANY 0xffffffff
+#endif
+
+/**
+ ** @brief The number of times that ::mtx_lock polls a locked mutex
+ ** before the thread is parked in the kernel.
+ **/
+#ifndef P99_MTX_SPIN
+# define P99_MTX_SPIN 100
+#endif
+
+enum {
+  p00_mtx_waiters = 0x80000000u,
+  p00_mtx_tid = 0x3fffffffu,
+};
+
+/* Return the futex result or the negated error code. */
+p99_inline
+int p00_thrd_futex(_Atomic(unsigned) volatile* p00_uaddr, int p00_op, unsigned p00_val,
+                   struct timespec const* p00_ts,
+                   _Atomic(unsigned) volatile* p00_uaddr2, unsigned p00_val3) {
+  register int p00_ret = syscall(SYS_futex, (void*)p00_uaddr, p00_op | FUTEX_PRIVATE_FLAG,
+                                 p00_val, p00_ts, (void*)p00_uaddr2, p00_val3);
+  if (P99_LIKELY(p00_ret >= 0)) return p00_ret;
+  p00_ret = -errno;
+  errno = 0;
+  return p00_ret;
+}
+
+/* Wait while *p00_uaddr equals p00_val, until the absolute time
+   p00_ts, if any. */
+p99_inline
+int p00_thrd_futex_wait(_Atomic(unsigned) volatile* p00_uaddr, unsigned p00_val,
+                        struct timespec const* p00_ts) {
+  return p00_ts
+    ? p00_thrd_futex(p00_uaddr, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, p00_val, p00_ts, 0, FUTEX_BITSET_MATCH_ANY)
+    : p00_thrd_futex(p00_uaddr, FUTEX_WAIT, p00_val, 0, 0, 0);
+}
+
+/* The thread ID is the token of ownership of a mutex, so we cache
+   it. As for p99_pi, the child of a fork clears the cache of the
+   thread that called fork. call_once is not yet defined when this
+   file is included, so use pthread_once directly. */
+P99_DECLARE_THREAD_LOCAL(unsigned, p00_thrd_tid);
+
+P99_WEAK(p00_thrd_tid_once)
+pthread_once_t p00_thrd_tid_once = PTHREAD_ONCE_INIT;
+
+P99_WEAK(p00_thrd_tid_reset)
+void p00_thrd_tid_reset(void) {
+  P99_THREAD_LOCAL(p00_thrd_tid) = 0;
+}
+
+P99_WEAK(p00_thrd_tid_atfork)
+void p00_thrd_tid_atfork(void) {
+  pthread_atfork(0, 0, p00_thrd_tid_reset);
+}
+
+p99_inline
+unsigned p00_thrd_gettid(void) {
+  register unsigned p00_tid = P99_THREAD_LOCAL(p00_thrd_tid);
+  if (P99_UNLIKELY(!p00_tid)) {
+    pthread_once(&p00_thrd_tid_once, p00_thrd_tid_atfork);
+    p00_tid = syscall(SYS_gettid);
+    P99_THREAD_LOCAL(p00_thrd_tid) = p00_tid;
+  }
+  return p00_tid;
+}
+
+#if P00_THREADS_FUTEX
+
+/* Acquire the mutex. A thread that comes back from a condition wait
+   passes p00_mtx_waiters for p00_flag, since other threads may have
+   been requeued to the mutex together with it. */
+p99_inline
+int p00_mtx_lock(struct p00_mtx* p00_m, struct timespec const* p00_ts, unsigned p00_flag) {
+  register unsigned const p00_tid = p00_thrd_gettid();
+  unsigned p00_act = 0u;
+  if (P99_LIKELY(atomic_compare_exchange_strong(&p00_m->p00_w, &p00_act, p00_tid | p00_flag)))
+    return thrd_success;
+  if ((p00_act & p00_mtx_tid) == p00_tid) {
+    if (!(p00_m->p00_type & mtx_recursive) || p00_m->p00_rec == USHRT_MAX)
+      return thrd_error;
+    ++p00_m->p00_rec;
+    return thrd_success;
+  }
+  for (unsigned p00_i = 0; p00_i < P99_MTX_SPIN; ++p00_i) {
+    p00_act = atomic_load_explicit(&p00_m->p00_w, memory_order_relaxed);
+    if (!p00_act
+        && atomic_compare_exchange_weak(&p00_m->p00_w, &p00_act, p00_tid | p00_flag))
+      return thrd_success;
+  }
+  for (;;) {
+    p00_act = atomic_load(&p00_m->p00_w);
+    if (!p00_act) {
+      /* We don't know if there are other waiters, so we have to
+         assume that there are. */
+      if (atomic_compare_exchange_weak(&p00_m->p00_w, &p00_act, p00_tid | p00_mtx_waiters))
+        return thrd_success;
+      continue;
+    }
+    if (!(p00_act & p00_mtx_waiters)) {
+      if (!atomic_compare_exchange_weak(&p00_m->p00_w, &p00_act, p00_act | p00_mtx_waiters))
+        continue;
+      p00_act |= p00_mtx_waiters;
+    }
+    if (p00_thrd_futex_wait(&p00_m->p00_w, p00_act, p00_ts) == -ETIMEDOUT)
+      return thrd_timedout;
+  }
+}
+
+/* Release the mutex, regardless of its recursion depth. */
+p99_inline
+void p00_mtx_unlock(struct p00_mtx* p00_m) {
+  if (P99_UNLIKELY(atomic_exchange(&p00_m->p00_w, 0u) & p00_mtx_waiters))
+    p00_thrd_futex(&p00_m->p00_w, FUTEX_WAKE, 1, 0, 0, 0);
+}
+
+// 7.26.3 Condition variable functions
+
+/**
+ ** @related cnd_t
+ **
+ ** @return ::thrd_success
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int cnd_broadcast(cnd_t *p00_cond) {
+  struct p00_cnd* p00_c = &P99_ENCP(p00_cond);
+  register unsigned const p00_seq = atomic_fetch_add(&p00_c->p00_seq, 1u) + 1u;
+  if (atomic_load(&p00_c->p00_wait)) {
+    struct p00_mtx* p00_m = p00_c->p00_mtx;
+    /* Wake up one and move the others to the mutex. If there was
+       another signal in between, just wake up everybody. */
+    if (!p00_m
+        || p00_thrd_futex(&p00_c->p00_seq, FUTEX_CMP_REQUEUE, 1,
+                          (struct timespec const*)(uintptr_t)INT_MAX,
+                          &p00_m->p00_w, p00_seq) < 0)
+      p00_thrd_futex(&p00_c->p00_seq, FUTEX_WAKE, INT_MAX, 0, 0, 0);
+  }
+  return thrd_success;
+}
+
+/**
+ ** @related cnd_t
+ **/
+p99_inline
+void cnd_destroy(cnd_t *p00_cond) {
+  (void)p00_cond;
+}
+
+/**
+ ** @related cnd_t
+ **
+ ** @return ::thrd_success
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int cnd_init(cnd_t *p00_cond) {
+  struct p00_cnd* p00_c = &P99_ENCP(p00_cond);
+  atomic_init(&p00_c->p00_seq, 0u);
+  atomic_init(&p00_c->p00_wait, 0u);
+  p00_c->p00_mtx = 0;
+  return thrd_success;
+}
+
+/**
+ ** @related cnd_t
+ **
+ ** @return ::thrd_success
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int cnd_signal(cnd_t *p00_cond) {
+  struct p00_cnd* p00_c = &P99_ENCP(p00_cond);
+  atomic_fetch_add(&p00_c->p00_seq, 1u);
+  if (atomic_load(&p00_c->p00_wait))
+    p00_thrd_futex(&p00_c->p00_seq, FUTEX_WAKE, 1, 0, 0, 0);
+  return thrd_success;
+}
+
+p99_inline
+int p00_cnd_wait(cnd_t *restrict p00_cond, mtx_t *restrict p00_mtx, const struct timespec *restrict p00_ts) {
+  struct p00_cnd* p00_c = &P99_ENCP(p00_cond);
+  struct p00_mtx* p00_m = &P99_ENCP(p00_mtx);
+  if ((atomic_load(&p00_m->p00_w) & p00_mtx_tid) != p00_thrd_gettid()) return thrd_error;
+  p00_c->p00_mtx = p00_m;
+  /* Register as a waiter before we read the sequence number, such
+     that a signal either sees us or changes the number. */
+  atomic_fetch_add(&p00_c->p00_wait, 1u);
+  register unsigned const p00_seq = atomic_load(&p00_c->p00_seq);
+  register unsigned short const p00_rec = p00_m->p00_rec;
+  p00_m->p00_rec = 0;
+  p00_mtx_unlock(p00_m);
+  register int const p00_ret = p00_thrd_futex_wait(&p00_c->p00_seq, p00_seq, p00_ts);
+  atomic_fetch_sub(&p00_c->p00_wait, 1u);
+  p00_mtx_lock(p00_m, 0, p00_mtx_waiters);
+  p00_m->p00_rec = p00_rec;
+  return (p00_ret == -ETIMEDOUT) ? thrd_timedout : thrd_success;
+}
+
+/**
+ ** @related cnd_t
+ **
+ ** @return ::thrd_success upon success, or ::thrd_timedout if the
+ ** time specified in the call was reached without acquiring the
+ ** requested resource, or ::thrd_error if the request could not be
+ ** honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int cnd_timedwait(cnd_t *restrict p00_cond, mtx_t *restrict p00_mtx, const struct timespec *restrict p00_ts) {
+  return p00_cnd_wait(p00_cond, p00_mtx, p00_ts);
+}
+
+/**
+ ** @related cnd_t
+ **
+ ** @return ::thrd_success on success, or ::thrd_error if the request
+ ** could not be honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int cnd_wait(cnd_t *p00_cond, mtx_t *p00_mtx) {
+  return p00_cnd_wait(p00_cond, p00_mtx, 0);
+}
+
+// 7.26.4 Mutex functions
+
+/**
+ ** @related mtx_t
+ **/
+p99_inline
+void mtx_destroy(mtx_t *p00_mtx) {
+  (void)p00_mtx;
+}
+
+/**
+ ** @related mtx_t
+ **
+ ** @param p00_mtx A pointer to an unitialized mutex object
+ ** @param p00_type One of the constants in ::mtx_type
+ **
+ ** @return ::thrd_success on success, or ::thrd_error if the request
+ ** could not be honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int mtx_init(mtx_t *p00_mtx, int p00_type) {
+  switch (p00_type & mtx_extras) {
+  case 0: case mtx_normal: case mtx_errorcheck: case mtx_recursive: break;
+  default: return thrd_error;
+  }
+  struct p00_mtx* p00_m = &P99_ENCP(p00_mtx);
+  atomic_init(&p00_m->p00_w, 0u);
+  p00_m->p00_type = p00_type;
+  p00_m->p00_rec = 0;
+  return thrd_success;
+}
+
+/**
+ ** @related mtx_t
+ ** @return ::thrd_success on success, or ::thrd_error if the request
+ ** could not be honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int mtx_lock(mtx_t *p00_mtx) {
+  return p00_mtx_lock(&P99_ENCP(p00_mtx), 0, 0u);
+}
+
+/**
+ ** @related mtx_t
+ **
+ ** @return ::thrd_success upon success, or ::thrd_timedout if the
+ ** time specified in the call was reached without acquiring the
+ ** requested resource, or ::thrd_error if the request could not be
+ ** honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int mtx_timedlock(mtx_t *restrict p00_mtx, const struct timespec *restrict p00_ts) {
+  return p00_mtx_lock(&P99_ENCP(p00_mtx), p00_ts, 0u);
+}
+
+/**
+ ** @related mtx_t
+ **
+ ** @return ::thrd_success on success, or ::thrd_busy if the resource
+ ** requested is already in use, or ::thrd_error if the request could
+ ** not be honored.
+ **/
+p99_inline
+int mtx_trylock(mtx_t *p00_mtx) {
+  struct p00_mtx* p00_m = &P99_ENCP(p00_mtx);
+  register unsigned const p00_tid = p00_thrd_gettid();
+  unsigned p00_act = 0u;
+  if (atomic_compare_exchange_strong(&p00_m->p00_w, &p00_act, p00_tid))
+    return thrd_success;
+  if ((p00_act & p00_mtx_tid) == p00_tid && (p00_m->p00_type & mtx_recursive)) {
+    if (p00_m->p00_rec == USHRT_MAX) return thrd_error;
+    ++p00_m->p00_rec;
+    return thrd_success;
+  }
+  return thrd_busy;
+}
+
+/**
+ ** @related mtx_t
+ ** @return ::thrd_success on success, or ::thrd_error if the request
+ ** could not be honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int mtx_unlock(mtx_t *p00_mtx) {
+  struct p00_mtx* p00_m = &P99_ENCP(p00_mtx);
+  if (p00_m->p00_type & (mtx_recursive | mtx_errorcheck)) {
+    if ((atomic_load_explicit(&p00_m->p00_w, memory_order_relaxed) & p00_mtx_tid) != p00_thrd_gettid())
+      return thrd_error;
+    if (p00_m->p00_rec) {
+      --p00_m->p00_rec;
+      return thrd_success;
+    }
+  }
+  p00_mtx_unlock(p00_m);
+  return thrd_success;
+}
+
+#endif /* P00_THREADS_FUTEX */
+
+#endif
@@ -41,6 +41,20 @@
  ** @{
  **/
 
+#ifdef __linux__
+# include <unistd.h>
+# include <sys/syscall.h>
+long syscall(long number, ...);
+#endif
+
+#if defined(P99_FUTEX_THREADS) && defined(__linux__) && !defined(NO_FUTEX)
+# define P00_THREADS_FUTEX 1
+#endif
+
+#if defined(P99_THRD_CACHE) && (P99_THRD_CACHE > 0) && defined(__linux__) && !defined(NO_FUTEX)
+# define P00_THRD_CACHE 1
+#endif
+
 /**
  ** @addtogroup thread_macros
  ** @{
@@ -84,6 +98,31 @@
  ** @{
  **/
 
+#if P00_THREADS_FUTEX
+struct p00_mtx {
+  /* The TID of the owner, if any, and FUTEX_WAITERS. */
+  _Atomic(unsigned) p00_w;
+  unsigned short p00_type;
+  /* The recursion depth, only modified by the owner. */
+  unsigned short p00_rec;
+};
+
+struct p00_cnd {
+  _Atomic(unsigned) p00_seq;
+  _Atomic(unsigned) p00_wait;
+  /* The mutex of the waiters, target for a requeue. */
+  struct p00_mtx* volatile p00_mtx;
+};
+
+/**
+ ** @brief complete object type that holds an identifier for a
+ ** condition variable
+ **
+ ** @remark With ::P99_FUTEX_THREADS this is a sequence counter on
+ ** which the waiters block with a Linux futex.
+ **/
+P99_ENC_DECLARE(struct p00_cnd, cnd_t);
+#else
 /**
  ** @brief complete object type that holds an identifier for a
  ** condition variable
@@ -91,6 +130,7 @@
  ** @remark This type is just a wrapper around a POSIX @c pthread_cond_t.
  **/
 P99_ENC_DECLARE(pthread_cond_t, cnd_t);
+#endif
 
 typedef struct p00_thrd p00_thrd;
 /**
@@ -107,12 +147,22 @@ typedef struct p00_thrd p00_thrd;
  **/
 P99_ENC_DECLARE(struct p00_thrd*, thrd_t);
 
+#if P00_THREADS_FUTEX
+/**
+ ** @brief complete object type that holds an identifier for a mutex
+ **
+ ** @remark With ::P99_FUTEX_THREADS this is a 4 byte futex word plus
+ ** the type and the recursion depth.
+ **/
+P99_ENC_DECLARE(struct p00_mtx, mtx_t);
+#else
 /**
  ** @brief complete object type that holds an identifier for a mutex
  **
  ** @remark This type is just a wrapper around a POSIX @c pthread_mutex_t.
  **/
 P99_ENC_DECLARE(pthread_mutex_t, mtx_t);
+#endif
 
 /**
  ** @brief function pointer type <code>int (*)(void*)</code> that is
@@ -121,17 +171,101 @@ P99_ENC_DECLARE(pthread_mutex_t, mtx_t);
  */
 typedef int (*thrd_start_t)(void*);
 
+/**
+ ** @brief Attributes for a thread that is created with
+ ** ::p99_thrd_create_attr
+ **
+ ** All fields have a neutral value that leaves the corresponding
+ ** property to the system, so an object should be initialized with
+ ** ::P99_THRD_ATTR_INITIALIZER or ::p99_thrd_attr_init and then only
+ ** the desired fields set.
+ **
+ ** @code
+ ** p99_thrd_attr attr = P99_THRD_ATTR_INITIALIZER;
+ ** attr.p99_stacksize = 1u << 16;
+ ** attr.p99_node = 1;
+ ** CPU_SET(7, &attr.p99_cpus);
+ ** attr.p99_hascpus = true;
+ ** thrd_t id;
+ ** p99_thrd_create_attr(&id, my_io_thread, 0, &attr);
+ ** @endcode
+ **
+ ** @see p99_thrd_getattr
+ **/
+P99_DECLARE_STRUCT(p99_thrd_attr);
+
+struct p99_thrd_attr {
+  /**
+   ** @brief The size of the stack, or @c 0 for the system default.
+   **/
+  size_t p99_stacksize;
+  /**
+   ** @brief The size of the guard area below the stack, or @c 0 for
+   ** the system default.
+   **/
+  size_t p99_guardsize;
+  /**
+   ** @brief The NUMA node from which the memory of the thread is
+   ** preferably allocated, or @c -1 for the system default.
+   **
+   ** This sets the memory policy of the thread. It does not restrict
+   ** the CPUs on which the thread runs, use #p99_cpus for that.
+   **/
+  int p99_node;
+#if defined(CPU_SETSIZE) || defined(P00_DOXYGEN)
+  /**
+   ** @brief Whether or not #p99_cpus should be used.
+   **/
+  bool p99_hascpus;
+  /**
+   ** @brief The set of CPUs on which the thread may run.
+   **
+   ** @remark Only available where @c cpu_set_t is, e.g with glibc if
+   ** @c _GNU_SOURCE is defined.
+   **/
+  cpu_set_t p99_cpus;
+#endif
+};
+
+/**
+ ** @brief Initialize a ::p99_thrd_attr such that all attributes are
+ ** left to the system.
+ **/
+#define P99_THRD_ATTR_INITIALIZER { .p99_node = -1, }
+
+/**
+ ** @brief Initialize a ::p99_thrd_attr such that all attributes are
+ ** left to the system.
+ ** @related p99_thrd_attr
+ **/
+p99_inline
+p99_thrd_attr* p99_thrd_attr_init(p99_thrd_attr* p00_attr) {
+  if (p00_attr) *p00_attr = (p99_thrd_attr)P99_THRD_ATTR_INITIALIZER;
+  return p00_attr;
+}
+
 
 
 /**
  ** @}
  **/
 
+#if P00_THRD_CACHE
+enum { p00_thrd_finished = 1u, p00_thrd_detached = 2u, };
+#endif
+
 struct p00_thrd {
   atomic_flag p00_detached;
+#if P00_THRD_CACHE
+  /* A futex that holds p00_thrd_finished and p00_thrd_detached. */
+  _Atomic(unsigned) p00_state;
+#endif
   unsigned p00_foreign;
   int p00_ret;
   pthread_t p00_id;
+  /* The attributes if the thread was created with some, they are
+     allocated together with the context. */
+  p99_thrd_attr const* p00_attr;
   union {
     struct {
       thrd_start_t p00_func;
@@ -226,25 +360,20 @@ P99_DECLARE_THREAD_LOCAL(p00_thrd *, p00_thrd_local);
 P99_WEAK(p00_foreign_nb)
 _Atomic(size_t) p00_foreign_nb;
 
-P99_WEAK(p00_foreign_tab)
-p00_thrd ** p00_foreign_tab;
+/* The context of a foreign thread is freed when that thread exits. */
+P99_WEAK(p00_foreign_free)
+void p00_foreign_free(void* p00_cntxt) {
+  if (P00_THRD_LOCAL == p00_cntxt) P00_THRD_LOCAL = 0;
+  free(p00_cntxt);
+}
+
+P99_WEAK(p00_foreign_key)
+p99_tss p00_foreign_key = { .p99_dtor = p00_foreign_free, };
 
 P99_WEAK(p00_foreign_cleanup)
 void p00_foreign_cleanup(void) {
-  size_t p00_foreign = atomic_load_explicit(&p00_foreign_nb, memory_order_consume);
-  p00_thrd ** p00_thrd = p00_foreign_tab;
-  p00_foreign_tab = 0;
-  if (p00_foreign) {
-    /* Ensure that all data is synchronized with all threads, not only
-       with the last one that changed p00_foreign_nb. */
-    atomic_thread_fence(memory_order_seq_cst);
-    for (size_t p00_i = 0; p00_i < p00_foreign; ++p00_i) {
-      if (!pthread_equal(p00_thrd[p00_i]->p00_id, pthread_self()))
-        fputs("found foreign thread\n", stderr);
-      free(p00_thrd[p00_i]);
-    }
-  }
-  free(p00_thrd);
+  /* The thread that calls exit doesn't run the TSS destructors. */
+  (void)p99_tss_set(&p00_foreign_key, 0);
 }
 
 /**
@@ -258,16 +387,13 @@ thrd_t thrd_current(void) {
   if (P99_UNLIKELY(!p00_loc)) {
     size_t p00_nb = atomic_fetch_add_explicit(&p00_foreign_nb, 1, memory_order_acq_rel);
     if (!p00_nb) atexit(p00_foreign_cleanup);
-    if ((p00_nb^(p00_nb-1)) == (p00_nb+(p00_nb-1))) {
-      p00_foreign_tab = realloc(p00_foreign_tab, sizeof(p00_thrd*[2*(p00_nb+1)]));
-    }
     p00_loc = malloc(sizeof *p00_loc);
-    p00_foreign_tab[p00_nb] = p00_loc;
     *p00_loc = (p00_thrd) {
       .p00_id = pthread_self(),
       .p00_foreign = p00_nb + 1,
     };
     P00_THRD_LOCAL = p00_loc;
+    (void)p99_tss_set(&p00_foreign_key, p00_loc);
     if (p00_nb) {
       union {
         unsigned char raw[16];
@@ -294,6 +420,105 @@ int thrd_equal(thrd_t p00_thr0, thrd_t p00_thr1) {
 }
 
 
+#if P00_THREADS_FUTEX || P00_THRD_CACHE
+# include "p99_threads_futex.h"
+#endif
+#if P00_THRD_CACHE
+# include "p99_lifo.h"
+#endif
+
+#if P00_THRD_CACHE
+
+/**
+ ** @addtogroup thread_macros
+ ** @{
+ **/
+
+#if defined(P00_DOXYGEN)
+/**
+ ** @brief Define this to the number of idle POSIX threads that are
+ ** kept for reuse by ::thrd_create.
+ **
+ ** Without this, each ::thrd_create creates a new POSIX thread, which
+ ** is torn down when the C11 thread terminates. With this, the POSIX
+ ** thread of a terminated C11 thread runs the ::at_thrd_exit handlers
+ ** and the destructors of all ::tss_t, and then parks on a futex
+ ** until ::thrd_create hands it a new start function. Such a start
+ ** of a thread is just a wake up.
+ **
+ ** The ::thrd_t of each C11 thread is distinct, and ::thrd_join and
+ ** ::thrd_detach work as before.
+ **
+ ** @warning Objects of ::thread_local storage duration are not
+ ** reinitialized when a POSIX thread is reused. Only use this if your
+ ** thread functions don't rely on the initial value of such objects.
+ **
+ ** @warning Only the destructors of keys that are created with
+ ** ::tss_create (or that are used by ::P99_TSS_DECLARE_LOCAL) are
+ ** run. If there are more than ::P99_TSS_MAX such keys, threads are
+ ** not reused.
+ **
+ ** @remark This is only available on Linux, since threads park on a
+ ** futex.
+ **/
+# define P99_THRD_CACHE 16
+/**
+ ** @brief The maximal number of TSS keys with destructors that are
+ ** supported by ::P99_THRD_CACHE.
+ **/
+# define P99_TSS_MAX 64
+#endif
+
+/**
+ ** @}
+ **/
+
+P99_DECLARE_STRUCT(p00_thrd_worker);
+P99_POINTER_TYPE(p00_thrd_worker);
+P99_LIFO_DECLARE(p00_thrd_worker_ptr);
+
+struct p00_thrd_worker {
+  p00_thrd_worker_ptr p99_lifo;
+  /* Set for a thread that has special attributes, it is not reused. */
+  bool p00_once;
+  /* A futex that is set when a new job is assigned. */
+  _Atomic(unsigned) p00_go;
+  p00_thrd* p00_job;
+};
+
+P99_WEAK(p00_thrd_idle)
+P99_LIFO(p00_thrd_worker_ptr) p00_thrd_idle;
+
+P99_WEAK(p00_thrd_nidle)
+_Atomic(size_t) p00_thrd_nidle;
+
+P99_SETJMP_INLINE(p00_thrd_create)
+void * p00_thrd_create(void* p00_context);
+
+/* The start routine of the POSIX threads in the cache. */
+P99_WEAK(p00_thrd_work)
+void * p00_thrd_work(void* p00_context) {
+  p00_thrd_worker* p00_w = p00_context;
+  for (;;) {
+    p00_thrd_create(p00_w->p00_job);
+    if (p00_w->p00_once
+        || p00_tss_overflow
+        || atomic_fetch_add(&p00_thrd_nidle, 1u) >= P99_THRD_CACHE) {
+      if (!p00_w->p00_once && !p00_tss_overflow) atomic_fetch_sub(&p00_thrd_nidle, 1u);
+      free(p00_w);
+      return 0;
+    }
+    atomic_store(&p00_w->p00_go, 0u);
+    P99_LIFO_PUSH(&p00_thrd_idle, p00_w);
+    while (!atomic_load(&p00_w->p00_go))
+      p00_thrd_futex_wait(&p00_w->p00_go, 0u, 0);
+  }
+}
+
+#endif
+
+#if !P00_THREADS_FUTEX
+
 // 7.26.3 Condition variable functions
 
 /**
@@ -487,21 +712,65 @@ int mtx_unlock(mtx_t *p00_mtx) {
   return pthread_mutex_unlock(&P99_ENCP(p00_mtx)) ? thrd_error : thrd_success;
 }
 
+#endif
 
 P99_SETJMP_INLINE(p00_thrd_create)
 void * p00_thrd_create(void* p00_context);
 
+/* Apply the attributes that can be set before the POSIX thread is
+   created. */
+p99_inline
+int p00_thrd_attr_set(pthread_attr_t* p00_pattr, p99_thrd_attr const* p00_attr) {
+  int p00_ret = 0;
+  if (p00_attr->p99_stacksize && !p00_ret)
+    p00_ret = pthread_attr_setstacksize(p00_pattr, p00_attr->p99_stacksize);
+  if (p00_attr->p99_guardsize && !p00_ret)
+    p00_ret = pthread_attr_setguardsize(p00_pattr, p00_attr->p99_guardsize);
+#if defined(CPU_SETSIZE) && defined(__GLIBC__)
+  if (p00_attr->p99_hascpus && !p00_ret)
+    p00_ret = pthread_attr_setaffinity_np(p00_pattr, sizeof p00_attr->p99_cpus, &p00_attr->p99_cpus);
+#endif
+  return p00_ret;
+}
+
+/* Apply the attributes that can only be set by the thread itself. */
+p99_inline
+void p00_thrd_attr_self(p99_thrd_attr const* p00_attr) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  if (p00_attr->p99_node >= 0) {
+    enum { p00_mpol_preferred = 1, p00_bits = sizeof(unsigned long)*CHAR_BIT, };
+    unsigned long p00_mask[16] = { 0 };
+    if ((size_t)p00_attr->p99_node < sizeof p00_mask * CHAR_BIT) {
+      p00_mask[p00_attr->p99_node / p00_bits] |= 1ul << (p00_attr->p99_node % p00_bits);
+      /* This is only a hint, so ignore failure. */
+      if (syscall(SYS_set_mempolicy, p00_mpol_preferred, p00_mask, sizeof p00_mask * CHAR_BIT))
+        errno = 0;
+    }
+  }
+#else
+  (void)p00_attr;
+#endif
+}
+
 /**
+ ** @brief Create a thread with attributes @a p00_attr
  ** @related thrd_t
  **
+ ** This is an extension of ::thrd_create. If @a p00_attr is not null,
+ ** a copy of @a *p00_attr is kept with the thread, and
+ ** ::p99_thrd_getattr can be used to query it.
+ **
  ** @return ::thrd_success on success, or ::thrd_nomem if no memory
  ** could be allocated for the thread requested, or ::thrd_error if
- ** the request could not be honored.
+ ** the request could not be honored, in particular if an attribute
+ ** has an invalid value.
+ ** @see p99_thrd_attr
  **/
 P99_WARN_UNUSED_RESULT
 p99_inline
-int thrd_create(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg) {
-  p00_thrd * p00_cntxt = malloc(sizeof *p00_cntxt);
+int p99_thrd_create_attr(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg,
+                         p99_thrd_attr const* p00_attr) {
+  p00_thrd * p00_cntxt = malloc(sizeof *p00_cntxt + (p00_attr ? sizeof *p00_attr : 0));
   if (!p00_cntxt) return thrd_nomem;
   *p00_cntxt = (p00_thrd const) {
     .p00_ovrl = {
@@ -512,7 +781,52 @@ int thrd_create(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg) {
     },
     .p00_detached = ATOMIC_FLAG_INIT,
   };
-  int p00_ret = pthread_create(&p00_cntxt->p00_id, 0, p00_thrd_create, p00_cntxt);
+  if (p00_attr) {
+    p99_thrd_attr* p00_copy = (p99_thrd_attr*)(p00_cntxt + 1);
+    *p00_copy = *p00_attr;
+    p00_cntxt->p00_attr = p00_copy;
+  }
+  pthread_attr_t p00_pattr;
+  int p00_ret = 0;
+#if P00_THRD_CACHE
+  atomic_init(&p00_cntxt->p00_state, 0u);
+  /* A thread with attributes needs a new POSIX thread. */
+  p00_thrd_worker* p00_w = p00_attr ? 0 : P99_LIFO_POP(&p00_thrd_idle);
+  if (p00_w) {
+    atomic_fetch_sub(&p00_thrd_nidle, 1u);
+    p00_w->p00_job = p00_cntxt;
+    atomic_store(&p00_w->p00_go, 1u);
+    p00_thrd_futex(&p00_w->p00_go, FUTEX_WAKE, 1, 0, 0, 0);
+    P99_ENCP(p00_thr) = p00_cntxt;
+    return thrd_success;
+  }
+  p00_w = malloc(sizeof *p00_w);
+  if (!p00_w) {
+    free(p00_cntxt);
+    return thrd_nomem;
+  }
+  *p00_w = (p00_thrd_worker) { .p00_job = p00_cntxt, .p00_once = !!p00_attr, };
+  p00_ret = pthread_attr_init(&p00_pattr);
+  if (!p00_ret) {
+    /* Nobody joins the POSIX thread itself. */
+    p00_ret = pthread_attr_setdetachstate(&p00_pattr, PTHREAD_CREATE_DETACHED);
+    if (p00_attr && !p00_ret) p00_ret = p00_thrd_attr_set(&p00_pattr, p00_attr);
+    if (!p00_ret) p00_ret = pthread_create(&p00_cntxt->p00_id, &p00_pattr, p00_thrd_work, p00_w);
+    pthread_attr_destroy(&p00_pattr);
+  }
+  if (P99_UNLIKELY(p00_ret)) free(p00_w);
+#else
+  if (p00_attr) {
+    p00_ret = pthread_attr_init(&p00_pattr);
+    if (!p00_ret) {
+      p00_ret = p00_thrd_attr_set(&p00_pattr, p00_attr);
+      if (!p00_ret) p00_ret = pthread_create(&p00_cntxt->p00_id, &p00_pattr, p00_thrd_create, p00_cntxt);
+      pthread_attr_destroy(&p00_pattr);
+    }
+  } else {
+    p00_ret = pthread_create(&p00_cntxt->p00_id, 0, p00_thrd_create, p00_cntxt);
+  }
+#endif
   if (P99_UNLIKELY(p00_ret)) {
     free(p00_cntxt);
     switch (p00_ret) {
@@ -525,6 +839,36 @@ int thrd_create(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg) {
   }
 }
 
+/**
+ ** @related thrd_t
+ **
+ ** @return ::thrd_success on success, or ::thrd_nomem if no memory
+ ** could be allocated for the thread requested, or ::thrd_error if
+ ** the request could not be honored.
+ **/
+P99_WARN_UNUSED_RESULT
+p99_inline
+int thrd_create(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg) {
+  return p99_thrd_create_attr(p00_thr, p00_func, p00_arg, 0);
+}
+
+/**
+ ** @brief Query the attributes with which thread @a p00_thr has been
+ ** created
+ ** @related thrd_t
+ **
+ ** In particular, <code>p99_thrd_getattr(thrd_current())</code>
+ ** gives access to the attributes of the calling thread.
+ **
+ ** @return a pointer to a copy of the attributes that had been passed
+ ** to ::p99_thrd_create_attr, or @c 0 if the thread has been created
+ ** without.
+ **/
+p99_inline
+p99_thrd_attr const* p99_thrd_getattr(thrd_t p00_thr) {
+  return P99_ENC(p00_thr)->p00_attr;
+}
+
 /**
  ** @related thrd_t
  **
@@ -534,6 +878,12 @@ int thrd_create(thrd_t *p00_thr, thrd_start_t p00_func, void *p00_arg) {
 P99_WARN_UNUSED_RESULT
 p99_inline
 int thrd_detach(thrd_t p00_thr) {
+#if P00_THRD_CACHE
+  /* The POSIX thread is detached, anyhow. */
+  if (atomic_fetch_or(&P99_ENC(p00_thr)->p00_state, p00_thrd_detached) & p00_thrd_finished)
+    free(P99_ENC(p00_thr));
+  return thrd_success;
+#else
   /* The thread is not yet detached so its pthread id is still
      valid. If it already has finished, this will just free the
      resources that pthread holds for it. */
@@ -546,6 +896,7 @@ int thrd_detach(thrd_t p00_thr) {
   } else {
     return p00_ret;
   }
+#endif
 }
 
 #ifdef P00_DOXYGEN
@@ -563,8 +914,7 @@ void thrd_exit(int p00_res) {
       p00_cntxt->p00_ret = p00_res;
       longjmp(p00_cntxt->p00_ovrl.p00_jmp, 1);
     } else {
-      free(p00_cntxt);
-      P00_THRD_LOCAL = 0;
+      (void)p99_tss_set(&p00_foreign_key, 0);
     }
   }
   /* should only be reached by threads that where created directly
@@ -648,8 +998,16 @@ P99_MAIN_INTERCEPT(p99_threads_main) {
 P99_WARN_UNUSED_RESULT
 p99_inline
 int thrd_join(thrd_t p00_thr, int *p00_res) {
+#if P00_THRD_CACHE
+  for (;;) {
+    register unsigned const p00_state = atomic_load(&P99_ENC(p00_thr)->p00_state);
+    if (p00_state & p00_thrd_finished) break;
+    p00_thrd_futex_wait(&P99_ENC(p00_thr)->p00_state, p00_state, 0);
+  }
+#else
   void *p00_res0;
   if (P99_UNLIKELY(pthread_join(P99_ENC(p00_thr)->p00_id, &p00_res0))) return thrd_error;
+#endif
   if (p00_res) *p00_res = P99_ENC(p00_thr)->p00_ret;
   free(P99_ENC(p00_thr));
   return thrd_success;
@@ -685,15 +1043,27 @@ P99_SETJMP_INLINE(p00_thrd_create)
 void * p00_thrd_create(void* p00_context) {
   p00_thrd * p00_cntxt = p00_context;
   P00_THRD_LOCAL = p00_cntxt;
+  if (p00_cntxt->p00_attr) p00_thrd_attr_self(p00_cntxt->p00_attr);
   {
     thrd_start_t p00_func = p00_cntxt->p00_ovrl.p00_init.p00_func;
     void * p00_arg = p00_cntxt->p00_ovrl.p00_init.p00_arg;
     if (!setjmp(p00_cntxt->p00_ovrl.p00_jmp)) {
       p00_cntxt->p00_ret = p00_func(p00_arg);
     }
+#if P00_THRD_CACHE
+    /* The C11 thread terminates here, but not the POSIX thread. */
+    p00_tss_run();
+    if (atomic_fetch_or(&p00_cntxt->p00_state, p00_thrd_finished) & p00_thrd_detached)
+      free(p00_cntxt);
+    else
+      /* This is only an address for the kernel, a joiner may already
+         have freed the context. */
+      p00_thrd_futex(&p00_cntxt->p00_state, FUTEX_WAKE, 1, 0, 0, 0);
+#else
     if (atomic_flag_test_and_set_explicit(&p00_cntxt->p00_detached, memory_order_acq_rel)) {
       free(p00_cntxt);
     }
+#endif
   }
   P00_THRD_LOCAL = 0;
   return 0;
@@ -0,0 +1,350 @@
+/* This may look like nonsense, but it really is -*- mode: C; coding: utf-8 -*- */
+/*                                                                              */
+/* Except for parts copied from previous work and as explicitly stated below,   */
+/* the author and copyright holder for this work is                             */
+/* (C) copyright  2016 Jens Gustedt, INRIA, France                              */
+/*                                                                              */
+/* This file is free software; it is part of the P99 project.                   */
+/*                                                                              */
+/* Licensed under the Apache License, Version 2.0 (the "License");              */
+/* you may not use this file except in compliance with the License.             */
+/* You may obtain a copy of the License at                                      */
+/*                                                                              */
+/*     http://www.apache.org/licenses/LICENSE-2.0                               */
+/*                                                                              */
+/* Unless required by applicable law or agreed to in writing, software          */
+/* distributed under the License is distributed on an "AS IS" BASIS,            */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.     */
+/* See the License for the specific language governing permissions and          */
+/* limitations under the License.                                               */
+/*                                                                              */
+#ifndef P99_TOPOLOGY_H
+#define P99_TOPOLOGY_H 1
+
+#include "p99_threads.h"
+#include <stdio.h>
+#include <unistd.h>
+
+/**
+ ** @addtogroup topology Hardware topology
+ **
+ ** The sizes of caches, the number of cores and the NUMA layout of the
+ ** platform on which a program runs. This information is needed to
+ ** size shards and tiles: e.g a tile that fits into the L2 cache, one
+ ** shard per group of cores that share the last level cache, or one
+ ** memory pool per NUMA node.
+ **
+ ** On Linux the information is read from
+ ** <code>/sys/devices/system/cpu</code> and
+ ** <code>/sys/devices/system/node</code> when it is needed for the
+ ** first time. Where that is not possible, a fallback is used that
+ ** describes a single node with ::P99_CACHE_LINE as cache line size,
+ ** the number of online processors as far as these can be found with
+ ** @c sysconf, and unknown cache sizes.
+ ** @{
+ **/
+
+/**
+ ** @brief The maximal number of processors for which
+ ** ::p99_topology_llc and ::p99_topology_node have information.
+ **/
+#ifndef P99_TOPOLOGY_CPUS
+# define P99_TOPOLOGY_CPUS 1024u
+#endif
+
+/**
+ ** @brief The maximal number of NUMA nodes for which
+ ** ::p99_topology_distance has information.
+ **/
+#ifndef P99_TOPOLOGY_NODES
+# define P99_TOPOLOGY_NODES 64u
+#endif
+
+P99_DECLARE_STRUCT(p99_cache_level);
+
+/**
+ ** @brief Describe one level of the data cache hierarchy.
+ **
+ ** All fields are @c 0 if the level is unknown.
+ ** @see p99_topology
+ **/
+struct p99_cache_level {
+  /** @brief the size in bytes **/
+  size_t p99_size;
+  /** @brief the size of a cache line in bytes **/
+  size_t p99_line;
+  /** @brief the number of processors that share one such cache **/
+  unsigned p99_shared;
+};
+
+P99_DECLARE_STRUCT(p99_topology);
+
+/**
+ ** @brief The hardware topology of the platform.
+ **
+ ** There is only one such object, that is initialized when
+ ** ::p99_topology_get is called for the first time. All fields are
+ ** read only afterwards, so they may be accessed by all threads
+ ** without synchronization.
+ **
+ ** The caches are those of processor @c 0. On platforms with
+ ** processors of different kind, the caches of the others may be
+ ** smaller.
+ **/
+struct p99_topology {
+  /** @brief the size of a cache line, never @c 0 **/
+  size_t p99_line;
+  /** @brief the L1 data cache **/
+  p99_cache_level p99_l1;
+  /** @brief the L2 cache **/
+  p99_cache_level p99_l2;
+  /** @brief the last level cache, may be the same as ::p99_l2 **/
+  p99_cache_level p99_llc;
+  /** @brief the number of online processors, never @c 0 **/
+  unsigned p99_cpus;
+  /** @brief the number of sockets, never @c 0 **/
+  unsigned p99_sockets;
+  /** @brief the number of physical cores per socket, never @c 0 **/
+  unsigned p99_cores;
+  /** @brief the number of hardware threads per core, never @c 0 **/
+  unsigned p99_smt;
+  /** @brief the number of groups of processors that share a last level cache, never @c 0 **/
+  unsigned p99_llcs;
+  /** @brief the number of NUMA nodes, never @c 0 **/
+  unsigned p99_nodes;
+#ifndef P00_DOXYGEN
+  unsigned short p00_llc[P99_TOPOLOGY_CPUS];
+  unsigned short p00_node[P99_TOPOLOGY_CPUS];
+  unsigned char p00_dist[P99_TOPOLOGY_NODES][P99_TOPOLOGY_NODES];
+#endif
+};
+
+P99_WEAK(p00_topology)
+p99_topology p00_topology;
+
+P99_WEAK(p00_topology_once)
+p99_once_flag p00_topology_once;
+
+/* Read the first line of a file in sysfs into p00_buf. */
+p99_inline
+char* p00_topology_read(char* p00_buf, size_t p00_len, char const* p00_form, unsigned p00_a, unsigned p00_b) {
+  char p00_path[128];
+  snprintf(p00_path, sizeof p00_path, p00_form, p00_a, p00_b);
+  FILE* p00_f = fopen(p00_path, "r");
+  if (!p00_f) return 0;
+  char* p00_ret = fgets(p00_buf, p00_len, p00_f);
+  fclose(p00_f);
+  return p00_ret;
+}
+
+p99_inline
+size_t p00_topology_size(char const* p00_form, unsigned p00_a, unsigned p00_b) {
+  char p00_buf[64];
+  if (!p00_topology_read(p00_buf, sizeof p00_buf, p00_form, p00_a, p00_b)) return 0;
+  char* p00_end;
+  size_t p00_ret = strtoull(p00_buf, &p00_end, 10);
+  switch (*p00_end) {
+  case 'K': return p00_ret << 10;
+  case 'M': return p00_ret << 20;
+  case 'G': return p00_ret << 30;
+  default: return p00_ret;
+  }
+}
+
+/* Parse a list of processors or nodes such as "0-3,8-11". Return the
+   number of elements and store the first and the last one in
+   *p00_first and *p00_last. If
+   p00_tab is not null, set its entries of all elements to p00_val. */
+p99_inline
+unsigned p00_topology_list(char const* p00_form, unsigned p00_a, unsigned p00_b,
+                           unsigned* p00_first, unsigned* p00_last,
+                           unsigned short* p00_tab, unsigned p00_val) {
+  char p00_buf[1024];
+  if (!p00_topology_read(p00_buf, sizeof p00_buf, p00_form, p00_a, p00_b)) return 0;
+  unsigned p00_ret = 0;
+  for (char* p00_s = p00_buf; *p00_s >= '0' && *p00_s <= '9';) {
+    unsigned p00_lo = strtoul(p00_s, &p00_s, 10);
+    unsigned p00_hi = (*p00_s == '-') ? strtoul(p00_s + 1, &p00_s, 10) : p00_lo;
+    if (!p00_ret && p00_first) *p00_first = p00_lo;
+    if (p00_last) *p00_last = p00_hi;
+    p00_ret += p00_hi - p00_lo + 1;
+    if (p00_tab)
+      for (unsigned p00_i = p00_lo; p00_i <= p00_hi && p00_i < P99_TOPOLOGY_CPUS; ++p00_i)
+        p00_tab[p00_i] = p00_val;
+    if (*p00_s == ',') ++p00_s;
+  }
+  return p00_ret;
+}
+
+#define P00_TOPOLOGY_CPU "/sys/devices/system/cpu/cpu%u/"
+#define P00_TOPOLOGY_CACHE "/sys/devices/system/cpu/cpu%u/cache/index%u/"
+#define P00_TOPOLOGY_NODE "/sys/devices/system/node/node%u/"
+
+P99_WEAK(p00_topology_init)
+void p00_topology_init(void) {
+  p99_topology* p00_t = &p00_topology;
+  unsigned p00_last = 0;
+  p00_t->p99_cpus = p00_topology_list("/sys/devices/system/cpu/online", 0, 0, 0, &p00_last, 0, 0);
+#ifdef _SC_NPROCESSORS_ONLN
+  if (!p00_t->p99_cpus) {
+    long p00_n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (p00_n > 0) {
+      p00_t->p99_cpus = p00_n;
+      p00_last = p00_n - 1;
+    }
+  }
+#endif
+  if (!p00_t->p99_cpus) p00_t->p99_cpus = 1;
+  if (p00_last >= P99_TOPOLOGY_CPUS) p00_last = P99_TOPOLOGY_CPUS - 1;
+
+  /* The caches of processor 0. The levels are listed from the
+     closest to the farthest, instruction caches are skipped. */
+  unsigned p00_llc = UINT_MAX;
+  for (unsigned p00_i = 0; p00_i < 16; ++p00_i) {
+    char p00_type[32];
+    if (!p00_topology_read(p00_type, sizeof p00_type, P00_TOPOLOGY_CACHE "type", 0, p00_i)) break;
+    if (p00_type[0] == 'I') continue;
+    p99_cache_level p00_c = {
+      .p99_size = p00_topology_size(P00_TOPOLOGY_CACHE "size", 0, p00_i),
+      .p99_line = p00_topology_size(P00_TOPOLOGY_CACHE "coherency_line_size", 0, p00_i),
+      .p99_shared = p00_topology_list(P00_TOPOLOGY_CACHE "shared_cpu_list", 0, p00_i, 0, 0, 0, 0),
+    };
+    switch (p00_topology_size(P00_TOPOLOGY_CACHE "level", 0, p00_i)) {
+    case 1: p00_t->p99_l1 = p00_c; break;
+    case 2: p00_t->p99_l2 = p00_c; break;
+    }
+    p00_t->p99_llc = p00_c;
+    p00_llc = p00_i;
+  }
+  p00_t->p99_line = p00_t->p99_l1.p99_line;
+#ifdef _SC_LEVEL1_DCACHE_LINESIZE
+  if (!p00_t->p99_line) {
+    long p00_n = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    if (p00_n > 0) p00_t->p99_line = p00_n;
+  }
+  if (!p00_t->p99_l1.p99_size) {
+    long p00_n = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (p00_n > 0) p00_t->p99_l1.p99_size = p00_n;
+  }
+#endif
+  if (!p00_t->p99_line) p00_t->p99_line = P99_CACHE_LINE;
+
+  /* Processors that are the first of their core, socket or last
+     level cache represent that unit. */
+  unsigned p00_cores = 0;
+  for (unsigned p00_c = 0; p00_c <= p00_last; ++p00_c) {
+    unsigned p00_first = p00_c;
+    if (p00_topology_list(P00_TOPOLOGY_CPU "topology/thread_siblings_list", p00_c, 0, &p00_first, 0, 0, 0)
+        && p00_first == p00_c)
+      ++p00_cores;
+    p00_first = p00_c;
+    if (p00_topology_list(P00_TOPOLOGY_CPU "topology/core_siblings_list", p00_c, 0, &p00_first, 0, 0, 0)
+        && p00_first == p00_c)
+      ++p00_t->p99_sockets;
+    p00_first = p00_c;
+    if (p00_llc != UINT_MAX
+        && p00_topology_list(P00_TOPOLOGY_CACHE "shared_cpu_list", p00_c, p00_llc, &p00_first, 0, 0, 0)
+        && p00_first == p00_c)
+      ++p00_t->p99_llcs;
+    p00_t->p00_llc[p00_c] = p00_first;
+  }
+  if (!p00_t->p99_sockets) p00_t->p99_sockets = 1;
+  if (!p00_cores) p00_cores = p00_t->p99_cpus;
+  p00_t->p99_cores = (p00_cores + p00_t->p99_sockets - 1)/p00_t->p99_sockets;
+  p00_t->p99_smt = (p00_t->p99_cpus + p00_cores - 1)/p00_cores;
+  if (!p00_t->p99_llcs) p00_t->p99_llcs = (p00_llc == UINT_MAX) ? p00_t->p99_cpus : 1;
+
+  /* The nodes and their distances. Processors that are not found in
+     any node remain with node 0. */
+  unsigned p00_nodes = 0;
+  p00_topology_list("/sys/devices/system/node/online", 0, 0, 0, &p00_nodes, 0, 0);
+  ++p00_nodes;
+  if (p00_nodes > P99_TOPOLOGY_NODES) p00_nodes = P99_TOPOLOGY_NODES;
+  p00_t->p99_nodes = p00_nodes;
+  for (unsigned p00_n = 0; p00_n < p00_nodes; ++p00_n) {
+    p00_topology_list(P00_TOPOLOGY_NODE "cpulist", p00_n, 0, 0, 0, p00_t->p00_node, p00_n);
+    char p00_buf[4*P99_TOPOLOGY_NODES + 2];
+    char* p00_s = p00_topology_read(p00_buf, sizeof p00_buf, P00_TOPOLOGY_NODE "distance", p00_n, 0);
+    for (unsigned p00_m = 0; p00_m < p00_nodes; ++p00_m) {
+      unsigned long p00_d = p00_s ? strtoul(p00_s, &p00_s, 10) : 0;
+      /* By convention the local distance is 10 and the others are
+         larger. */
+      if (!p00_d) p00_d = (p00_n == p00_m) ? 10 : 20;
+      p00_t->p00_dist[p00_n][p00_m] = (p00_d < UCHAR_MAX) ? p00_d : UCHAR_MAX;
+    }
+  }
+}
+
+#undef P00_TOPOLOGY_CPU
+#undef P00_TOPOLOGY_CACHE
+#undef P00_TOPOLOGY_NODE
+
+/**
+ ** @brief Return the hardware topology of the platform.
+ **
+ ** The information is collected at the first call. Later calls only
+ ** cost a check of a flag.
+ **/
+p99_inline
+p99_topology const* p99_topology_get(void) {
+  p99_call_once(&p00_topology_once, p00_topology_init);
+  return &p00_topology;
+}
+
+/**
+ ** @brief Return the size of a cache line of the platform.
+ **
+ ** Other than ::P99_CACHE_LINE, this is the value that is found at
+ ** run time. Use it to size data that is allocated dynamically.
+ **/
+p99_inline
+size_t p99_cache_line(void) {
+  return p99_topology_get()->p99_line;
+}
+
+/**
+ ** @brief Return the first processor of the group of processors that
+ ** share the last level cache with processor @a p00_cpu.
+ **
+ ** The groups can be used as shards: processors of the same group
+ ** exchange data through the shared cache, but data that is shared
+ ** between groups has to go through memory or the interconnect.
+ **/
+p99_inline
+unsigned p99_topology_llc(unsigned p00_cpu) {
+  p99_topology const* p00_t = p99_topology_get();
+  return (p00_cpu < P99_TOPOLOGY_CPUS) ? p00_t->p00_llc[p00_cpu] : p00_cpu;
+}
+
+/**
+ ** @brief Return the NUMA node of processor @a p00_cpu.
+ **/
+p99_inline
+unsigned p99_topology_node(unsigned p00_cpu) {
+  p99_topology const* p00_t = p99_topology_get();
+  return (p00_cpu < P99_TOPOLOGY_CPUS) ? p00_t->p00_node[p00_cpu] : 0u;
+}
+
+/**
+ ** @brief Return the distance between NUMA nodes @a p00_a and @a
+ ** p00_b as given by the firmware.
+ **
+ ** The distance of a node to itself is @c 10 and the others are
+ ** relative to that, e.g @c 21 means that an access to the other
+ ** node costs about 2.1 times as much as a local access.
+ **
+ ** @return the distance, or @c 0 if one of the nodes doesn't exist.
+ **/
+p99_inline
+unsigned p99_topology_distance(unsigned p00_a, unsigned p00_b) {
+  p99_topology const* p00_t = p99_topology_get();
+  return (p00_a < p00_t->p99_nodes && p00_b < p00_t->p99_nodes)
+    ? p00_t->p00_dist[p00_a][p00_b]
+    : 0u;
+}
+
+/**
+ ** @}
+ **/
+
+#endif
@@ -559,8 +559,20 @@ P99_INSTANTIATE(T*, P99_PASTE2(T, _ref_assign), P99_PASTE2(T, _ref) volatile*,
 P99_INSTANTIATE(void, P99_PASTE2(T, _ref_destroy), P99_PASTE2(T, _ref)*)
 
 #ifdef P00_DOXYGEN
+/**
+ ** @brief Define the @c inline functions for a reference counted
+ ** type @a T.
+ **
+ ** @a DELETE is optional and names the function that is called when
+ ** the last reference to an object is released. It defaults to
+ ** <code>T ## _delete</code>. Use <code>T ## _defer_delete</code>
+ ** from ::P99_DECLARE_DEFER_DELETE to move the destruction off the
+ ** thread that releases the reference.
+ **
+ ** @see P99_TP_REF_DECLARE
+ **/
 P00_DOCUMENT_TYPE_ARGUMENT(P99_TP_REF_FUNCTIONS, 0)
-#define P99_TP_REF_FUNCTIONS(T)                                                                                                      \
+#define P99_TP_REF_FUNCTIONS(T, DELETE)                                                                                              \
   /** \brief used for reference counting **/                                                                                         \
   /** \related T **/                                                                                                                 \
 inline T* P99_PASTE2(T, _account)(T*){}                                                                                              \
@@ -604,7 +616,12 @@ P99_MACRO_END(P99_TP_REF_FUNCTIONS)
 
 #else
 P00_DOCUMENT_TYPE_ARGUMENT(P99_TP_REF_FUNCTIONS, 0)
-#define P99_TP_REF_FUNCTIONS(T)                                                       \
+#define P99_TP_REF_FUNCTIONS(...)                                        \
+P99_IF_LT(P99_NARG(__VA_ARGS__), 2)                                      \
+(P00_TP_REF_FUNCTIONS(__VA_ARGS__, P99_PASTE2(__VA_ARGS__, _delete)))    \
+(P00_TP_REF_FUNCTIONS(__VA_ARGS__))
+
+#define P00_TP_REF_FUNCTIONS(T, DELETE)                                               \
                                                                                       \
   inline                                                                              \
   T*                                                                                  \
@@ -615,7 +632,7 @@ P00_DOCUMENT_TYPE_ARGUMENT(P99_TP_REF_FUNCTIONS, 0)
   inline                                                                              \
   T*                                                                                  \
   P99_PASTE2(T, _discount)(T* p00_el) {                                               \
-    return P99_REF_DISCOUNT(p00_el, P99_PASTE2(T, _delete));                          \
+    return P99_REF_DISCOUNT(p00_el, (DELETE));                                        \
   }                                                                                   \
                                                                                       \
   inline                                                                              \
@@ -635,24 +652,24 @@ P00_DOCUMENT_TYPE_ARGUMENT(P99_TP_REF_FUNCTIONS, 0)
                                                                                       \
   inline                                                                              \
   T* P99_PASTE2(T, _ref_replace)(P99_PASTE2(T, _ref) volatile* p00_tar, T* p00_sou) { \
-    return P99_TP_REF_REPLACE(p00_tar, p00_sou, P99_PASTE2(T, _delete));              \
+    return P99_TP_REF_REPLACE(p00_tar, p00_sou, (DELETE));                            \
   }                                                                                   \
                                                                                       \
   inline                                                                              \
   T* P99_PASTE2(T, _ref_mv)(P99_PASTE2(T, _ref) volatile* p00_tar,                    \
                             P99_PASTE2(T, _ref) volatile* p00_sou) {                  \
-    return P99_TP_REF_MV(p00_tar, p00_sou, P99_PASTE2(T, _delete));                   \
+    return P99_TP_REF_MV(p00_tar, p00_sou, (DELETE));                                 \
   }                                                                                   \
                                                                                       \
   inline                                                                              \
   T* P99_PASTE2(T, _ref_assign)(P99_PASTE2(T, _ref) volatile* p00_tar,                \
                                 P99_PASTE2(T, _ref) volatile* p00_sou) {              \
-    return P99_TP_REF_REPLACE(p00_tar, P99_TP_GET(p00_sou), P99_PASTE2(T, _delete));  \
+    return P99_TP_REF_REPLACE(p00_tar, P99_TP_GET(p00_sou), (DELETE));                \
   }                                                                                   \
                                                                                       \
   inline                                                                              \
   void P99_PASTE2(T, _ref_destroy)(P99_PASTE2(T, _ref)* p00_ref) {                    \
-    P99_TP_REF_DESTROY(p00_ref, P99_PASTE2(T, _delete));                              \
+    P99_TP_REF_DESTROY(p00_ref, (DELETE));                                            \
   }                                                                                   \
                                                                                       \
 P99_MACRO_END(P99_TP_REF_FUNCTIONS)
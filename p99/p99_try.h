@@ -92,8 +92,10 @@ void p00_jmp_throw(errno_t p00_cond, p00_jmp_buf0 * p00_top, char const* p00_fil
   if (p00_context) P00_JMP_BUF_CONTEXT = p00_context;
   if (p00_info) P00_JMP_BUF_INFO = p00_info;
   if (!p00_top) p00_top = P99_LIFO_TOP(&P00_JMP_BUF_TOP);
-  if (P99_LIKELY(p00_top)) p00_longjmp(p00_top, p00_cond);
-  else p00_jmp_abort(p00_cond, p00_file, p00_context, p00_info);
+  if (P99_LIKELY(p00_top)) {
+    p00_top->p00_thrown = true;
+    p00_longjmp(p00_top, p00_cond);
+  } else p00_jmp_abort(p00_cond, p00_file, p00_context, p00_info);
 }
 
 
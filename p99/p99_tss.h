@@ -144,6 +144,86 @@ enum thrd_status {
  ** @}
  **/
 
+#if defined(P99_THRD_CACHE) && !defined(P00_DOXYGEN)
+
+/* With the thread cache, the POSIX thread of a terminated C11 thread
+   lives on, so the TSS destructors have to be run explicitly. For
+   that we keep track of all keys that have a destructor. */
+
+# ifndef P99_TSS_MAX
+#  define P99_TSS_MAX 64
+# endif
+
+struct p00_tss_reg {
+  pthread_key_t p00_key;
+  tss_dtor_t p00_dtor;
+};
+
+P99_WEAK(p00_tss_reg)
+struct p00_tss_reg p00_tss_reg[P99_TSS_MAX];
+
+P99_WEAK(p00_tss_nb)
+_Atomic(size_t) p00_tss_nb;
+
+/* Set if there were more keys with destructors than fit into the
+   table. Then POSIX threads can't be reused. */
+P99_WEAK(p00_tss_overflow)
+bool volatile p00_tss_overflow;
+
+P99_WEAK(p00_tss_flg)
+atomic_flag p00_tss_flg;
+
+p99_inline
+void p00_tss_register(pthread_key_t p00_key, tss_dtor_t p00_dtor) {
+  P99_SPIN_EXCLUDE(&p00_tss_flg) {
+    size_t p00_nb = atomic_load(&p00_tss_nb);
+    /* Reuse the slot of a deleted key, if any. */
+    size_t p00_i = 0;
+    for (; p00_i < p00_nb; ++p00_i)
+      if (!p00_tss_reg[p00_i].p00_dtor) break;
+    if (p00_i < P99_TSS_MAX) {
+      p00_tss_reg[p00_i] = (struct p00_tss_reg) { .p00_key = p00_key, .p00_dtor = p00_dtor, };
+      if (p00_i == p00_nb) atomic_store(&p00_tss_nb, p00_nb + 1);
+    } else {
+      p00_tss_overflow = true;
+    }
+  }
+}
+
+p99_inline
+void p00_tss_unregister(pthread_key_t p00_key) {
+  P99_SPIN_EXCLUDE(&p00_tss_flg) {
+    size_t p00_nb = atomic_load(&p00_tss_nb);
+    for (size_t p00_i = 0; p00_i < p00_nb; ++p00_i)
+      if (p00_tss_reg[p00_i].p00_dtor && p00_tss_reg[p00_i].p00_key == p00_key)
+        p00_tss_reg[p00_i].p00_dtor = 0;
+  }
+}
+
+/* Run the destructors of the calling thread, as POSIX would do at
+   thread exit. */
+p99_inline
+void p00_tss_run(void) {
+  for (unsigned p00_it = 0; p00_it < TSS_DTOR_ITERATIONS; ++p00_it) {
+    bool p00_any = false;
+    size_t p00_nb = atomic_load(&p00_tss_nb);
+    for (size_t p00_i = 0; p00_i < p00_nb; ++p00_i) {
+      tss_dtor_t p00_dtor = p00_tss_reg[p00_i].p00_dtor;
+      if (!p00_dtor) continue;
+      pthread_key_t p00_key = p00_tss_reg[p00_i].p00_key;
+      void* p00_val = pthread_getspecific(p00_key);
+      if (p00_val) {
+        (void)pthread_setspecific(p00_key, 0);
+        p00_dtor(p00_val);
+        p00_any = true;
+      }
+    }
+    if (!p00_any) break;
+  }
+}
+
+#endif
+
 /**
  ** @related tss_t
  ** @return ::thrd_success on success, or ::thrd_error if the request
@@ -157,7 +237,11 @@ enum thrd_status {
 P99_WARN_UNUSED_RESULT
 p99_inline
 int tss_create(tss_t *p00_key, tss_dtor_t dtor) {
-  return pthread_key_create(&P99_ENCP(p00_key), dtor) ? thrd_error : thrd_success;
+  if (pthread_key_create(&P99_ENCP(p00_key), dtor)) return thrd_error;
+#if defined(P99_THRD_CACHE) && !defined(P00_DOXYGEN)
+  if (dtor) p00_tss_register(P99_ENCP(p00_key), dtor);
+#endif
+  return thrd_success;
 }
 
 /**
@@ -165,6 +249,9 @@ int tss_create(tss_t *p00_key, tss_dtor_t dtor) {
  **/
 p99_inline
 void tss_delete(tss_t p00_key) {
+#if defined(P99_THRD_CACHE) && !defined(P00_DOXYGEN)
+  p00_tss_unregister(P99_ENC(p00_key));
+#endif
   (void)pthread_key_delete(P99_ENC(p00_key));
 }
 
@@ -238,6 +325,9 @@ struct p99_tss {
   tss_dtor_t p99_dtor;
   bool volatile p00_done;
   atomic_flag p00_flg;
+  /* The position of the variable in the thread local block plus one,
+     if it is used through ::P99_TSS_LOCAL. */
+  size_t volatile p00_off;
 };
 
 typedef struct p99_tss p99_tss;
@@ -365,6 +455,12 @@ P99_PROTOTYPE(int, p99_tss_set, p99_tss*, void *);
  ** ::P99_DECLARE_THREAD_LOCAL such that more efficient realizations
  ** than ::p99_tss could be used for the task.
  **
+ ** All variables with destructor @c free share one block per thread
+ ** that is found through a single key, so they don't use a key of
+ ** their own and are not allocated one by one. Only variables with
+ ** another destructor, or that are larger than ::P99_TSS_CHUNK, have
+ ** their own key and buffer.
+ **
  ** @see P99_TSS_LOCAL to access the variable
  ** @see p99_tss
  **/
@@ -424,7 +520,10 @@ p99_tss NAME = { .p99_dtor = (DTOR), }
  ** example
  ** @see p99_tss
  **/
-#define P99_TSS_LOCAL(NAME) (*(P99_PASTE3(p00_, NAME, _type)*)p99_tss_get_alloc(&(NAME), sizeof(P99_PASTE3(p00_, NAME, _type))))
+#define P99_TSS_LOCAL(NAME)                                              \
+(*(P99_PASTE3(p00_, NAME, _type)*)p00_tss_local(&(NAME),                 \
+                                               sizeof(P99_PASTE3(p00_, NAME, _type)), \
+                                               alignof(P99_PASTE3(p00_, NAME, _type))))
 
 
 /**
@@ -452,6 +551,140 @@ void* p99_tss_get_alloc(p99_tss * p00_key, size_t p00_size) {
   return p00_ret;
 }
 
+/**
+ ** @brief The size of the chunks of the thread local block that holds
+ ** the variables that are accessed through ::P99_TSS_LOCAL.
+ **
+ ** Variables that are larger than this are allocated separately.
+ **/
+#ifndef P99_TSS_CHUNK
+# define P99_TSS_CHUNK 1024u
+#endif
+
+/**
+ ** @brief The maximal number of chunks of size ::P99_TSS_CHUNK in
+ ** the thread local block.
+ **
+ ** Once all chunks are assigned, further variables are allocated
+ ** separately.
+ **/
+#ifndef P99_TSS_CHUNKS
+# define P99_TSS_CHUNKS 32u
+#endif
+
+/* All variables that are accessed through P99_TSS_LOCAL and that have
+   the default destructor live in one block per thread, that is found
+   through one single key. Each variable has a fixed offset in the
+   block, that is assigned at its first use by any thread, and then
+   cached in its p99_tss. Chunks of the block are allocated when a
+   thread first accesses one of their variables, and are never moved,
+   so the addresses of the variables remain valid until the thread
+   exits. */
+P99_DECLARE_STRUCT(p00_tss_block);
+
+struct p00_tss_block {
+  unsigned char* p00_chunk[P99_TSS_CHUNKS];
+};
+
+P99_WEAK(p00_tss_block_free)
+void p00_tss_block_free(void* p00_val) {
+  p00_tss_block* p00_b = p00_val;
+  for (size_t p00_i = 0; p00_i < P99_TSS_CHUNKS; ++p00_i)
+    free(p00_b->p00_chunk[p00_i]);
+  free(p00_b);
+}
+
+P99_WEAK(p00_tss_block_key)
+p99_tss p00_tss_block_key = { .p99_dtor = p00_tss_block_free, };
+
+P99_WEAK(p00_tss_block_top)
+_Atomic(size_t) p00_tss_block_top;
+
+/* Zero initialized memory that is aligned to p00_align, even if
+   that is more than malloc guarantees. It may be freed with free. */
+p99_inline
+void* p00_tss_calloc(size_t p00_size, size_t p00_align) {
+  if (p00_align <= alignof(max_align_t)) return calloc(1, p00_size);
+  void* p00_ret = 0;
+  if (posix_memalign(&p00_ret, p00_align, p00_size)) return 0;
+  return memset(p00_ret, 0, p00_size);
+}
+
+/* Reserve space for a new variable. Variables don't cross the
+   boundary of a chunk, and chunks are aligned to P99_CACHE_LINE,
+   so the offsets in the chunks may be aligned to at most that. Return
+   SIZE_MAX if it doesn't fit. */
+p99_inline
+size_t p00_tss_block_reserve(size_t p00_size, size_t p00_align) {
+  if (!p00_size || p00_size > P99_TSS_CHUNK || p00_align > P99_CACHE_LINE) return SIZE_MAX;
+  size_t p00_top = atomic_load(&p00_tss_block_top);
+  for (;;) {
+    size_t p00_pos = ((p00_top + p00_align - 1)/p00_align)*p00_align;
+    if (p00_pos % P99_TSS_CHUNK + p00_size > P99_TSS_CHUNK)
+      p00_pos += P99_TSS_CHUNK - p00_pos % P99_TSS_CHUNK;
+    if (p00_pos + p00_size > P99_TSS_CHUNK*P99_TSS_CHUNKS) return SIZE_MAX;
+    if (atomic_compare_exchange_weak(&p00_tss_block_top, &p00_top, p00_pos + p00_size))
+      return p00_pos;
+  }
+}
+
+p99_inline
+void* p00_tss_local_slow(p99_tss* p00_key, size_t p00_size, size_t p00_align) {
+  if (P99_UNLIKELY(!p00_key->p00_off)) {
+    /* Make sure that the key of the block exists before the first
+       offset is published. */
+    p00_tss_init(&p00_tss_block_key);
+    P99_SPIN_EXCLUDE(&p00_key->p00_flg) {
+      if (!p00_key->p00_off) {
+        /* Variables with a destructor of their own need a key of
+           their own. */
+        size_t p00_pos = (p00_key->p99_dtor == free)
+          ? p00_tss_block_reserve(p00_size, p00_align)
+          : SIZE_MAX;
+        p00_key->p00_off = (p00_pos == SIZE_MAX) ? SIZE_MAX : p00_pos + 1;
+      }
+    }
+  }
+  if (p00_key->p00_off == SIZE_MAX) {
+    void* p00_ret = p99_tss_get(p00_key);
+    if (!p00_ret) {
+      p00_ret = p00_tss_calloc(p00_size, p00_align);
+      if (!p00_ret || p99_tss_set(p00_key, p00_ret) != thrd_success) {
+        free(p00_ret);
+        return 0;
+      }
+    }
+    return p00_ret;
+  }
+  size_t const p00_pos = p00_key->p00_off - 1;
+  p00_tss_block* p00_b = p99_tss_get(&p00_tss_block_key);
+  if (!p00_b) {
+    p00_b = calloc(1, sizeof *p00_b);
+    if (!p00_b || p99_tss_set(&p00_tss_block_key, p00_b) != thrd_success) {
+      free(p00_b);
+      return 0;
+    }
+  }
+  unsigned char** p00_c = &p00_b->p00_chunk[p00_pos / P99_TSS_CHUNK];
+  if (!*p00_c) *p00_c = p00_tss_calloc(P99_TSS_CHUNK, P99_CACHE_LINE);
+  return *p00_c ? *p00_c + p00_pos % P99_TSS_CHUNK : 0;
+}
+
+/* The access to a variable in the block is one lookup of the key and
+   then two loads and an addition. */
+p99_inline
+void* p00_tss_local(p99_tss* p00_key, size_t p00_size, size_t p00_align) {
+  register size_t const p00_off = p00_key->p00_off;
+  if (P99_LIKELY(p00_off && p00_off != SIZE_MAX)) {
+    p00_tss_block* p00_b = tss_get(p00_tss_block_key.p00_val);
+    if (P99_LIKELY(p00_b)) {
+      unsigned char* p00_c = p00_b->p00_chunk[(p00_off - 1) / P99_TSS_CHUNK];
+      if (P99_LIKELY(p00_c)) return p00_c + (p00_off - 1) % P99_TSS_CHUNK;
+    }
+  }
+  return p00_tss_local_slow(p00_key, p00_size, p00_align);
+}
+
 #if defined(thread_local) && !defined(P99_EMULATE_THREAD_LOCAL) && !defined(P00_DOXYGEN)
 
 #define P99_DECLARE_THREAD_LOCAL(T, NAME)                      \
@@ -1255,6 +1255,41 @@ sub printnumber {
 
 }
 
+{
+    # Sorting networks for small arrays, by Batcher's odd-even merge
+    # sort. For sizes that are not powers of two the comparators that
+    # would involve positions beyond the end are omitted.
+    my $sortnetmax = 32;
+    sub sortnet($) {
+        my ($n) = @_;
+        my @ret;
+        for (my $p = 1; $p < $n; $p *= 2) {
+            for (my $k = $p; $k >= 1; $k = int($k / 2)) {
+                for (my $j = $k % $p; $j + $k < $n; $j += 2 * $k) {
+                    for (my $i = 0; $i < $k && $i + $j + $k < $n; ++$i) {
+                        push(@ret, [$i + $j, $i + $j + $k])
+                            if (int(($i + $j) / (2 * $p)) == int(($i + $j + $k) / (2 * $p)));
+                    }
+                }
+            }
+        }
+        return @ret;
+    }
+
+    print "#define P00_SORTNET_MAX $sortnetmax\n";
+    print "#define P00_SORTNET_SIZES ", join(", ", 2 .. $sortnetmax), "\n";
+    for (my $n = 2; $n <= $sortnetmax; ++$n) {
+        my @net = sortnet($n);
+        print "/* $n elements, ", scalar(@net), " comparators */\n";
+        print "#define P00_SORTNET_$n(CE, X)";
+        for (my $c = 0; $c < @net; ++$c) {
+            print " \\\n" if ($c % 8 == 0);
+            print " CE(X, $net[$c][0], $net[$c][1])";
+        }
+        print "\n";
+    }
+}
+
 
 my @groups =
     [ "P99",
@@ -0,0 +1,743 @@
+/* This may look like nonsense, but it really is -*- mode: C -*-              */
+/*                                                                            */
+/* Except for parts copied from previous work and as explicitly stated below, */
+/* the author and copyright holder for this work is                           */
+/* all rights reserved, 2016 Jens Gustedt, INRIA, France                      */
+/*                                                                            */
+/* This file is free software; it is part of the P99 project.                 */
+/* You can redistribute it and/or modify it under the terms of the QPL as     */
+/* given in the file LICENSE. It is distributed without any warranty;         */
+/* without even the implied warranty of merchantability or fitness for a      */
+/* particular purpose.                                                        */
+/*                                                                            */
+#include <sys/wait.h>
+#include "p99_barrier.h"
+#include "p99_sem.h"
+#include "p99_iterator.h"
+#include "p99_pi.h"
+#include "p99_clib.h"
+#include "p99_thrd_index.h"
+#include "p99_topology.h"
+#include "p99_defer.h"
+#include "p99_malloc.h"
+#include "p99_arena.h"
+#include "p99_large.h"
+
+enum { phases = 1000, };
+
+static p99_barrier flat;
+static p99_barrier tree;
+static _Atomic(unsigned) serial;
+static unsigned* sums[2];
+static size_t nthreads;
+
+P99_DECLARE_STRUCT(barrier_arg);
+struct barrier_arg {
+  unsigned id;
+};
+
+static
+int barrier_task(void* arg) {
+  barrier_arg* a = arg;
+  for (unsigned ph = 0; ph < phases; ++ph) {
+    p99_barrier* bar = (ph % 2) ? &tree : &flat;
+    /* Every fourth phase uses tickets instead of a fixed id. */
+    unsigned id = (ph % 4 == 3) ? P99_BARRIER_NOID : a->id;
+    sums[ph % 2][a->id] = ph;
+    if (p99_barrier_wait(bar, id) == P99_BARRIER_SERIAL_THREAD) {
+      atomic_fetch_add(&serial, 1u);
+      for (size_t i = 0; i < nthreads; ++i)
+        if (sums[ph % 2][i] != ph) {
+          fprintf(stderr, "phase %u: thread %zu is in phase %u\n", ph, i, sums[ph % 2][i]);
+          abort();
+        }
+    }
+  }
+  return 0;
+}
+
+static p99_sem slots = P99_SEM_INITIALIZER(3);
+static p99_sem batch = P99_SEM_INITIALIZER(0);
+static _Atomic(unsigned) inside;
+
+static
+int sem_task(void* arg) {
+  (void)arg;
+  for (unsigned i = 0; i < phases; ++i) {
+    p99_sem_wait(&slots);
+    if (atomic_fetch_add(&inside, 1u) >= 3) {
+      fputs("semaphore admitted too many threads\n", stderr);
+      abort();
+    }
+    atomic_fetch_sub(&inside, 1u);
+    p99_sem_post(&slots);
+  }
+  p99_sem_post(&batch);
+  return 0;
+}
+
+static
+bool sem_test(size_t n) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  if (p99_sem_timedwait(&batch, &ts) != thrd_timedout) return false;
+  thrd_t id[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&id[i], sem_task, 0) != thrd_success) return false;
+  /* All threads have to finish before we can take all tokens. */
+  p99_sem_wait_n(&batch, n);
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_join(id[i], 0) != thrd_success) return false;
+  if (p99_sem_trywait(&batch) != thrd_busy) return false;
+  printf("semaphore: %u slots left\n", p99_sem_value(&slots));
+  return p99_sem_value(&slots) == 3;
+}
+
+static p99_event events;
+/* A prime number of events, such that segments are crossed at
+   arbitrary places. */
+enum { nevents = 10007, };
+
+static
+int producer_task(void* arg) {
+  uintptr_t base = (uintptr_t)arg;
+  for (uintptr_t i = 0; i < nevents; ++i)
+    if (p99_event_signal(&events, (void*)(base*nevents + i + 1)) != thrd_success)
+      abort();
+  return 0;
+}
+
+static
+int consumer_task(void* arg) {
+  unsigned char* seen = arg;
+  for (size_t i = 0; i < nevents; ++i) {
+    uintptr_t ev = (uintptr_t)p99_event_next(&events);
+    if (!ev || seen[ev-1]++) {
+      fprintf(stderr, "event %ju is invalid or seen twice\n", (uintmax_t)ev);
+      abort();
+    }
+  }
+  return 0;
+}
+
+static
+bool event_test(size_t n) {
+  if (!p99_event_init(&events, nevents)) return false;
+  unsigned char* seen = calloc(n*nevents, 1);
+  thrd_t prod[n];
+  thrd_t cons[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&cons[i], consumer_task, seen) != thrd_success
+        || thrd_create(&prod[i], producer_task, (void*)(uintptr_t)i) != thrd_success)
+      return false;
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_join(prod[i], 0) != thrd_success
+        || thrd_join(cons[i], 0) != thrd_success)
+      return false;
+  size_t count = 0;
+  for (size_t i = 0; i < n*nevents; ++i) count += seen[i];
+  printf("event: %zu events consumed\n", count);
+  free(seen);
+  p99_event_destroy(&events);
+  return count == n*nevents;
+}
+
+static p99_pi pi = P99_PI_INITIALIZER;
+static unsigned pi_count;
+
+static
+int pi_task(void* arg) {
+  (void)arg;
+  for (unsigned i = 0; i < phases; ++i)
+    P99_PI_EXCLUDE(&pi) {
+      /* Not atomic, only protected by the lock. */
+      register unsigned c = pi_count;
+      thrd_yield();
+      pi_count = c + 1;
+    }
+  return 0;
+}
+
+static
+bool pi_test(size_t n) {
+  thrd_t id[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&id[i], pi_task, 0) != thrd_success) return false;
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_join(id[i], 0) != thrd_success) return false;
+  if (p99_pi_lock(&pi) != thrd_success) return false;
+  if (p99_pi_trylock(&pi) != thrd_busy) return false;
+#if P00_FUTEX_LINUX
+  /* The kernel refuses to deadlock. */
+  if (p99_pi_lock(&pi) != thrd_error) return false;
+#endif
+  p99_pi_unlock(&pi);
+#if P00_FUTEX_LINUX
+  /* A nested section for the same lock is skipped and doesn't release
+     the outer one. */
+  bool nested = false;
+  bool held = false;
+  P99_PI_EXCLUDE(&pi) {
+    P99_PI_EXCLUDE(&pi) nested = true;
+    held = p99_pi_trylock(&pi) == thrd_busy;
+  }
+  if (nested || !held || p99_pi_trylock(&pi) != thrd_success) return false;
+  p99_pi_unlock(&pi);
+#endif
+#if P00_FUTEX_LINUX
+  /* The child must lock with its own thread ID. */
+#if P00_THREADS_FUTEX || P00_THRD_CACHE
+  /* fill the TID cache of the mutexes */
+  (void)p00_thrd_gettid();
+#endif
+  pid_t pid = fork();
+  if (!pid)
+    _Exit(p99_pi_trylock(&pi) == thrd_success
+          && atomic_load(&pi.p00_w) == (unsigned)syscall(SYS_gettid)
+#if P00_THREADS_FUTEX || P00_THRD_CACHE
+          /* also the owner of a mutex */
+          && p00_thrd_gettid() == (unsigned)syscall(SYS_gettid)
+#endif
+          ? EXIT_SUCCESS
+          : EXIT_FAILURE);
+  int status = 0;
+  if (pid < 0 || waitpid(pid, &status, 0) != pid
+      || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) return false;
+#endif
+  printf("pi: count is %u\n", pi_count);
+  return pi_count == n*phases;
+}
+
+static mtx_t mtx;
+static cnd_t cnd;
+static unsigned mtx_count;
+static unsigned mtx_round;
+
+/* Each thread waits for its turn in a round robin. */
+static
+int mtx_task(void* arg) {
+  size_t me = (uintptr_t)arg;
+  for (unsigned i = 0; i < phases/10; ++i) {
+    if (mtx_lock(&mtx) != thrd_success) abort();
+    /* The mutex is recursive, but may only be held once for a wait. */
+    if (mtx_lock(&mtx) != thrd_success) abort();
+    if (mtx_unlock(&mtx) != thrd_success) abort();
+    while (mtx_round % nthreads != me)
+      if (cnd_wait(&cnd, &mtx) != thrd_success) abort();
+    ++mtx_count;
+    ++mtx_round;
+    if (cnd_broadcast(&cnd) != thrd_success) abort();
+    if (mtx_unlock(&mtx) != thrd_success) abort();
+  }
+  return 0;
+}
+
+static
+bool mtx_test(size_t n) {
+  if (mtx_init(&mtx, mtx_recursive) != thrd_success
+      || cnd_init(&cnd) != thrd_success) return false;
+  thrd_t id[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&id[i], mtx_task, (void*)(uintptr_t)i) != thrd_success) return false;
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_join(id[i], 0) != thrd_success) return false;
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  if (mtx_lock(&mtx) != thrd_success) return false;
+  if (cnd_timedwait(&cnd, &mtx, &ts) != thrd_timedout) return false;
+  if (mtx_unlock(&mtx) != thrd_success) return false;
+  mtx_destroy(&mtx);
+  cnd_destroy(&cnd);
+  printf("mtx: count is %u\n", mtx_count);
+  return mtx_count == n*(phases/10);
+}
+
+static tss_t key;
+static _Atomic(unsigned) dtors;
+static _Atomic(unsigned) exits;
+static _Atomic(unsigned) detached;
+
+static
+void key_dtor(void* p) {
+  (void)p;
+  atomic_fetch_add(&dtors, 1u);
+}
+
+static
+void exit_handler(void) {
+  atomic_fetch_add(&exits, 1u);
+}
+
+static
+int short_task(void* arg) {
+  /* A fresh thread must not see the value of a previous one. */
+  if (tss_get(key)) abort();
+  if (tss_set(key, arg) != thrd_success) abort();
+  at_thrd_exit(exit_handler);
+  if (!arg) {
+    atomic_fetch_add(&detached, 1u);
+    thrd_exit(0);
+  }
+  return (uintptr_t)arg;
+}
+
+/* Create a lot of short lived threads, some of which are joined and
+   some detached. */
+static
+bool short_test(size_t n) {
+#ifdef P99_THRD_CACHE
+  /* more threads than the cache holds, such that some are recycled
+     and some are not */
+  if (n < 2*P99_THRD_CACHE) n = 2*P99_THRD_CACHE;
+#endif
+  if (tss_create(&key, key_dtor) != thrd_success) return false;
+  for (size_t i = 0; i < phases/10; ++i) {
+    thrd_t id[n];
+    for (size_t j = 0; j < n; ++j)
+      if (thrd_create(&id[j], short_task, (void*)(j%2 ? (uintptr_t)j : 0)) != thrd_success)
+        return false;
+    for (size_t j = 0; j < n; ++j) {
+      if (j%2) {
+        int res = 0;
+        if (thrd_join(id[j], &res) != thrd_success || res != (int)j) return false;
+      } else if (thrd_detach(id[j]) != thrd_success) return false;
+    }
+  }
+  size_t const joined = (n/2)*(phases/10);
+  while (atomic_load(&detached) < (n*(phases/10)) - joined || atomic_load(&exits) < n*(phases/10))
+    thrd_yield();
+  printf("short: %u exit handlers, %u tss destructors\n", atomic_load(&exits), atomic_load(&dtors));
+#if P00_THRD_CACHE
+  /* The cache is bounded. */
+  if (atomic_load(&p00_thrd_nidle) > P99_THRD_CACHE) return false;
+#endif
+  return atomic_load(&dtors) >= joined;
+}
+
+#if !p99_has_feature(threads_h)
+static
+int attr_task(void* arg) {
+  p99_thrd_attr const* attr = p99_thrd_getattr(thrd_current());
+  if (!attr || attr->p99_stacksize != ((p99_thrd_attr const*)arg)->p99_stacksize) return 1;
+#if defined(CPU_SETSIZE)
+  cpu_set_t cpus;
+  if (pthread_getaffinity_np(pthread_self(), sizeof cpus, &cpus)
+      || !CPU_EQUAL(&cpus, &attr->p99_cpus)) return 2;
+#endif
+  return 0;
+}
+
+static
+bool attr_test(void) {
+  p99_thrd_attr attr = P99_THRD_ATTR_INITIALIZER;
+  attr.p99_stacksize = 1u << 20;
+  attr.p99_node = 0;
+#if defined(CPU_SETSIZE)
+  attr.p99_hascpus = true;
+  CPU_ZERO(&attr.p99_cpus);
+  if (pthread_getaffinity_np(pthread_self(), sizeof attr.p99_cpus, &attr.p99_cpus))
+    return false;
+  /* Pin to the first CPU that we may run on. */
+  for (int i = 0; i < CPU_SETSIZE; ++i)
+    if (CPU_ISSET(i, &attr.p99_cpus)) {
+      CPU_ZERO(&attr.p99_cpus);
+      CPU_SET(i, &attr.p99_cpus);
+      break;
+    }
+#endif
+  thrd_t id;
+  int res = -1;
+  if (p99_thrd_create_attr(&id, attr_task, &attr, &attr) != thrd_success
+      || thrd_join(id, &res) != thrd_success) return false;
+  if (p99_thrd_getattr(thrd_current())) return false;
+  printf("attr: thread returned %d\n", res);
+  return !res;
+}
+#else
+/* Thread attributes are an extension of the POSIX emulation. */
+static
+bool attr_test(void) {
+  return true;
+}
+#endif
+
+static _Atomic(unsigned) index_used[P99_THRD_INDEX_MAX];
+
+static
+int index_task(void* arg) {
+  size_t idx = p99_thrd_index();
+  if (idx >= P99_THRD_INDEX_MAX || idx != p99_thrd_index()) abort();
+  /* No two threads that are alive at the same time share an index. */
+  if (atomic_fetch_add(&index_used[idx], 1u)) abort();
+  p99_barrier_wait(arg);
+  atomic_fetch_sub(&index_used[idx], 1u);
+  p99_barrier_wait(arg);
+  return 0;
+}
+
+static
+bool index_test(size_t n) {
+  p99_barrier bar;
+  if (!p99_barrier_init(&bar, n)) return false;
+  for (unsigned round = 0; round < 10; ++round) {
+    thrd_t id[n];
+    for (size_t i = 0; i < n; ++i)
+      if (thrd_create(&id[i], index_task, &bar) != thrd_success) return false;
+    for (size_t i = 0; i < n; ++i)
+      if (thrd_join(id[i], 0) != thrd_success) return false;
+  }
+  p99_barrier_destroy(&bar);
+  /* The indices are reused, so they remain dense. */
+  printf("index: bound is %zu\n", p99_thrd_index_bound());
+  return p99_thrd_index_bound() <= n;
+}
+
+typedef struct { unsigned char c[2*P99_TSS_CHUNK]; } tss_large;
+
+P99_TSS_DECLARE_LOCAL(double, tss_d);
+P99_TSS_DECLARE_LOCAL(unsigned, tss_u);
+P99_TSS_DECLARE_LOCAL(tss_large, tss_l);
+typedef struct { P99_CACHE_ALIGNED(unsigned) x; } tss_aligned;
+P99_TSS_DECLARE_LOCAL(tss_aligned, tss_a);
+
+static
+int tss_task(void* arg) {
+  unsigned const me = (uintptr_t)arg;
+  if (P99_TSS_LOCAL(tss_d) || P99_TSS_LOCAL(tss_u) || P99_TSS_LOCAL(tss_l).c[0]) return 1;
+  P99_TSS_LOCAL(tss_d) = me;
+  P99_TSS_LOCAL(tss_u) = me;
+  P99_TSS_LOCAL(tss_l).c[P99_TSS_CHUNK] = me;
+  /* Small variables share the block of the thread. */
+  ptrdiff_t dist = (unsigned char*)&P99_TSS_LOCAL(tss_u) - (unsigned char*)&P99_TSS_LOCAL(tss_d);
+  if (dist >= (ptrdiff_t)P99_TSS_CHUNK || -dist >= (ptrdiff_t)P99_TSS_CHUNK) return 2;
+  /* Over-aligned variables must be aligned, too. */
+  if ((uintptr_t)&P99_TSS_LOCAL(tss_a) % alignof(tss_aligned)) return 4;
+  if (P99_TSS_LOCAL(tss_a).x) return 1;
+  for (unsigned i = 0; i < 100; ++i) {
+    thrd_yield();
+    if (P99_TSS_LOCAL(tss_d) != me || P99_TSS_LOCAL(tss_u) != me
+        || P99_TSS_LOCAL(tss_l).c[P99_TSS_CHUNK] != (unsigned char)me) return 3;
+  }
+  return 0;
+}
+
+static
+bool tss_test(size_t n) {
+  thrd_t id[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&id[i], tss_task, (void*)(uintptr_t)(i + 1)) != thrd_success) return false;
+  bool ret = true;
+  for (size_t i = 0; i < n; ++i) {
+    int res = -1;
+    if (thrd_join(id[i], &res) != thrd_success || res) ret = false;
+  }
+  printf("tss: %s\n", ret ? "ok" : "failed");
+  return ret;
+}
+
+static unsigned cb_count;
+
+static
+void cb_count_arg(void* arg) {
+  cb_count += (uintptr_t)arg;
+}
+
+static
+void cb_count_one(void) {
+  ++cb_count;
+}
+
+static
+bool callback_test(void) {
+  p99_callback_stack stck = P99_LIFO_INITIALIZER(0);
+  p99_callback_pool pool = P99_CALLBACK_POOL_INITIALIZER;
+  p99_callback_el own[3];
+  for (unsigned round = 0; round < 3; ++round) {
+    cb_count = 0;
+    for (unsigned i = 0; i < 3; ++i)
+      if (!P99_CALLBACK_PUSH_EL(&stck, &own[i], cb_count_arg, (void*)(uintptr_t)100)) return false;
+    for (unsigned i = 0; i < 2*P99_CALLBACK_CHUNK + 1; ++i)
+      if (!P99_CALLBACK_PUSH_POOL(&stck, &pool, cb_count_one)) return false;
+    if (!P99_CALLBACK_PUSH(&stck, cb_count_arg, (void*)(uintptr_t)1000)) return false;
+    p99_callback(&stck);
+    if (cb_count != 1300 + 2*P99_CALLBACK_CHUNK + 1) return false;
+  }
+  /* All elements are back in the pool, so there are only the three
+     chunks of the first round. */
+  unsigned chunks = 0;
+  for (p00_callback_chunk* c = P99_LIFO_TOP(&pool.p00_chunks); c; c = c->p99_lifo) ++chunks;
+  p99_callback_pool_destroy(&pool);
+  printf("callback: %u chunks\n", chunks);
+  return chunks == 3;
+}
+
+P99_DECLARE_STRUCT(dnode);
+
+struct dnode {
+  _Atomic(size_t) p99_cnt;
+  thrd_t owner;
+};
+
+static _Atomic(unsigned) dnode_dead;
+static _Atomic(unsigned) dnode_foreign;
+
+static
+void dnode_destroy(dnode* n) {
+  if (!thrd_equal(n->owner, thrd_current())) atomic_fetch_add(&dnode_foreign, 1u);
+  atomic_fetch_add(&dnode_dead, 1u);
+}
+
+P99_DECLARE_DELETE(dnode);
+P99_DEFINE_DELETE(dnode);
+P99_DECLARE_DEFER_DELETE(dnode);
+P99_DEFINE_DEFER_DELETE(dnode);
+P99_TP_REF_DECLARE(dnode);
+P99_TP_REF_FUNCTIONS(dnode, dnode_defer_delete);
+P99_TP_REF_DEFINE(dnode);
+
+enum { dnodes = 1000, };
+
+static
+int defer_task(void* arg) {
+  (void)arg;
+  for (unsigned i = 0; i < dnodes; ++i) {
+    dnode* n = P99_MALLOC(dnode);
+    if (!n) return 1;
+    n->owner = thrd_current();
+    atomic_init(&n->p99_cnt, 0u);
+    dnode_ref ref;
+    dnode_ref_init(&ref, n);
+    /* Releasing the last reference only queues the node. */
+    dnode_ref_destroy(&ref);
+  }
+  return 0;
+}
+
+static
+bool defer_test(size_t n) {
+  if (p99_defer_start() != thrd_success) return false;
+  thrd_t id[n];
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_create(&id[i], defer_task, 0) != thrd_success) return false;
+  for (size_t i = 0; i < n; ++i)
+    if (thrd_join(id[i], 0) != thrd_success) return false;
+  p99_defer_stop();
+  unsigned const total = n*dnodes;
+  /* Without reclaimer, the main thread drains at a quiescent point. */
+  if (defer_task(0)) return false;
+  p99_defer_drain();
+  printf("defer: %u of %u destroyed, %u by another thread\n",
+         atomic_load(&dnode_dead), total + dnodes, atomic_load(&dnode_foreign));
+  return atomic_load(&dnode_dead) == total + dnodes && atomic_load(&dnode_foreign) >= total;
+}
+
+enum { mblocks = 1000, };
+static unsigned char** mtab;
+
+/* Allocate the blocks of row id and check and free those of the
+   row of another thread. */
+static
+int malloc_task(void* arg) {
+  size_t const id = *(size_t*)arg;
+  unsigned char** row = &mtab[id*mblocks];
+  if (!row[0]) {
+    for (size_t j = 0; j < mblocks; ++j) {
+      size_t const len = 1 + (j*j*7 + id) % 5000;
+      row[j] = p99_malloc(len);
+      if (!row[j] || (uintptr_t)row[j] % alignof(max_align_t)) return 1;
+      memset(row[j], (unsigned char)j, len);
+    }
+  } else {
+    for (size_t j = 0; j < mblocks; ++j) {
+      size_t const len = 1 + (j*j*7 + id) % 5000;
+      if (row[j][0] != (unsigned char)j || row[j][len-1] != (unsigned char)j) return 1;
+      p99_free(row[j]);
+      row[j] = 0;
+    }
+  }
+  return 0;
+}
+
+static
+bool malloc_run(size_t n, size_t off) {
+  thrd_t id[n];
+  size_t rows[n];
+  for (size_t i = 0; i < n; ++i) {
+    rows[i] = (i + off) % n;
+    if (thrd_create(&id[i], malloc_task, &rows[i]) != thrd_success) return false;
+  }
+  bool ret = true;
+  for (size_t i = 0; i < n; ++i) {
+    int res = 1;
+    if (thrd_join(id[i], &res) != thrd_success || res) ret = false;
+  }
+  return ret;
+}
+
+static
+bool malloc_test(size_t n) {
+  mtab = calloc(n*mblocks, sizeof *mtab);
+  /* blocks are freed by other threads than those that allocated them */
+  bool ret = mtab && malloc_run(n, 0) && malloc_run(n, 1) && malloc_run(n, 0) && malloc_run(n, 1);
+  free(mtab);
+  if (!ret) return false;
+  unsigned char* p = p99_calloc(10, 10);
+  if (!p) return false;
+  for (size_t i = 0; i < 100; ++i) if (p[i]) return false;
+  memset(p, 7, 100);
+  /* same size class, no move */
+  if (p99_realloc(p, 110) != p) return false;
+  p = p99_realloc(p, 100000);
+  if (!p || p[99] != 7) return false;
+  p = p99_realloc(p, 50);
+  if (!p || p[49] != 7) return false;
+  p99_free(p);
+  size_t volatile huge = SIZE_MAX/2;
+  if (p99_calloc(huge, 4)) return false;
+  p99_malloc_flush();
+  printf("malloc: %zu blocks freed by other threads\n", 2*n*mblocks);
+  return true;
+}
+
+static
+void arena_fill(size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    double* d = P99_ARENA_CALLOC(double, 100);
+    if (!d || d[99] || (uintptr_t)d % alignof(double)) P99_THROW(ENOMEM);
+    d[99] = 1;
+  }
+  P99_THROW(EINVAL);
+}
+
+static
+size_t arena_chunks(p99_arena const* arena) {
+  size_t ret = 0;
+  for (p00_arena_chunk* c = arena->p00_first; c; c = c->p00_next) ++ret;
+  return ret;
+}
+
+/* Leave the scope by P99_UNWIND_RETURN. */
+static
+size_t arena_return(p99_arena* arena) {
+  P99_ARENA_SCOPE(arena) {
+    int (*a)[100] = P99_ARENA_MALLOC(int[100]);
+    if (!a) { P99_UNWIND_RETURN 0; }
+    (*a)[99] = 1;
+    size_t volatile ret = (*a)[99] + !!arena->p00_cur;
+    P99_UNWIND_RETURN ret;
+  }
+  return 0;
+}
+
+static
+bool arena_test(void) {
+  static p99_arena arena = P99_ARENA_INITIALIZER;
+  unsigned char* volatile first = 0;
+  unsigned char* volatile again = 0;
+  P99_ARENA_SCOPE(&arena) {
+    first = P99_ARENA_MALLOC(unsigned char);
+    P99_ARENA_SCOPE(&arena) {
+      if (p99_arena_current() != &arena) first = 0;
+      /* one chunk is not enough for these */
+      for (size_t i = 0; i < 1000; ++i) (void)P99_ARENA_CALLOC(double, 100);
+    }
+    again = P99_ARENA_MALLOC(unsigned char);
+  }
+  if (!first || again != first + 1 || p99_arena_current()) return false;
+  size_t volatile chunks = arena_chunks(&arena);
+  int volatile caught = 0;
+  P99_TRY {
+    P99_ARENA_SCOPE(&arena) arena_fill(2000);
+  } P99_CATCH(int err) {
+    caught = err;
+  }
+  size_t volatile chunks2 = arena_chunks(&arena);
+  if (caught != EINVAL || p99_arena_current() || arena.p00_cur) return false;
+  if (arena_return(&arena) != 2 || p99_arena_current() || arena.p00_cur) return false;
+  /* Only the scope itself is unwound. */
+  bool volatile skipped = true;
+  P99_UNWIND_PROTECT {
+    P99_ARENA_SCOPE(&arena) {
+      if (P99_ARENA_MALLOC(int[100])) P99_UNWIND(1);
+    }
+    skipped = false;
+  }
+  if (skipped || p99_arena_current() || arena.p00_cur) return false;
+  P99_ARENA_SCOPE(&arena) again = P99_ARENA_MALLOC(unsigned char);
+  p99_arena_destroy(&arena);
+  printf("arena: %zu chunks, %zu after exception\n", chunks, chunks2);
+  return again == first && chunks > 1 && chunks2 > chunks;
+}
+
+static
+bool large_test(void) {
+  size_t const n = 1000, m = 17000;
+  double (*grid)[n][m] = p99_large_alloc(sizeof(double[n][m]));
+  double (*next)[n][m] = P99_AALLOC_LARGE(double, grid, 2);
+  unsigned char* small = p99_large_alloc(100, 0);
+  bool ret = grid && next && small
+    && !((uintptr_t)grid % P99_LARGE_ALIGN) && !((uintptr_t)next % P99_LARGE_ALIGN)
+    && !((uintptr_t)small % P99_LARGE_ALIGN);
+  if (ret) {
+    for (size_t i = 0; i < n; i += 97)
+      for (size_t j = 0; j < m; j += 89)
+        if ((*grid)[i][j] || (*next)[i][j]) ret = false;
+    (*grid)[n-1][m-1] = 1;
+    (*next)[n-1][m-1] = 1;
+    small[99] = 1;
+  }
+  p99_large_free(small);
+  p99_large_free(next);
+  p99_large_free(grid);
+  printf("large: %zu MiB\n", sizeof(double[n][m])>>20);
+  return ret;
+}
+
+struct topology_pad {
+  P99_CACHE_ALIGNED(unsigned) a;
+  P99_CACHE_ALIGNED(unsigned) b;
+};
+
+static
+bool topology_test(void) {
+  if (sizeof(struct topology_pad) != 2*P99_CACHE_LINE
+      || offsetof(struct topology_pad, b) != P99_CACHE_LINE) return false;
+  p99_topology const* t = p99_topology_get();
+  if (t != p99_topology_get()) return false;
+  printf("topology: line %zu, L1 %zu, L2 %zu, LLC %zu/%u, %u cpus, %u sockets, %u cores, %u smt, %u llcs, %u nodes\n",
+         t->p99_line, t->p99_l1.p99_size, t->p99_l2.p99_size, t->p99_llc.p99_size, t->p99_llc.p99_shared,
+         t->p99_cpus, t->p99_sockets, t->p99_cores, t->p99_smt, t->p99_llcs, t->p99_nodes);
+  if (!p99_cache_line() || !t->p99_cpus || !t->p99_nodes) return false;
+  if (t->p99_sockets * t->p99_cores * t->p99_smt < t->p99_cpus) return false;
+  if (p99_topology_llc(0) != 0 || p99_topology_distance(0, 0) != 10) return false;
+  return p99_topology_node(0) < t->p99_nodes && !p99_topology_distance(t->p99_nodes, 0);
+}
+
+int main(int argc, char *argv[]) {
+  nthreads = argc < 2 ? 13 : strtoul(argv[1], 0, 0);
+  if (!p99_barrier_init(&flat, nthreads)
+      || !p99_barrier_init(&tree, nthreads, 3)) {
+    fputs("barrier initialization failed\n", stderr);
+    return EXIT_FAILURE;
+  }
+  sums[0] = calloc(nthreads, sizeof(unsigned));
+  sums[1] = calloc(nthreads, sizeof(unsigned));
+  thrd_t id[nthreads];
+  barrier_arg args[nthreads];
+  for (size_t i = 0; i < nthreads; ++i) {
+    args[i] = (barrier_arg) { .id = i, };
+    if (thrd_create(&id[i], barrier_task, &args[i]) != thrd_success) {
+      fputs("thread creation failed\n", stderr);
+      return EXIT_FAILURE;
+    }
+  }
+  for (size_t i = 0; i < nthreads; ++i)
+    if (thrd_join(id[i], 0) != thrd_success) return EXIT_FAILURE;
+  printf("barrier: %u serial threads for %u phases\n", atomic_load(&serial), (unsigned)phases);
+  p99_barrier_destroy(&flat);
+  p99_barrier_destroy(&tree);
+  free(sums[0]);
+  free(sums[1]);
+  if (atomic_load(&serial) != phases) return EXIT_FAILURE;
+  return (sem_test(nthreads) && event_test(nthreads) && pi_test(nthreads) && mtx_test(nthreads) && short_test(nthreads) && attr_test() && index_test(nthreads) && topology_test() && tss_test(nthreads) && callback_test() && defer_test(nthreads) && malloc_test(nthreads) && arena_test() && large_test()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
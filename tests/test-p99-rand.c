@@ -12,6 +12,14 @@
 /*                                                                            */
 #include "p99_rand.h"
 #include "p99_qsort.h"
+#include "p99_qsort_parallel.h"
+#include "p99_radix.h"
+#include "p99_msort.h"
+#include "p99_sortnet.h"
+#include "p99_sort.h"
+#include "p99_isort.h"
+#include "p99_select.h"
+#include "p99_search.h"
 
 inline
 int uComp0(void const*a, void const*b) {
@@ -61,9 +69,480 @@ do {
  } while(false)
 
 
+/* count the comparisons through the context */
+inline
+int cComp(void const*a, void const*b, void*c) {
+  ++*(size_t*)c;
+  return uComp0(a, b);
+}
+
+typedef unsigned char triple[3];
+
+inline
+int tComp(void const*a, void const*b, void*c) {
+  (void)c;
+  return memcmp(a, b, sizeof(triple));
+}
+
+enum { pat_sorted, pat_reversed, pat_equal, pat_few, pat_pipe, pat_saw, pat_random, pat_num, };
+
+static char const*const pat_name[pat_num] = {
+  [pat_sorted] = "sorted",
+  [pat_reversed] = "reversed",
+  [pat_equal] = "equal",
+  [pat_few] = "few values",
+  [pat_pipe] = "organ pipe",
+  [pat_saw] = "saw tooth",
+  [pat_random] = "random",
+};
+
+static
+void pattern(uint64_t* A, size_t n, unsigned pat) {
+  for (size_t i = 0; i < n; ++i)
+    switch (pat) {
+    case pat_sorted: A[i] = i; break;
+    case pat_reversed: A[i] = n - i; break;
+    case pat_equal: A[i] = 42; break;
+    case pat_few: A[i] = p99_rand() % 4; break;
+    case pat_pipe: A[i] = (i < n/2) ? i : n - i; break;
+    case pat_saw: A[i] = i % 1000; break;
+    default: A[i] = p99_rand(); break;
+    }
+}
+
+/* Sort the patterns and check that the result is sorted. The sorted,
+   reversed and equal patterns must only need a linear number of
+   comparisons. */
+static
+bool check_patterns(size_t n) {
+  bool ret = true;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    size_t count = 0;
+    pattern(A, n, pat);
+    qsort_s(A, n, sizeof A[0], cComp, &count);
+    bool const ok = p99_is_sorted(A, n, sizeof A[0], uComp, 0)
+      && (pat > pat_equal || count <= 4*n);
+    fprintf(stderr, "%s, %zu elements: %zu comparisons%s\n", pat_name[pat], n, count, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(A);
+  /* elements of odd size go through the generic implementation */
+  triple* T = P99_MALLOC(triple[n]);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < 3; ++j) T[i][j] = p99_rand() % 8;
+  qsort_s(T, n, sizeof T[0], tComp, 0);
+  if (!p99_is_sorted(T, n, sizeof T[0], tComp, 0)) ret = false;
+  free(T);
+  return ret;
+}
+
+/* Large enough that several threads are used, even on a single CPU. */
+static
+bool check_parallel(size_t n) {
+  bool ret = true;
+  if (n < 8*P99_QSORT_CUTOFF) n = 8*P99_QSORT_CUTOFF;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    pattern(A, n, pat);
+    bool const ok = !P99_QSORT_PARALLEL(A, n, sizeof A[0], uComp, 0, 4)
+      && p99_is_sorted(A, n, sizeof A[0], uComp, 0);
+    fprintf(stderr, "parallel %s, %zu elements%s\n", pat_name[pat], n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(A);
+  triple* T = P99_MALLOC(triple[n]);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < 3; ++j) T[i][j] = p99_rand() % 8;
+  if (p99_qsort_parallel(T, n, sizeof T[0], tComp, 0, 3)
+      || !p99_is_sorted(T, n, sizeof T[0], tComp, 0)) ret = false;
+  free(T);
+  return ret;
+}
+
+/* Radix sort some of the types, once with less elements than the
+   insertion threshold. The payload is the original position, so it
+   shows that the sort is stable. */
+static
+bool check_radix(size_t n) {
+  bool ret = true;
+  for (size_t len = 20; len; len = (len < n) ? n : 0) {
+    uint64_t* A = P99_MALLOC(uint64_t[len]);
+    for (unsigned pat = 0; pat < pat_num; ++pat) {
+      pattern(A, len, pat);
+      bool ok = !p99_radix_sort(A, len);
+      for (size_t i = 1; i < len; ++i) ok = ok && A[i - 1] <= A[i];
+      ret = ret && ok;
+      if (!ok) fprintf(stderr, "radix %s, %zu elements, failed\n", pat_name[pat], len);
+    }
+    free(A);
+    llong* L = P99_MALLOC(llong[len]);
+    size_t* P = P99_MALLOC(size_t[len]);
+    for (size_t i = 0; i < len; ++i) {
+      L[i] = (llong)(p99_rand() % 64) - 32;
+      P[i] = i;
+    }
+    llong* L0 = P99_MALLOC(llong[len]);
+    memcpy(L0, L, sizeof(llong[len]));
+    bool ok = !p99_radix_sort_payload(L, len, P);
+    for (size_t i = 0; i < len; ++i) {
+      ok = ok && L[i] == L0[P[i]];
+      if (i) ok = ok && (L[i - 1] < L[i] || (L[i - 1] == L[i] && P[i - 1] < P[i]));
+    }
+    free(L0);
+    free(P);
+    free(L);
+    double* D = P99_MALLOC(double[len]);
+    for (size_t i = 0; i < len; ++i) D[i] = (i % 7 ? p99_drand() - 0.5 : -0.0)*1E10;
+    ok = ok && !P99_RADIX_SORT(D, len);
+    for (size_t i = 1; i < len; ++i) ok = ok && D[i - 1] <= D[i];
+    free(D);
+    short* S = P99_MALLOC(short[len]);
+    for (size_t i = 0; i < len; ++i) S[i] = p99_rand();
+    ok = ok && !p99_radix_sort(S, len);
+    for (size_t i = 1; i < len; ++i) ok = ok && S[i - 1] <= S[i];
+    free(S);
+    ldouble* X = P99_MALLOC(ldouble[len]);
+    for (size_t i = 0; i < len; ++i) X[i] = (p99_drand() - 0.5L)*(i % 3 ? 1E-300L : 1E300L);
+    ok = ok && !p99_radix_sort(X, len);
+    for (size_t i = 1; i < len; ++i) ok = ok && X[i - 1] <= X[i];
+    free(X);
+    fprintf(stderr, "radix, %zu elements%s\n", len, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  return ret;
+}
+
+typedef struct record record;
+struct record {
+  unsigned key[2];
+  size_t pos;
+};
+
+inline
+int rComp(void const*a, void const*b, void*c) {
+  unsigned const*const k = c;
+  record const*const A = a;
+  record const*const B = b;
+  return (A->key[*k] > B->key[*k]) - (A->key[*k] < B->key[*k]);
+}
+
+/* The merge sort must be stable, so sorting by the secondary and then
+   by the primary key sorts lexicographically. Nearly sorted data must
+   only need a linear number of comparisons. */
+static
+bool check_msort(size_t n) {
+  bool ret = true;
+  record* R = P99_MALLOC(record[n]);
+  record* W = P99_MALLOC(record[n/2]);
+  for (size_t i = 0; i < n; ++i)
+    R[i] = (record){ .key = { p99_rand() % 16, p99_rand() % 256, }, };
+  unsigned k1 = 1;
+  unsigned k0 = 0;
+  bool ok = !p99_msort_s(R, n, sizeof R[0], rComp, &k1)
+    && !p99_msort_s(R, n, sizeof R[0], rComp, &k0, W);
+  for (size_t i = 1; i < n; ++i)
+    ok = ok && (R[i - 1].key[0] < R[i].key[0]
+                || (R[i - 1].key[0] == R[i].key[0] && R[i - 1].key[1] <= R[i].key[1]));
+  fprintf(stderr, "msort records, %zu elements%s\n", n, ok ? "" : ", failed");
+  ret = ret && ok;
+  free(W);
+  free(R);
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  for (unsigned pat = 0; pat <= pat_num; ++pat) {
+    size_t count = 0;
+    if (pat < pat_num) pattern(A, n, pat);
+    else {
+      /* sorted with some perturbations, as for log data */
+      pattern(A, n, pat_sorted);
+      for (size_t i = 0; i < n; i += 1000) A[i] = p99_rand() % n;
+    }
+    bool const ok = !p99_msort_s(A, n, sizeof A[0], cComp, &count)
+      && p99_is_sorted(A, n, sizeof A[0], uComp, 0)
+      && (pat > pat_equal || count < n)
+      && (pat != pat_num || count <= 4*n);
+    fprintf(stderr, "msort %s, %zu elements: %zu comparisons%s\n", pat < pat_num ? pat_name[pat] : "perturbed", n, count, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(A);
+  triple* T = P99_MALLOC(triple[n]);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < 3; ++j) T[i][j] = p99_rand() % 8;
+  if (p99_msort_s(T, n, sizeof T[0], tComp, 0)
+      || !p99_is_sorted(T, n, sizeof T[0], tComp, 0)) ret = false;
+  free(T);
+  return ret;
+}
+
+/* Sorting networks for some fixed sizes, with duplicates and
+   negative values. */
+static
+bool check_sortnet(void) {
+  bool ret = true;
+  for (size_t r = 0; r < 10000; ++r) {
+    double D[13];
+    short S[7];
+    unsigned U[32];
+    /* too large for a network */
+    long L[50];
+    for (size_t i = 0; i < P99_ALEN(D); ++i) D[i] = p99_drand() - 0.5;
+    for (size_t i = 0; i < P99_ALEN(S); ++i) S[i] = p99_rand() % 5 - 2;
+    for (size_t i = 0; i < P99_ALEN(U); ++i) U[i] = p99_rand();
+    for (size_t i = 0; i < P99_ALEN(L); ++i) L[i] = p99_rand() % 100 - 50;
+    P99_SORTNET(D);
+    P99_SORTNET(S);
+    P99_SORTNET(U);
+    P99_SORTNET_N(L, P99_ALEN(L));
+    for (size_t i = 1; i < P99_ALEN(D); ++i) ret = ret && D[i - 1] <= D[i];
+    for (size_t i = 1; i < P99_ALEN(S); ++i) ret = ret && S[i - 1] <= S[i];
+    for (size_t i = 1; i < P99_ALEN(U); ++i) ret = ret && U[i - 1] <= U[i];
+    for (size_t i = 1; i < P99_ALEN(L); ++i) ret = ret && L[i - 1] <= L[i];
+  }
+  fprintf(stderr, "sorting networks%s\n", ret ? "" : ", failed");
+  return ret;
+}
+
+#define UCMP(A, B) ((*(A) > *(B)) - (*(A) < *(B)))
+
+P99_SORT_DEFINE(uint64_t, UCMP);
+P99_SELECT_DEFINE(uint64_t, UCMP);
+P99_BSEARCH_DEFINE(uint64_t, UCMP);
+
+/* The specialized functions must agree with qsort_s. */
+static
+bool check_define(size_t n) {
+  bool ret = true;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  uint64_t* B = P99_MALLOC(uint64_t[n]);
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    pattern(A, n, pat);
+    memcpy(B, A, sizeof(uint64_t[n]));
+    qsort_s(A, n, sizeof A[0], uComp, 0);
+    size_t const k = p99_rand() % n;
+    UCMP_select(B, n, k);
+    bool ok = (A[k] == B[k]);
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && (i < k ? B[i] <= B[k] : B[i] >= B[k]);
+    ok = ok && !UCMP_sort(B, n) && !memcmp(A, B, sizeof(uint64_t[n]));
+    for (size_t i = 0; i < 100; ++i) {
+      uint64_t const key = (i % 2) ? A[p99_rand() % n] : p99_rand();
+      uint64_t* p = UCMP_bsearch(&key, A, n);
+      size_t j = 0;
+      while (j < n && A[j] < key) ++j;
+      ok = ok && ((j < n && A[j] == key) ? p == A + j : !p);
+    }
+    fprintf(stderr, "specialized %s, %zu elements%s\n", pat_name[pat], n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(B);
+  free(A);
+  return ret;
+}
+
+typedef struct bigrec bigrec;
+struct bigrec {
+  record r;
+  unsigned char pad[184];
+};
+
+inline
+uint64_t rKey(void const*a, void*c) {
+  unsigned const*const k = c;
+  record const*const A = a;
+  return A->key[*k];
+}
+
+/* The indirect sort must be stable and must move the whole records,
+   with and without key prefixes. */
+static
+bool check_isort(size_t n) {
+  bool ret = true;
+  bigrec* R = P99_MALLOC(bigrec[n]);
+  for (unsigned pre = 0; pre < 2; ++pre) {
+    for (size_t i = 0; i < n; ++i) {
+      R[i] = (bigrec){ .r = { .key = { p99_rand() % 16, p99_rand() % 256, }, .pos = i, }, };
+      memset(R[i].pad, (unsigned char)i, sizeof R[i].pad);
+    }
+    unsigned k1 = 1;
+    unsigned k0 = 0;
+    bool ok = !p99_isort_s(R, n, sizeof R[0], rComp, &k1, pre ? rKey : 0)
+      && !p99_isort_s(R, n, sizeof R[0], rComp, &k0, pre ? rKey : 0);
+    for (size_t i = 1; i < n; ++i)
+      ok = ok && (R[i - 1].r.key[0] < R[i].r.key[0]
+                  || (R[i - 1].r.key[0] == R[i].r.key[0] && R[i - 1].r.key[1] <= R[i].r.key[1]));
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && R[i].pad[0] == (unsigned char)R[i].r.pos
+        && R[i].pad[sizeof R[i].pad - 1] == (unsigned char)R[i].r.pos;
+    fprintf(stderr, "indirect sort%s, %zu elements%s\n", pre ? " with prefixes" : "", n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(R);
+  return ret;
+}
+
+/* McIlroy's adversary for quicksort. All elements start as "gas"
+   with a value larger than all others, and the comparison only fixes
+   ("freezes") the value of an element when it has to. It freezes
+   the one that is likely to be the pivot, to a value smaller than all
+   remaining gas. */
+typedef struct anti anti;
+struct anti {
+  size_t* val;
+  size_t gas;
+  size_t solid;
+  uint64_t cand;
+  size_t count;
+};
+
+inline
+int aComp(void const*a, void const*b, void*c) {
+  anti* X = c;
+  uint64_t const x = *(uint64_t const*)a;
+  uint64_t const y = *(uint64_t const*)b;
+  ++X->count;
+  if (X->val[x] == X->gas && X->val[y] == X->gas)
+    X->val[x == X->cand ? x : y] = X->solid++;
+  if (X->val[x] == X->gas) X->cand = x;
+  else if (X->val[y] == X->gas) X->cand = y;
+  return (X->val[x] > X->val[y]) - (X->val[x] < X->val[y]);
+}
+
+/* Selection must agree with qsort_s, for the typed and for the
+   generic versions. The top-k heap must find the same smallest
+   elements. */
+static
+bool check_select(size_t n) {
+  bool ret = true;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  uint64_t* B = P99_MALLOC(uint64_t[n]);
+  triple* T = P99_MALLOC(triple[n]);
+  size_t const k = n/3;
+  uint64_t top[100];
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    pattern(A, n, pat);
+    memcpy(B, A, sizeof(uint64_t[n]));
+    p99_topk heap;
+    bool ok = !p99_topk_init(&heap, top, P99_ALEN(top), sizeof top[0], uComp, 0);
+    for (size_t i = 0; i < n; ++i) p99_topk_push(&heap, &A[i]);
+    ok = ok && p99_topk_sort(&heap) == P99_ALEN(top);
+    qsort_s(A, n, sizeof A[0], uComp, 0);
+    ok = ok && !memcmp(A, top, sizeof top);
+    ok = ok && !p99_select_s(B, n, sizeof B[0], uComp, 0, k) && A[k] == B[k];
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && (i < k ? B[i] <= B[k] : B[i] >= B[k]);
+    ok = ok && !p99_partial_sort_s(B, n, sizeof B[0], uComp, 0, k)
+      && !memcmp(A, B, sizeof(uint64_t[k]));
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < 3; ++j) T[i][j] = p99_rand() % 8;
+    ok = ok && !p99_select_s(T, n, sizeof T[0], tComp, 0, n/2);
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && (i < n/2 ? tComp(T[i], T[n/2], 0) <= 0 : tComp(T[i], T[n/2], 0) >= 0);
+    fprintf(stderr, "select %s, %zu elements%s\n", pat_name[pat], n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  /* The number of comparisons must be linear, even against an
+     adversary. */
+  for (size_t m = 1024; m <= 64*1024; m *= 4) {
+    size_t* val = P99_MALLOC(size_t[m]);
+    uint64_t* C = P99_MALLOC(uint64_t[m]);
+    anti X = { .val = val, .gas = m, };
+    for (size_t i = 0; i < m; ++i) {
+      val[i] = m;
+      C[i] = i;
+    }
+    bool const ok = !p99_select_s(C, m, sizeof C[0], aComp, &X, m/2)
+      && X.count <= 12*m;
+    fprintf(stderr, "select adversary, %zu elements: %zu comparisons%s\n", m, X.count, ok ? "" : ", failed");
+    ret = ret && ok;
+    free(C);
+    free(val);
+  }
+  free(T);
+  free(B);
+  free(A);
+  return ret;
+}
+
+/* All search layouts must find the same keys as a linear search on
+   the sorted array. */
+static
+bool check_search(size_t n) {
+  bool ret = true;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  uint64_t* E = P99_MALLOC(uint64_t[n]);
+  unsigned* U = P99_MALLOC(unsigned[n]);
+  unsigned* S = P99_MALLOC(unsigned[P99_STREE_LEN(unsigned, n)]);
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    pattern(A, n, pat);
+    /* keep the values small, such that they fit into U */
+    for (size_t i = 0; i < n; ++i) A[i] %= 4*n;
+    qsort_s(A, n, sizeof A[0], uComp, 0);
+    for (size_t i = 0; i < n; ++i) U[i] = A[i];
+    bool ok = !p99_eytzinger_s(E, A, n, sizeof A[0]);
+    p99_stree_build(S, U, n);
+    for (size_t i = 0; i < 1000; ++i) {
+      uint64_t const key = (i % 2) ? A[p99_rand() % n] : p99_rand() % (4*n);
+      size_t j = 0;
+      while (j < n && A[j] < key) ++j;
+      bool const found = (j < n && A[j] == key);
+      uint64_t* p = p99_bsearch_branchless(&key, A, n, sizeof A[0], uComp, 0);
+      ok = ok && (found ? p == A + j : !p);
+      uint64_t* q = p99_eytzinger_search(&key, E, n, sizeof E[0], uComp, 0);
+      ok = ok && (found ? q && *q == key : !q);
+      unsigned const* r = p99_stree_search(S, n, (unsigned)key);
+      ok = ok && (found ? r && *r == key : !r);
+    }
+    fprintf(stderr, "search %s, %zu elements%s\n", pat_name[pat], n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(S);
+  free(U);
+  free(E);
+  free(A);
+  return ret;
+}
+
+/* Sorting with the natural order must give the same result as the
+   general algorithm. */
+static
+bool check_natural(size_t n) {
+  bool ret = true;
+  uint64_t* A = P99_MALLOC(uint64_t[n]);
+  uint64_t* B = P99_MALLOC(uint64_t[n]);
+  double* D = P99_MALLOC(double[n]);
+  short* S = P99_MALLOC(short[n]);
+  for (unsigned pat = 0; pat < pat_num; ++pat) {
+    pattern(A, n, pat);
+    memcpy(B, A, sizeof(uint64_t[n]));
+    for (size_t i = 0; i < n; ++i) {
+      D[i] = (double)A[i] - (double)(UINT64_MAX/2);
+      S[i] = A[i] % 1000 - 500;
+    }
+    bool ok = !qsort_s(A, n, sizeof A[0], uComp, 0)
+      && !qsort_s(B, n, sizeof B[0], P99_NATURAL(B), 0)
+      && !memcmp(A, B, sizeof(uint64_t[n]))
+      && !qsort_s(D, n, sizeof D[0], P99_NATURAL(D), 0)
+      && !qsort_s(S, n, sizeof S[0], P99_NATURAL(S), 0);
+    for (size_t i = 1; i < n; ++i)
+      ok = ok && D[i - 1] <= D[i] && S[i - 1] <= S[i];
+    fprintf(stderr, "natural %s, %zu elements%s\n", pat_name[pat], n, ok ? "" : ", failed");
+    ret = ret && ok;
+  }
+  free(S);
+  free(D);
+  free(B);
+  free(A);
+  return ret;
+}
+
 P99_INSTANTIATE(int, dComp, void const*, void const*, void*);
 P99_INSTANTIATE(int, uComp, void const*, void const*, void*);
 P99_INSTANTIATE(int, uComp0, void const*, void const*);
+P99_INSTANTIATE(int, cComp, void const*, void const*, void*);
+P99_INSTANTIATE(int, tComp, void const*, void const*, void*);
+P99_INSTANTIATE(int, aComp, void const*, void const*, void*);
+P99_INSTANTIATE(int, rComp, void const*, void const*, void*);
+P99_INSTANTIATE(uint64_t, rKey, void const*, void*);
 
 int main(int argc, char * argv[]) {
   size_t n = argc <= 1 ? 20 : strtoul(argv[1], 0, 0);
@@ -94,4 +573,12 @@ int main(int argc, char * argv[]) {
     for (unsigned i = 0; i < n; ++i)
       printf("%.15f\n", dA[i]);
   free(dA);
+  return (check_patterns(n < 1000 ? 1000 : n) && check_parallel(n) && check_radix(n < 1000 ? 1000 : n)
+          && check_msort(n < 1000 ? 1000 : n)
+          && check_sortnet()
+          && check_define(n < 1000 ? 1000 : n)
+          && check_isort(n < 1000 ? 1000 : n)
+          && check_select(n < 1000 ? 1000 : n)
+          && check_search(n < 1000 ? 1000 : n + 3)
+          && check_natural(n < 1000 ? 1000 : n)) ? EXIT_SUCCESS : EXIT_FAILURE;
 }